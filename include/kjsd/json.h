@@ -19,6 +19,7 @@ extern "C"
     
 #include <stdio.h>
 #include <stddef.h>   /* size_t */    
+#include <stdint.h>   /* int64_t */
 
 /** JSON総称型 */
 typedef struct KJSD_JSON_ValueT KJSD_JSON_Value;
@@ -26,6 +27,79 @@ typedef struct KJSD_JSON_ValueT KJSD_JSON_Value;
 typedef struct KJSD_JSON_ObjectT KJSD_JSON_Object;
 /** JSON配列型 */
 typedef struct KJSD_JSON_ArrayT KJSD_JSON_Array;
+/** JSONアリーナ型 */
+typedef struct KJSD_JSON_ArenaT KJSD_JSON_Arena;
+/** JSONインクリメンタルパーサ型 */
+typedef struct KJSD_JSON_ParserT KJSD_JSON_Parser;
+/** JSONコンパイル済みパス型 */
+typedef struct KJSD_JSON_PathT KJSD_JSON_Path;
+
+/**
+ *  @brief  シリアライザ出力関数型
+ *
+ *  @param[in] ctx 出力先コンテキスト
+ *  @param[in] data 出力データ('\0'終端されない)
+ *  @param[in] size 出力データのバイト数
+ *
+ *  @return 出力したバイト数．sizeより小さい場合は出力を打ち切る
+ */
+typedef size_t (*KJSD_JSON_WriteFunc)(void *ctx,
+                                      const char *data, size_t size);
+
+/**
+ *  @brief  パス検索結果の通知関数型
+ *
+ *  @param[in] ctx KJSD_JSON_pathForEachに渡した任意のデータ
+ *  @param[in] value パスに一致したデータ
+ *
+ *  @return 0以外で検索を継続し，0で中断する
+ */
+typedef int (*KJSD_JSON_PathFunc)(void *ctx, KJSD_JSON_Value *value);
+
+/**
+ *  @brief  NDJSONのレコード通知関数型
+ *
+ *  @param[in] ctx 任意のデータ
+ *  @param[in] index レコードの通し番号(空行は数えない)
+ *  @param[in] value レコード(不正なレコードの場合はNULL)
+ *
+ *  @return 0以外で読み込みを継続し，0で中断する
+ *
+ *  @attention valueは関数から戻った後は参照できない
+ */
+typedef int (*KJSD_JSON_RecordFunc)(void *ctx, size_t index,
+                                    KJSD_JSON_Value *value);
+
+/**
+ *  @brief  メモリアロケータ
+ *
+ *  @note 各関数には第1引数としてctxを渡す
+ *  @note 複数スレッドでパースする場合はスレッドセーフであること
+ */
+typedef struct
+{
+    /** 領域確保(失敗時はNULLを返す) */
+    void* (*alloc)(void *ctx, size_t size);
+    /** 領域の再確保(ptrはNULLのことがある．失敗時はNULLを返し元の領域を残す) */
+    void* (*resize)(void *ctx, void *ptr, size_t size);
+    /** 領域解放(ptrはNULLのことがある) */
+    void (*release)(void *ctx, void *ptr);
+    /** 各関数に渡す任意のデータ */
+    void *ctx;
+} KJSD_JSON_Allocator;
+
+/**
+ *  @brief  シリアライザの出力形式
+ *
+ *  @note 全メンバが0のときは通常のシリアライザと同じ出力になる
+ */
+typedef struct
+{
+    /** 字下げの空白数(0以下のときは改行・字下げしない) */
+    int indent;
+    /** 0以外でオブジェクトのメンバを名称のバイト順に出力する */
+    int sort_keys;
+} KJSD_JSON_Format;
 
 /** JSONデータ型種別定義 */
 typedef enum
@@ -46,6 +120,92 @@ typedef enum
     KJSD_JSON_BOOL
 } KJSD_JSON_Type;
 
+/**
+ *  @brief  JSONイベントハンドラ
+ *
+ *  @note 各コールバックは0以外を返すとパースを継続し，0を返すと中断する
+ *  @note NULLのコールバックは呼び出さない
+ *  @attention 文字列は'\0'終端されない．コールバック終了後は参照できない
+ */
+typedef struct
+{
+    /** null */
+    int (*null_value)(void *ctx);
+    /** 真偽値 */
+    int (*bool_value)(void *ctx, int value);
+    /** 数値 */
+    int (*number_value)(void *ctx, double value);
+    /** 文字列 */
+    int (*string_value)(void *ctx, const char *value, size_t length);
+    /** オブジェクト開始 */
+    int (*start_object)(void *ctx);
+    /** オブジェクトのメンバ名称 */
+    int (*object_key)(void *ctx, const char *name, size_t length);
+    /** オブジェクト終了 */
+    int (*end_object)(void *ctx);
+    /** 配列開始 */
+    int (*start_array)(void *ctx);
+    /** 配列終了 */
+    int (*end_array)(void *ctx);
+    /** 整数(NULLの場合はnumber_valueで通知する) */
+    int (*integer_value)(void *ctx, int64_t value);
+} KJSD_JSON_Handler;
+
+/** 構造体メンバの型 */
+typedef enum
+{
+    /** 真偽値(0/1を格納する符号付き整数またはbool) */
+    KJSD_JSON_FIELD_BOOL = 0,
+    /** 整数(8/16/32/64ビットの符号付き整数) */
+    KJSD_JSON_FIELD_INTEGER,
+    /** 数値(floatまたはdouble) */
+    KJSD_JSON_FIELD_NUMBER,
+    /** 文字列('\0'終端するcharの配列) */
+    KJSD_JSON_FIELD_STRING,
+    /** オブジェクト(fieldsで記述した構造体) */
+    KJSD_JSON_FIELD_OBJECT
+} KJSD_JSON_FieldType;
+
+/**
+ *  @brief  構造体メンバの記述子
+ *
+ *  @note 記述子の配列はnameがNULLの要素(KJSD_JSON_FIELD_END)で終端する
+ */
+typedef struct KJSD_JSON_FieldT
+{
+    /** JSONオブジェクトのメンバ名称 */
+    const char *name;
+    /** 型 */
+    KJSD_JSON_FieldType type;
+    /** 構造体の先頭からのオフセット */
+    size_t offset;
+    /** 構造体メンバのバイト数 */
+    size_t size;
+    /** KJSD_JSON_FIELD_OBJECTの構造体の記述子(それ以外はNULL) */
+    const struct KJSD_JSON_FieldT *fields;
+} KJSD_JSON_Field;
+
+/** 構造体sのメンバmを同名のJSONメンバに対応付ける記述子 */
+#define KJSD_JSON_FIELD(s, m, type)                                     \
+    { #m, (type), offsetof(s, m), sizeof(((s*)0)->m), NULL }
+/** 構造体sの構造体メンバmを記述子fieldsで対応付ける記述子 */
+#define KJSD_JSON_FIELD_OBJECT_OF(s, m, fields)                         \
+    { #m, KJSD_JSON_FIELD_OBJECT, offsetof(s, m),                       \
+      sizeof(((s*)0)->m), (fields) }
+/** 記述子の終端 */
+#define KJSD_JSON_FIELD_END { NULL, KJSD_JSON_FIELD_BOOL, 0, 0, NULL }
+
+/** JSONインクリメンタルパーサの状態 */
+typedef enum
+{
+    /** パース失敗 */
+    KJSD_JSON_PARSE_ERROR = 0,
+    /** 続きのデータ待ち */
+    KJSD_JSON_PARSE_CONTINUE,
+    /** ドキュメント完了 */
+    KJSD_JSON_PARSE_DONE
+} KJSD_JSON_ParseStatus;
+
 /**
  *  @brief  JSONファイルパーサ
  *
@@ -55,10 +215,67 @@ typedef enum
  *  @retval NULL パース失敗
  *
  *  @note inのopen/closeはしない
+ *  @note シーク可能なストリームは先頭から読み込む．
+ *        パイプなどは現在位置から読み込む
  *  @note 使用後はKJSD_JSON_freeで解放する
  */
 KJSD_JSON_Value* KJSD_JSON_deserialize(FILE* in);
 
+/**
+ *  @brief  JSONファイルパーサ(パス指定)
+ *
+ *  ファイルをメモリマップし，コピーせずに直接パースする
+ *
+ *  @param[in] path パース元ファイルのパス
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ *
+ *  @note 使用後はKJSD_JSON_freeで解放する
+ *  @note メモリマップが使えない環境ではファイルストリームから読み込む
+ */
+KJSD_JSON_Value* KJSD_JSON_deserializeFile(const char *path);
+
+/**
+ *  @brief  NDJSON(改行区切りJSON)パーサ
+ *
+ *  1行を1レコードとして，複数のワーカスレッドでパースする
+ *
+ *  @param[in] data NDJSONデータ('\0'終端不要)
+ *  @param[in] size dataのバイト数
+ *  @param[in] threads ワーカスレッド数(0の場合はCPU数)
+ *  @param[in] func レコードごとに呼び出す関数
+ *  @param[in] ctx funcに渡す任意のデータ
+ *
+ *  @retval 1 成功
+ *  @retval 0 メモリ不足またはfuncによる中断
+ *
+ *  @note funcは呼び出し元のスレッドからレコードの順に呼び出す
+ *  @note レコードはオブジェクトまたは配列とし，空行は読み飛ばす
+ *  @note 不正なレコードはvalueをNULLとしてfuncに通知し，読み込みを続ける
+ *  @note スレッドが使えない環境では呼び出し元のスレッドでパースする
+ */
+int KJSD_JSON_deserializeLines(const char *data, size_t size,
+                               size_t threads,
+                               KJSD_JSON_RecordFunc func, void *ctx);
+
+/**
+ *  @brief  NDJSON(改行区切りJSON)ファイルパーサ
+ *
+ *  @param[in] path パース元ファイルのパス
+ *  @param[in] threads ワーカスレッド数(0の場合はCPU数)
+ *  @param[in] func レコードごとに呼び出す関数
+ *  @param[in] ctx funcに渡す任意のデータ
+ *
+ *  @retval 1 成功
+ *  @retval 0 ファイルが読めない，メモリ不足またはfuncによる中断
+ *
+ *  @note ファイルをメモリマップし，KJSD_JSON_deserializeLinesと同様に
+ *        パースする
+ */
+int KJSD_JSON_deserializeLinesFile(const char *path, size_t threads,
+                                   KJSD_JSON_RecordFunc func, void *ctx);
+
 /**
  *  @brief  JSON文字列パーサ
  *
@@ -71,6 +288,214 @@ KJSD_JSON_Value* KJSD_JSON_deserialize(FILE* in);
  */
 KJSD_JSON_Value* KJSD_JSON_deserializeS(const char *in);
 
+/**
+ *  @brief  JSON文字列パーサ(並列)
+ *
+ *  ルートが配列の場合，要素を複数の区間に分けてワーカスレッドで
+ *  パースする
+ *
+ *  @param  [in] in JSON文字列
+ *  @param  [in] threads ワーカスレッド数(0の場合はCPU数)
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ *
+ *  @note 結果はKJSD_JSON_deserializeSと同じになる
+ *  @note ルートがオブジェクトの場合，小さいドキュメントの場合と
+ *        スレッドが使えない環境では呼び出し元のスレッドでパースする
+ *  @note 使用後はKJSD_JSON_freeで解放する
+ */
+KJSD_JSON_Value* KJSD_JSON_deserializeSParallel(const char *in,
+                                                size_t threads);
+
+/**
+ *  @brief  JSONバイナリデシリアライザ
+ *
+ *  KJSD_JSON_serializeBinaryの出力を読み戻す
+ *
+ *  @param[in] data バイナリデータ
+ *  @param[in] size バイナリデータのバイト数
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL 形式不正または領域確保失敗
+ *
+ *  @note 使用後はKJSD_JSON_freeで解放する
+ */
+KJSD_JSON_Value* KJSD_JSON_deserializeBinary(const void *data, size_t size);
+
+/**
+ *  @brief  JSONファイルイベントパーサ
+ *
+ *  @param[in] in パース元ファイルストリーム
+ *  @param[in] handler イベントハンドラ
+ *  @param[in] ctx ハンドラに渡す任意のデータ
+ *
+ *  @retval 1 成功
+ *  @retval 0 パース失敗またはハンドラによる中断
+ *
+ *  @note inのopen/closeはしない
+ *  @note ツリーを構築せず，読み込んだ順にhandlerを呼び出す
+ *  @note ルートにはオブジェクト，配列以外の値も指定できる
+ */
+int KJSD_JSON_parse(FILE* in, const KJSD_JSON_Handler *handler, void *ctx);
+
+/**
+ *  @brief  JSON文字列イベントパーサ
+ *
+ *  @param[in] in JSON文字列
+ *  @param[in] handler イベントハンドラ
+ *  @param[in] ctx ハンドラに渡す任意のデータ
+ *
+ *  @retval 1 成功
+ *  @retval 0 パース失敗またはハンドラによる中断
+ *
+ *  @note ツリーを構築せず，読み込んだ順にhandlerを呼び出す
+ *  @note ルートにはオブジェクト，配列以外の値も指定できる
+ */
+int KJSD_JSON_parseS(const char *in,
+                     const KJSD_JSON_Handler *handler, void *ctx);
+
+/**
+ *  @brief  JSONファイルの構造体への読み込み
+ *
+ *  @param[in] in パース元ファイルストリーム
+ *  @param[in] fields outの構造体の記述子
+ *  @param[out] out 格納先の構造体
+ *
+ *  @retval 1 成功
+ *  @retval 0 パース失敗または型の不一致
+ *
+ *  @note inのopen/closeはしない
+ *  @note ツリーを構築せず，fieldsに記述されたメンバをoutに直接格納する
+ *  @note 記述子に無いメンバは値を解析せずに読み飛ばす
+ *  @note JSONに無いメンバと値がnullのメンバは変更しない
+ *  @attention 失敗した場合もそれまでに読み込んだメンバは格納されている
+ */
+int KJSD_JSON_bind(FILE* in, const KJSD_JSON_Field *fields, void *out);
+
+/**
+ *  @brief  JSON文字列の構造体への読み込み
+ *
+ *  @param[in] in JSON文字列
+ *  @param[in] fields outの構造体の記述子
+ *  @param[out] out 格納先の構造体
+ *
+ *  @retval 1 成功
+ *  @retval 0 パース失敗または型の不一致
+ *
+ *  @note ツリーを構築せず，fieldsに記述されたメンバをoutに直接格納する
+ *  @note 記述子に無いメンバは値を解析せずに読み飛ばす
+ *  @note JSONに無いメンバと値がnullのメンバは変更しない
+ *  @note 整数の範囲外の値，小数を含む値の整数メンバへの格納と，
+ *        終端を含めてメンバに収まらない文字列は型の不一致とする
+ *  @attention 失敗した場合もそれまでに読み込んだメンバは格納されている
+ */
+int KJSD_JSON_bindS(const char *in, const KJSD_JSON_Field *fields,
+                    void *out);
+
+/**
+ *  @brief  JSONインクリメンタルパーサ作成
+ *
+ *  @param[in] arena 格納先アリーナ(NULLの場合はヒープに格納)
+ *
+ *  @retval NULL以外 パーサ
+ *  @retval NULL エラー
+ *
+ *  @note 分割して届くデータをKJSD_JSON_parserFeedで順に渡す
+ *  @note 使用後はKJSD_JSON_parserDestroyで破棄する
+ */
+KJSD_JSON_Parser* KJSD_JSON_parserCreate(KJSD_JSON_Arena *arena);
+
+/**
+ *  @brief  JSONインクリメンタルイベントパーサ作成
+ *
+ *  @param[in] handler イベントハンドラ
+ *  @param[in] ctx ハンドラに渡す任意のデータ
+ *
+ *  @retval NULL以外 パーサ
+ *  @retval NULL エラー
+ *
+ *  @note ツリーを構築せず，データが届いた順にhandlerを呼び出す
+ *  @note 使用後はKJSD_JSON_parserDestroyで破棄する
+ */
+KJSD_JSON_Parser* KJSD_JSON_parserCreateEvent(
+    const KJSD_JSON_Handler *handler, void *ctx);
+
+/**
+ *  @brief  JSONインクリメンタルパーサへのデータ入力
+ *
+ *  @param[in,out] parser パーサ
+ *  @param[in] data 入力データ('\0'終端不要)
+ *  @param[in] size 入力データのバイト数
+ *  @param[out] consumed 読み込んだバイト数(NULL可)
+ *
+ *  @retval KJSD_JSON_PARSE_CONTINUE 続きのデータ待ち
+ *  @retval KJSD_JSON_PARSE_DONE ドキュメント完了
+ *  @retval KJSD_JSON_PARSE_ERROR パース失敗
+ *
+ *  @note 前回の続きから読み込み，入力済みのデータは再走査しない
+ *  @note ドキュメントが完了した時点で読み込みを止める．
+ *        残りのデータ(consumed以降)は次のドキュメントとして入力できる
+ *  @attention ルートが数値の場合は区切り文字を入力するか
+ *             KJSD_JSON_parserFinishを呼ぶまで完了しない
+ */
+KJSD_JSON_ParseStatus KJSD_JSON_parserFeed(KJSD_JSON_Parser *parser,
+                                           const char *data, size_t size,
+                                           size_t *consumed);
+
+/**
+ *  @brief  JSONインクリメンタルパーサへの入力終了
+ *
+ *  @param[in,out] parser パーサ
+ *
+ *  @retval KJSD_JSON_PARSE_DONE ドキュメント完了
+ *  @retval KJSD_JSON_PARSE_ERROR ドキュメントが不完全
+ */
+KJSD_JSON_ParseStatus KJSD_JSON_parserFinish(KJSD_JSON_Parser *parser);
+
+/**
+ *  @brief  JSONインクリメンタルパーサの状態取得
+ *
+ *  @param[in] parser パーサ
+ *
+ *  @return パーサの状態
+ */
+KJSD_JSON_ParseStatus KJSD_JSON_parserGetStatus(
+    const KJSD_JSON_Parser *parser);
+
+/**
+ *  @brief  JSONインクリメンタルパーサの結果取得
+ *
+ *  @param[in,out] parser パーサ
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL ドキュメント未完了またはイベントパーサ
+ *
+ *  @note 取得後，パーサは次のドキュメントの入力待ちに戻る
+ *  @note 使用後はKJSD_JSON_freeで解放する(アリーナ格納の場合は不要)
+ */
+KJSD_JSON_Value* KJSD_JSON_parserTakeRoot(KJSD_JSON_Parser *parser);
+
+/**
+ *  @brief  JSONインクリメンタルパーサのリセット
+ *
+ *  @param[in,out] parser パーサ
+ *
+ *  @return なし
+ *
+ *  @note 入力途中のドキュメントを破棄し，新しいドキュメントの入力待ちに戻る
+ */
+void KJSD_JSON_parserReset(KJSD_JSON_Parser *parser);
+
+/**
+ *  @brief  JSONインクリメンタルパーサ破棄
+ *
+ *  @param[in] parser パーサ
+ *
+ *  @return なし
+ */
+void KJSD_JSON_parserDestroy(KJSD_JSON_Parser *parser);
+
 /**
  *  @brief  JSONオブジェクトのメンバ取得(総称型)
  *
@@ -132,6 +557,20 @@ const char* KJSD_JSON_objectGetString(
 double KJSD_JSON_objectGetNumber(
     const KJSD_JSON_Object *object, const char *name);
 
+/**
+ *  @brief  JSONオブジェクトのメンバ取得(整数)
+ *
+ *  @param  [in] object JSONオブジェクト
+ *  @param  [in] name 取得する数値データの名称
+ *
+ *  @retval JSON数値データ
+ *
+ *  @note nameが見つからないときはゼロが返る
+ *  @note 小数は0方向に切り捨てる
+ */
+int64_t KJSD_JSON_objectGetInteger(
+    const KJSD_JSON_Object *object, const char *name);
+
 /**
  *  @brief  JSONオブジェクトのメンバ取得(真偽値)
  *
@@ -210,6 +649,21 @@ const char* KJSD_JSON_objectDotGetString(
 double KJSD_JSON_objectDotGetNumber(
     const KJSD_JSON_Object *object, const char *name);
 
+/**
+ *  @brief  JSONオブジェクト以下のメンバ取得(整数)
+ *
+ *  @param  [in] object JSONオブジェクト
+ *  @param  [in] name 取得するデータの名称．階層構造を表すdot(.)が含ま
+ *  れている場合は階層を下って検索される(e.g. ObjectA.ObjectB.Foo)
+ *
+ *  @return JSON数値
+ *
+ *  @note nameが見つからないときはゼロが返る
+ *  @note 小数は0方向に切り捨てる
+ */
+int64_t KJSD_JSON_objectDotGetInteger(
+    const KJSD_JSON_Object *object, const char *name);
+
 /**
  *  @brief  JSONオブジェクト以下のメンバ取得(真偽値)
  *
@@ -240,6 +694,9 @@ size_t KJSD_JSON_objectGetCount(const KJSD_JSON_Object *object);
  *
  *  @retval NULL以外 データ名称
  *  @retval NULL エラー
+ *
+ *  @note パースしたドキュメント内(アリーナではアリーナ内)の同じ名称は
+ *        1つの文字列を共有するため，同じアドレスが返る
  */
 const char* KJSD_JSON_objectGetName(
     const KJSD_JSON_Object *object, size_t index);
@@ -304,6 +761,19 @@ const char* KJSD_JSON_arrayGetString(
 double KJSD_JSON_arrayGetNumber(
     const KJSD_JSON_Array *array, size_t index);
 
+/**
+ *  @brief  JSON配列の要素取得(整数)
+ *
+ *  @param  [in] array JSON配列
+ *  @param  [in] index 取得する配列データのインデックス
+ *
+ *  @return JSON数値データ
+ *  @attention エラー発生時はゼロが返る
+ *  @note 小数は0方向に切り捨てる
+ */
+int64_t KJSD_JSON_arrayGetInteger(
+    const KJSD_JSON_Array *array, size_t index);
+
 /**
  *  @brief  JSON配列の要素取得(真偽値)
  *
@@ -324,6 +794,65 @@ int KJSD_JSON_arrayGetBool(const KJSD_JSON_Array *array, size_t index);
  */
 size_t KJSD_JSON_arrayGetCount(const KJSD_JSON_Array *array);
 
+/**
+ *  @brief  JSONパスのコンパイル
+ *
+ *  @param  [in] path 取得するデータのパス．メンバ名称をdot(.)で区切り，
+ *  配列の要素は[インデックス]で指定する(e.g. records[0].name)．
+ *  メンバ名称の*と[*]は全てのメンバ/要素に一致する(e.g. records[*].tags[*])
+ *
+ *  @retval NULL以外 コンパイル済みパス
+ *  @retval NULL 書式エラー
+ *
+ *  @note ルートが配列の場合は[インデックス]から始める(e.g. [0].id)
+ *  @note 名称にdot(.)と[を含むメンバは指定できない
+ *  @note 使用後はKJSD_JSON_pathDestroyで破棄する
+ */
+KJSD_JSON_Path* KJSD_JSON_pathCompile(const char *path);
+
+/**
+ *  @brief  コンパイル済みパスによるデータ取得(総称型)
+ *
+ *  @param  [in,out] path コンパイル済みパス
+ *  @param  [in] root 検索元データ
+ *
+ *  @retval NULL以外 最初に一致したデータ
+ *  @retval NULL 一致するデータが無い
+ *
+ *  @note 各階層で見つかったメンバの位置をpathに覚えておき，次回は
+ *        同じ位置から照合する．同じ構造のドキュメントに繰り返し使うと
+ *        名称の検索を省ける
+ *  @attention 同じpathを複数のスレッドで同時に使用しない
+ */
+KJSD_JSON_Value* KJSD_JSON_pathGetValue(KJSD_JSON_Path *path,
+                                        const KJSD_JSON_Value *root);
+
+/**
+ *  @brief  コンパイル済みパスに一致する全データの列挙
+ *
+ *  @param  [in,out] path コンパイル済みパス
+ *  @param  [in] root 検索元データ
+ *  @param  [in] func 一致したデータごとに呼び出す関数
+ *  @param  [in] ctx funcに渡す任意のデータ
+ *
+ *  @return funcを呼び出した回数
+ *
+ *  @note ドキュメント順に呼び出す
+ *  @attention 同じpathを複数のスレッドで同時に使用しない
+ */
+size_t KJSD_JSON_pathForEach(KJSD_JSON_Path *path,
+                             const KJSD_JSON_Value *root,
+                             KJSD_JSON_PathFunc func, void *ctx);
+
+/**
+ *  @brief  コンパイル済みパスの破棄
+ *
+ *  @param  [in] path コンパイル済みパス
+ *
+ *  @return なし
+ */
+void KJSD_JSON_pathDestroy(KJSD_JSON_Path *path);
+
 /**
  *  @brief  JSON総称型のデータ型取得
  *
@@ -373,6 +902,31 @@ const char* KJSD_JSON_valueGetString(const KJSD_JSON_Value *value);
  */
 double KJSD_JSON_valueGetNumber(const KJSD_JSON_Value *value);
 
+/**
+ *  @brief  JSON総称型データを整数として取得
+ *
+ *  @param  [in] value JSONデータ
+ *
+ *  @return JSON数値
+ *  @attention エラー発生時はゼロが返る
+ *
+ *  @note 整数として保持している値は誤差なく取得できる
+ *  @note 小数は0方向に切り捨てる．int64_tの範囲外はゼロが返る
+ */
+int64_t KJSD_JSON_valueGetInteger(const KJSD_JSON_Value *value);
+
+/**
+ *  @brief  JSON数値が整数として保持されているか判定
+ *
+ *  @param  [in] value JSONデータ
+ *
+ *  @retval 1 整数
+ *  @retval 0 整数以外
+ *
+ *  @note 小数点，指数を含まずint64_tに収まる数値は整数として保持する
+ */
+int KJSD_JSON_valueIsInteger(const KJSD_JSON_Value *value);
+
 /**
  *  @brief  JSON総称型データを真偽値として取得
  *
@@ -383,6 +937,19 @@ double KJSD_JSON_valueGetNumber(const KJSD_JSON_Value *value);
  */
 int KJSD_JSON_valueGetBool(const KJSD_JSON_Value *value);
 
+/**
+ *  @brief  JSONデータ比較
+ *
+ *  @param  [in] a JSONデータ
+ *  @param  [in] b JSONデータ
+ *
+ *  @retval 1 等しい
+ *  @retval 0 等しくない，またはエラー
+ *
+ *  @note 数値は値で比較し，オブジェクトはメンバの順序を問わない
+ */
+int KJSD_JSON_valueEquals(const KJSD_JSON_Value *a, const KJSD_JSON_Value *b);
+
 /**
  *  @brief  JSONデータ解放
  *
@@ -404,6 +971,20 @@ void KJSD_JSON_free(KJSD_JSON_Value *value);
  */
 KJSD_JSON_Value* KJSD_JSON_createRoot(void);
 
+/**
+ *  @brief  JSONデータ複製
+ *
+ *  valueを深く複製する．コンテナごとにメンバの値を一括で確保する
+ *
+ *  @param[in] value 複製元JSONデータ(アリーナ格納でもよい)
+ *
+ *  @retval NULL以外 複製したJSONデータ
+ *  @retval NULL エラー
+ *
+ *  @note 使用後はKJSD_JSON_freeで解放する
+ */
+KJSD_JSON_Value* KJSD_JSON_clone(const KJSD_JSON_Value *value);
+
 /**
  *  @brief  JSONオブジェクトに新規オブジェクト追加
  *
@@ -455,7 +1036,20 @@ int KJSD_JSON_objectAddNumber(KJSD_JSON_Object* base,
                               double value);
 
 /**
- *  @brief  JSONオブジェクトに新規真偽値追加
+ *  @brief  JSONオブジェクトに新規整数追加
+ *
+ *  @param[in,out] base 追加先オブジェクト
+ *  @param[in] name 追加データの名前
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ */
+int KJSD_JSON_objectAddInteger(KJSD_JSON_Object* base,
+                               const char* name,
+                               int64_t value);
+
+/**
+ *  @brief  JSONオブジェクトに新規真偽値追加
  *
  *  @param[in,out] base 追加先オブジェクト
  *  @param[in] name 追加データの名前
@@ -507,6 +1101,16 @@ int KJSD_JSON_arrayAddString(KJSD_JSON_Array* base, const char* value);
  */
 int KJSD_JSON_arrayAddNumber(KJSD_JSON_Array* base, double value);
 
+/**
+ *  @brief  JSON配列に新規整数追加
+ *
+ *  @param[in,out] base 追加先配列
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ */
+int KJSD_JSON_arrayAddInteger(KJSD_JSON_Array* base, int64_t value);
+
 /**
  *  @brief  JSON配列に新規真偽値追加
  *
@@ -517,6 +1121,378 @@ int KJSD_JSON_arrayAddNumber(KJSD_JSON_Array* base, double value);
  */
 int KJSD_JSON_arrayAddBool(KJSD_JSON_Array* base, int value);
 
+/**
+ *  @brief  JSONオブジェクトのメンバにオブジェクト設定
+ *
+ *  @param[in,out] base 設定先オブジェクト
+ *  @param[in] name 設定するデータの名前
+ *
+ *  @retval NULL以外 設定した空のJSONオブジェクト
+ *  @retval NULL エラー
+ *
+ *  @note nameのメンバがあれば値を置き換え，なければ追加する
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+KJSD_JSON_Object* KJSD_JSON_objectSetObject(
+    KJSD_JSON_Object* base, const char* name);
+
+/**
+ *  @brief  JSONオブジェクトのメンバに配列設定
+ *
+ *  @param[in,out] base 設定先オブジェクト
+ *  @param[in] name 設定するデータの名前
+ *
+ *  @retval NULL以外 設定した空のJSON配列
+ *  @retval NULL エラー
+ *
+ *  @note nameのメンバがあれば値を置き換え，なければ追加する
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+KJSD_JSON_Array* KJSD_JSON_objectSetArray(
+    KJSD_JSON_Object* base, const char* name);
+
+/**
+ *  @brief  JSONオブジェクトのメンバに文字列設定
+ *
+ *  @param[in,out] base 設定先オブジェクト
+ *  @param[in] name 設定するデータの名前
+ *  @param[in] value 設定する文字列
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ *
+ *  @note nameのメンバがあれば値を置き換え，なければ追加する
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_objectSetString(KJSD_JSON_Object* base,
+                              const char* name,
+                              const char* value);
+
+/**
+ *  @brief  JSONオブジェクトのメンバに数値設定
+ *
+ *  @param[in,out] base 設定先オブジェクト
+ *  @param[in] name 設定するデータの名前
+ *  @param[in] value 設定する数値
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ *
+ *  @note nameのメンバがあれば値を置き換え，なければ追加する
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_objectSetNumber(KJSD_JSON_Object* base,
+                              const char* name,
+                              double value);
+
+/**
+ *  @brief  JSONオブジェクトのメンバに整数設定
+ *
+ *  @param[in,out] base 設定先オブジェクト
+ *  @param[in] name 設定するデータの名前
+ *  @param[in] value 設定する整数
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ *
+ *  @note nameのメンバがあれば値を置き換え，なければ追加する
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_objectSetInteger(KJSD_JSON_Object* base,
+                               const char* name,
+                               int64_t value);
+
+/**
+ *  @brief  JSONオブジェクトのメンバに真偽値設定
+ *
+ *  @param[in,out] base 設定先オブジェクト
+ *  @param[in] name 設定するデータの名前
+ *  @param[in] value 設定する真偽値
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ *
+ *  @note nameのメンバがあれば値を置き換え，なければ追加する
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_objectSetBool(KJSD_JSON_Object* base,
+                            const char* name,
+                            int value);
+
+/**
+ *  @brief  JSONオブジェクトのメンバ削除
+ *
+ *  @param[in,out] base 削除元オブジェクト
+ *  @param[in] name 削除するデータの名前
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(nameのメンバがない)
+ *
+ *  @note 後続のメンバは順序を保って詰められる
+ *  @attention 削除した値とその子要素は解放される
+ */
+int KJSD_JSON_objectRemove(KJSD_JSON_Object* base, const char* name);
+
+/**
+ *  @brief  JSON配列の要素にオブジェクト設定
+ *
+ *  @param[in,out] base 設定先配列
+ *  @param[in] index 設定する要素のインデックス
+ *
+ *  @retval NULL以外 設定した空のJSONオブジェクト
+ *  @retval NULL エラー
+ *
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+KJSD_JSON_Object* KJSD_JSON_arraySetObject(KJSD_JSON_Array* base,
+                                           size_t index);
+
+/**
+ *  @brief  JSON配列の要素に配列設定
+ *
+ *  @param[in,out] base 設定先配列
+ *  @param[in] index 設定する要素のインデックス
+ *
+ *  @retval NULL以外 設定した空のJSON配列
+ *  @retval NULL エラー
+ *
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+KJSD_JSON_Array* KJSD_JSON_arraySetArray(KJSD_JSON_Array* base,
+                                         size_t index);
+
+/**
+ *  @brief  JSON配列の要素に文字列設定
+ *
+ *  @param[in,out] base 設定先配列
+ *  @param[in] index 設定する要素のインデックス
+ *  @param[in] value 設定する文字列
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_arraySetString(KJSD_JSON_Array* base, size_t index,
+                             const char* value);
+
+/**
+ *  @brief  JSON配列の要素に数値設定
+ *
+ *  @param[in,out] base 設定先配列
+ *  @param[in] index 設定する要素のインデックス
+ *  @param[in] value 設定する数値
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_arraySetNumber(KJSD_JSON_Array* base, size_t index,
+                             double value);
+
+/**
+ *  @brief  JSON配列の要素に整数設定
+ *
+ *  @param[in,out] base 設定先配列
+ *  @param[in] index 設定する要素のインデックス
+ *  @param[in] value 設定する整数
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_arraySetInteger(KJSD_JSON_Array* base, size_t index,
+                              int64_t value);
+
+/**
+ *  @brief  JSON配列の要素に真偽値設定
+ *
+ *  @param[in,out] base 設定先配列
+ *  @param[in] index 設定する要素のインデックス
+ *  @param[in] value 設定する真偽値
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @attention 置き換えた値とその子要素は解放される
+ */
+int KJSD_JSON_arraySetBool(KJSD_JSON_Array* base, size_t index,
+                           int value);
+
+/**
+ *  @brief  JSON配列の要素にオブジェクト挿入
+ *
+ *  @param[in,out] base 挿入先配列
+ *  @param[in] index 挿入位置(要素数と同じときは末尾に追加)
+ *
+ *  @retval NULL以外 挿入した空のJSONオブジェクト
+ *  @retval NULL エラー
+ *
+ *  @note index以降の要素は1つ後ろにずれる
+ */
+KJSD_JSON_Object* KJSD_JSON_arrayInsertObject(KJSD_JSON_Array* base,
+                                              size_t index);
+
+/**
+ *  @brief  JSON配列の要素に配列挿入
+ *
+ *  @param[in,out] base 挿入先配列
+ *  @param[in] index 挿入位置(要素数と同じときは末尾に追加)
+ *
+ *  @retval NULL以外 挿入した空のJSON配列
+ *  @retval NULL エラー
+ *
+ *  @note index以降の要素は1つ後ろにずれる
+ */
+KJSD_JSON_Array* KJSD_JSON_arrayInsertArray(KJSD_JSON_Array* base,
+                                            size_t index);
+
+/**
+ *  @brief  JSON配列の要素に文字列挿入
+ *
+ *  @param[in,out] base 挿入先配列
+ *  @param[in] index 挿入位置(要素数と同じときは末尾に追加)
+ *  @param[in] value 挿入する文字列
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @note index以降の要素は1つ後ろにずれる
+ */
+int KJSD_JSON_arrayInsertString(KJSD_JSON_Array* base, size_t index,
+                                const char* value);
+
+/**
+ *  @brief  JSON配列の要素に数値挿入
+ *
+ *  @param[in,out] base 挿入先配列
+ *  @param[in] index 挿入位置(要素数と同じときは末尾に追加)
+ *  @param[in] value 挿入する数値
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @note index以降の要素は1つ後ろにずれる
+ */
+int KJSD_JSON_arrayInsertNumber(KJSD_JSON_Array* base, size_t index,
+                                double value);
+
+/**
+ *  @brief  JSON配列の要素に整数挿入
+ *
+ *  @param[in,out] base 挿入先配列
+ *  @param[in] index 挿入位置(要素数と同じときは末尾に追加)
+ *  @param[in] value 挿入する整数
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @note index以降の要素は1つ後ろにずれる
+ */
+int KJSD_JSON_arrayInsertInteger(KJSD_JSON_Array* base, size_t index,
+                                 int64_t value);
+
+/**
+ *  @brief  JSON配列の要素に真偽値挿入
+ *
+ *  @param[in,out] base 挿入先配列
+ *  @param[in] index 挿入位置(要素数と同じときは末尾に追加)
+ *  @param[in] value 挿入する真偽値
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @note index以降の要素は1つ後ろにずれる
+ */
+int KJSD_JSON_arrayInsertBool(KJSD_JSON_Array* base, size_t index,
+                              int value);
+
+/**
+ *  @brief  JSON配列の要素削除
+ *
+ *  @param[in,out] base 削除元配列
+ *  @param[in] index 削除する要素のインデックス
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(indexが範囲外)
+ *
+ *  @note 後続の要素は1つ前にずれる
+ *  @attention 削除した値とその子要素は解放される
+ */
+int KJSD_JSON_arrayRemove(KJSD_JSON_Array* base, size_t index);
+
+/**
+ *  @brief  JSON Patch(RFC 6902)適用
+ *
+ *  patchの操作(add, remove, replace, move, copy, test)を
+ *  順にtargetへ適用する．変更されるのはパスの指す部分木のみ
+ *
+ *  @param[in,out] target 適用先JSONデータ
+ *  @param[in] patch 操作オブジェクトの配列
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(パスが不正，testの不一致など)
+ *
+ *  @note 追加する値は複製され，targetと同じアリーナに格納される．
+ *        moveは値を複製せずに付け替える
+ *  @attention 失敗した場合，それまでの操作は適用されたままになる．
+ *  全体を取り消すにはKJSD_JSON_cloneで複製してから適用する
+ *  @attention ルートがスカラー値のtargetはヒープ格納として扱う
+ */
+int KJSD_JSON_patch(KJSD_JSON_Value *target, const KJSD_JSON_Value *patch);
+
+/**
+ *  @brief  JSON Merge Patch(RFC 7386)適用
+ *
+ *  @param[in,out] target 適用先JSONデータ
+ *  @param[in] patch マージパッチ
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗
+ *
+ *  @note patchのnullのメンバはtargetから削除される
+ *  @attention ルートがスカラー値のtargetはヒープ格納として扱う
+ */
+int KJSD_JSON_mergePatch(KJSD_JSON_Value *target,
+                         const KJSD_JSON_Value *patch);
+
+/**
+ *  @brief  JSON Patch(RFC 6902)生成
+ *
+ *  fromをtoに変える操作の配列を作る．オブジェクトのメンバは
+ *  名前で対応付け，配列は先頭と末尾の共通部分を除いて位置で対応付ける
+ *
+ *  @param[in] from 変更前JSONデータ
+ *  @param[in] to 変更後JSONデータ
+ *
+ *  @retval NULL以外 操作の配列(差分がなければ空配列)
+ *  @retval NULL エラー
+ *
+ *  @note 使用後はKJSD_JSON_freeで解放する
+ *  @note KJSD_JSON_arenaCloneSharedの複製と雛形の間で共有されたままの
+ *        部分木は比較しない
+ */
+KJSD_JSON_Value* KJSD_JSON_diff(const KJSD_JSON_Value *from,
+                                const KJSD_JSON_Value *to);
+
+/**
+ *  @brief  JSON Merge Patch(RFC 7386)生成
+ *
+ *  @param[in] from 変更前JSONデータ
+ *  @param[in] to 変更後JSONデータ
+ *
+ *  @retval NULL以外 マージパッチ
+ *  @retval NULL エラー
+ *
+ *  @note 使用後はKJSD_JSON_freeで解放する
+ *  @attention マージパッチではnullは削除を表すため，
+ *  toでnullに変わったメンバは削除として表される
+ */
+KJSD_JSON_Value* KJSD_JSON_mergeDiff(const KJSD_JSON_Value *from,
+                                     const KJSD_JSON_Value *to);
+
 /**
  *  @brief  JSONシリアライザ(ファイルストリーム出力)
  *
@@ -543,6 +1519,122 @@ size_t KJSD_JSON_serialize(const KJSD_JSON_Value* value, FILE* out);
 size_t KJSD_JSON_serializeS(const KJSD_JSON_Value* value,
                             char* out, size_t size);
 
+/**
+ *  @brief  JSONシリアライザ(領域確保して出力)
+ *
+ *  内部で拡張するバッファに一度だけシリアライズする
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[out] length ダンプした文字数(NULL可)
+ *
+ *  @retval NULL以外 '\0'終端されたシリアライズ結果
+ *  @retval NULL 引数不正または領域確保失敗
+ *
+ *  @attention 戻り値はKJSD_JSON_freeStringで解放すること
+ */
+char* KJSD_JSON_serializeAlloc(const KJSD_JSON_Value* value, size_t *length);
+
+/**
+ *  @brief  JSONバイナリシリアライザ(領域確保して出力)
+ *
+ *  プロセス間でJSONデータを受け渡すための独自バイナリ形式で出力する．
+ *  文字列とコンテナは長さ/要素数を先頭に持ち，数値はdoubleまたは
+ *  64bit整数のまま格納する
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[out] length ダンプしたバイト数(NULL可)
+ *
+ *  @retval NULL以外 バイナリデータ
+ *  @retval NULL 引数不正または領域確保失敗
+ *
+ *  @attention 戻り値はKJSD_JSON_freeStringで解放すること
+ */
+char* KJSD_JSON_serializeBinary(const KJSD_JSON_Value* value,
+                                size_t *length);
+
+/**
+ *  @brief  KJSD_JSON_serializeAlloc/KJSD_JSON_serializeBinaryの結果を解放
+ *
+ *  @param[in] string 解放する文字列(NULL可)
+ *
+ *  @return なし
+ */
+void KJSD_JSON_freeString(char *string);
+
+/**
+ *  @brief  JSONシリアライザ(ファイルディスクリプタ出力)
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[in] fd ダンプ先のファイルディスクリプタ
+ *
+ *  @return ダンプした文字数
+ *
+ *  @note fdのopen/closeはしない
+ */
+size_t KJSD_JSON_serializeFd(const KJSD_JSON_Value* value, int fd);
+
+/**
+ *  @brief  JSONシリアライザ(コールバック出力)
+ *
+ *  シリアライズ結果を内部バッファに溜め，まとまった単位でfuncに渡す
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[in] func 出力関数
+ *  @param[in] ctx funcに渡すコンテキスト
+ *
+ *  @return ダンプした文字数
+ */
+size_t KJSD_JSON_serializeCallback(const KJSD_JSON_Value* value,
+                                   KJSD_JSON_WriteFunc func, void *ctx);
+
+/**
+ *  @brief  書式指定JSONシリアライザ(ファイルストリーム出力)
+ *
+ *  字下げ・メンバ名称順の出力を1回の走査で行う
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[in] format 出力形式(NULLのときは通常の出力)
+ *  @param[out] out ダンプ先のファイルストリーム
+ *
+ *  @return ダンプした文字数
+ *
+ *  @note 字下げするとき，メンバ名称の後の':'に空白を1つ続ける．
+ *        空のオブジェクト/配列は改行しない
+ *  @note 名称順に並べる場合，メンバ数に比例する作業領域を確保することがある
+ */
+size_t KJSD_JSON_serializeFormat(const KJSD_JSON_Value* value,
+                                 const KJSD_JSON_Format *format, FILE* out);
+
+/**
+ *  @brief  書式指定JSONシリアライザ(領域確保して出力)
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[in] format 出力形式(NULLのときは通常の出力)
+ *  @param[out] length ダンプした文字数(NULL可)
+ *
+ *  @retval NULL以外 '\0'終端されたシリアライズ結果
+ *  @retval NULL 引数不正または領域確保失敗
+ *
+ *  @attention 戻り値はKJSD_JSON_freeStringで解放すること
+ */
+char* KJSD_JSON_serializeFormatAlloc(const KJSD_JSON_Value* value,
+                                     const KJSD_JSON_Format *format,
+                                     size_t *length);
+
+/**
+ *  @brief  書式指定JSONシリアライザ(コールバック出力)
+ *
+ *  @param[in] value ダンプするJSONデータ
+ *  @param[in] format 出力形式(NULLのときは通常の出力)
+ *  @param[in] func 出力関数
+ *  @param[in] ctx funcに渡すコンテキスト
+ *
+ *  @return ダンプした文字数
+ */
+size_t KJSD_JSON_serializeFormatCallback(const KJSD_JSON_Value* value,
+                                         const KJSD_JSON_Format *format,
+                                         KJSD_JSON_WriteFunc func, void *ctx);
+
 /**
  *  @brief  JSONシリアライズ後の文字数取得
  *
@@ -552,6 +1644,278 @@ size_t KJSD_JSON_serializeS(const KJSD_JSON_Value* value,
  */
 size_t KJSD_JSON_sizeof(const KJSD_JSON_Value* value);
 
+/**
+ *  @brief  グローバルなメモリアロケータ設定
+ *
+ *  アリーナに格納しないJSONデータ，シリアライズ結果，パーサの作業領域
+ *  およびKJSD_JSON_arenaCreateで作成するアリーナはこのアロケータを使う．
+ *
+ *  @param[in] allocator アロケータ(NULLのときは標準ライブラリに戻す)
+ *
+ *  @retval 1 成功
+ *  @retval 0 失敗(関数が設定されていない)
+ *
+ *  @attention 確保済みの領域が残っている間は変更しないこと．
+ *             スレッドセーフではないため，起動時に設定すること
+ */
+int KJSD_JSON_setAllocator(const KJSD_JSON_Allocator *allocator);
+
+/**
+ *  @brief  JSONアリーナ作成
+ *
+ *  アリーナは大きなチャンク単位で領域を確保し，パースしたJSONデータを
+ *  ノード毎のmalloc/freeなしで格納する．格納したデータは
+ *  KJSD_JSON_arenaReset/KJSD_JSON_arenaDestroyで一括して解放される．
+ *
+ *  @param[in] chunk_size チャンクサイズ(0のときはデフォルト値)
+ *
+ *  @retval NULL以外 JSONアリーナ
+ *  @retval NULL エラー
+ *
+ *  @note 使用後はKJSD_JSON_arenaDestroyで解放する
+ */
+KJSD_JSON_Arena* KJSD_JSON_arenaCreate(size_t chunk_size);
+
+/**
+ *  @brief  JSONアリーナ作成(アロケータ指定)
+ *
+ *  アリーナ本体とチャンクをallocatorから確保する．リクエスト毎の
+ *  プールなどを使い，パース中にグローバルなmallocを呼ばずに済む．
+ *
+ *  @param[in] chunk_size チャンクサイズ(0のときはデフォルト値)
+ *  @param[in] allocator アロケータ(NULLのときはグローバルなアロケータ)
+ *
+ *  @retval NULL以外 JSONアリーナ
+ *  @retval NULL エラー
+ *
+ *  @note allocatorはコピーされる．ctxはアリーナの破棄まで有効であること
+ *  @note パーサの作業領域はグローバルなアロケータから確保する
+ *  @note 使用後はKJSD_JSON_arenaDestroyで解放する
+ */
+KJSD_JSON_Arena* KJSD_JSON_arenaCreateWithAllocator(
+    size_t chunk_size, const KJSD_JSON_Allocator *allocator);
+
+/**
+ *  @brief  JSONアリーナの全データ解放
+ *
+ *  アリーナに格納した全データを解放する．最新のチャンクは解放せず次
+ *  回のパースで再利用する．
+ *
+ *  @param[in,out] arena JSONアリーナ
+ *
+ *  @return なし
+ */
+void KJSD_JSON_arenaReset(KJSD_JSON_Arena *arena);
+
+/**
+ *  @brief  JSONアリーナ破棄
+ *
+ *  @param[in] arena JSONアリーナ
+ *
+ *  @return なし
+ */
+void KJSD_JSON_arenaDestroy(KJSD_JSON_Arena *arena);
+
+/**
+ *  @brief  JSONファイルパーサ(アリーナ格納)
+ *
+ *  @param[in,out] arena 格納先のJSONアリーナ
+ *  @param[in] in パース元ファイルストリーム
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ *
+ *  @note inのopen/closeはしない
+ *  @attention 戻り値はKJSD_JSON_freeで解放しない．arenaの
+ *  リセット/破棄で解放される
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserialize(KJSD_JSON_Arena *arena,
+                                            FILE* in);
+
+/**
+ *  @brief  JSON文字列パーサ(アリーナ格納)
+ *
+ *  @param[in,out] arena 格納先のJSONアリーナ
+ *  @param[in] in JSON文字列
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ *
+ *  @attention 戻り値はKJSD_JSON_freeで解放しない．arenaの
+ *  リセット/破棄で解放される
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeS(KJSD_JSON_Arena *arena,
+                                             const char *in);
+
+/**
+ *  @brief  JSON文字列パーサ(アリーナ格納，入力バッファ直接参照)
+ *
+ *  @param[in] arena 格納先アリーナ
+ *  @param[in,out] in JSON文字列
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ *
+ *  @note エスケープを含まない文字列とメンバ名称はコピーせずinを直接参照する
+ *  @attention inは書き換えられる(文字列の終端に'\0'を書き込む)．
+ *             JSONデータの使用中はinを解放，変更しないこと
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeInSitu(KJSD_JSON_Arena *arena,
+                                                  char *in);
+
+/**
+ *  @brief  JSONバイナリデシリアライザ(アリーナ格納)
+ *
+ *  @param[in] arena 格納先アリーナ
+ *  @param[in] data バイナリデータ
+ *  @param[in] size バイナリデータのバイト数
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL 形式不正または領域確保失敗
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeBinary(KJSD_JSON_Arena *arena,
+                                                  const void *data,
+                                                  size_t size);
+
+/**
+ *  @brief  JSONファイルパーサ(パス指定，アリーナ格納)
+ *
+ *  ファイルを読み取り専用でメモリマップし，コピーせずに直接パースする
+ *
+ *  @param[in] arena 格納先アリーナ
+ *  @param[in] path パース元ファイルのパス
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeFile(KJSD_JSON_Arena *arena,
+                                                const char *path);
+
+/**
+ *  @brief  JSONファイルパーサ(パス指定，アリーナ格納，マップ直接参照)
+ *
+ *  ファイルをプライベートにメモリマップし，エスケープを含まない
+ *  文字列とメンバ名称はマップした領域を直接参照する
+ *
+ *  @param[in] arena 格納先アリーナ
+ *  @param[in] path パース元ファイルのパス
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗
+ *
+ *  @note マップはKJSD_JSON_arenaReset/KJSD_JSON_arenaDestroyで解除する
+ *  @note ファイルは書き換えない
+ *  @attention エスケープを含まない文字列ごとに終端を書き込むため，
+ *             通常のJSONではほぼ全てのページがプロセス固有のコピーとなる．
+ *             ページをプロセス間で共有する場合は
+ *             KJSD_JSON_arenaDeserializeFileを使うこと
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeFileInSitu(
+    KJSD_JSON_Arena *arena, const char *path);
+
+/**
+ *  @brief  JSON文字列パーサ(アリーナ格納，遅延構築)
+ *
+ *  コンテナの範囲だけを記録し，各コンテナのメンバは取得関数が
+ *  初めて参照した時に一階層分だけ構築する
+ *
+ *  @param[in] arena 格納先アリーナ
+ *  @param[in] in JSON文字列
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗(括弧の対応不正)
+ *
+ *  @attention JSONデータの使用中はinを解放，変更しないこと
+ *  @attention 参照していない部分の構文エラーは検出しない．
+ *             構文エラーのあるコンテナは取得関数がNULL/0を返し，
+ *             シリアライザは失敗する
+ *  @attention 取得関数とシリアライザはconstのデータに対しても
+ *             未構築のコンテナをアリーナに構築する．読み取りだけでも
+ *             複数のスレッドから同時に参照しないこと
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeLazy(KJSD_JSON_Arena *arena,
+                                                const char *in);
+
+/**
+ *  @brief  JSONファイルパーサ(パス指定，アリーナ格納，遅延構築)
+ *
+ *  ファイルを読み取り専用でメモリマップし，
+ *  KJSD_JSON_arenaDeserializeLazyと同様に遅延構築する
+ *
+ *  @param[in] arena 格納先アリーナ
+ *  @param[in] path パース元ファイルのパス
+ *
+ *  @retval NULL以外 JSONルートデータ
+ *  @retval NULL パース失敗(括弧の対応不正)
+ *
+ *  @note マップはKJSD_JSON_arenaReset/KJSD_JSON_arenaDestroyで解除する
+ *  @note メモリマップが使えない環境では全体をパースする
+ *  @attention 取得関数とシリアライザはconstのデータに対しても
+ *             未構築のコンテナをアリーナに構築する．読み取りだけでも
+ *             複数のスレッドから同時に参照しないこと
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeFileLazy(
+    KJSD_JSON_Arena *arena, const char *path);
+
+/**
+ *  @brief  JSONルートオブジェクト作成(アリーナ格納)
+ *
+ *  @param[in,out] arena 格納先のJSONアリーナ
+ *
+ *  @retval NULL以外 JSONルートオブジェクト
+ *  @retval NULL エラー
+ *
+ *  @note 追加したメンバも同じアリーナに格納される
+ *  @attention 戻り値はKJSD_JSON_freeで解放しない．arenaの
+ *  リセット/破棄で解放される
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaCreateRoot(KJSD_JSON_Arena *arena);
+
+/**
+ *  @brief  JSONデータ複製(アリーナ格納)
+ *
+ *  valueを深く複製する．事前に必要な大きさを数え，
+ *  メンバ名以外をアリーナから一度に確保する
+ *
+ *  @param[in,out] arena 格納先のJSONアリーナ
+ *  @param[in] value 複製元JSONデータ
+ *
+ *  @retval NULL以外 複製したJSONデータ
+ *  @retval NULL エラー
+ *
+ *  @note メンバ名はアリーナ内の同じ名前と共有する
+ *  @attention 戻り値はKJSD_JSON_freeで解放しない．arenaの
+ *  リセット/破棄で解放される
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaClone(KJSD_JSON_Arena *arena,
+                                      const KJSD_JSON_Value *value);
+
+/**
+ *  @brief  JSONデータ共有複製(アリーナ格納)
+ *
+ *  baseを雛形として共有する複製を作る．各コンテナは最初に
+ *  参照または変更されたときに一階層分だけメンバをコピーし，
+ *  触れていない部分木はbaseを参照したままになる．
+ *  触れていないコンテナのシリアライズはbaseを直接読む
+ *
+ *  @param[in,out] arena 格納先のJSONアリーナ
+ *  @param[in] base 雛形のJSONデータ
+ *
+ *  @retval NULL以外 複製したJSONデータ
+ *  @retval NULL エラー
+ *
+ *  @note 同じbaseから別々のアリーナに作った複製は，
+ *        別スレッドから同時に使用してよい
+ *  @attention 複製の使用中はbaseを解放，変更しないこと．
+ *  メンバ名と文字列はbaseのものを参照する
+ *  @attention baseが遅延構築(KJSD_JSON_arenaDeserializeLazy)の場合，
+ *  未構築部分は最初の参照時に構築されるため，同時に使用しないこと
+ *  @attention 戻り値はKJSD_JSON_freeで解放しない．arenaの
+ *  リセット/破棄で解放される
+ */
+KJSD_JSON_Value* KJSD_JSON_arenaCloneShared(KJSD_JSON_Arena *arena,
+                                            const KJSD_JSON_Value *base);
+
 #ifdef __cplusplus
 }
 #endif
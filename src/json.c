@@ -14,28 +14,145 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <stdint.h>
+#include <locale.h>
+#include <math.h>
+#if defined(_WIN32)
+#include <io.h>
+#define json_fd_write(fd, data, n)  _write((fd), (data), (unsigned int)(n))
+#else
+#include <unistd.h>
+#define json_fd_write(fd, data, n)  write((fd), (data), (n))
+#endif
+/* Files are parsed straight from a memory mapping where available */
+#if defined(__unix__) || defined(__MACH__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define JSON_HAVE_MMAP
+#endif
+
+/* NDJSON records are parsed on worker threads where available.
+   Define KJSD_JSON_NO_THREADS to parse them on the calling thread. */
+#if !defined(KJSD_JSON_NO_THREADS) && (defined(__unix__) || defined(__MACH__))
+#include <pthread.h>
+#define JSON_HAVE_THREADS
+#endif
+
+/* Vectorized scanning is used when the compiler targets SSE2 or AVX2.
+   Define KJSD_JSON_NO_SIMD to force the scalar loops. */
+#if !defined(KJSD_JSON_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) ||                   \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define JSON_SIMD_SSE2
+#endif
+#endif
+#if defined(_MSC_VER) && (defined(JSON_SIMD_AVX2) || defined(JSON_SIMD_SSE2))
+#include <intrin.h>
+#endif
 
 #define ERROR                      0
 #define SUCCESS                    1
 #define STARTING_CAPACITY         15
-#define ARRAY_MAX_CAPACITY    122880 /* 15*(2^13) */
-#define OBJECT_MAX_CAPACITY      960 /* 15*(2^6)  */
+/* Capacities double until GROWTH_DOUBLING_LIMIT and then grow by half,
+   so appends stay amortized O(1) while huge containers do not waste
+   up to half of their memory. Zero for MAX_CAPACITY means unlimited. */
+#ifndef GROWTH_DOUBLING_LIMIT
+#define GROWTH_DOUBLING_LIMIT  65536
+#endif
+#ifndef ARRAY_MAX_CAPACITY
+#define ARRAY_MAX_CAPACITY         0
+#endif
+#ifndef OBJECT_MAX_CAPACITY
+#define OBJECT_MAX_CAPACITY        0
+#endif
 #define MAX_NESTING               19
-#define sizeof_token(a)       (sizeof(a) - 1)
-#define skip_char(str)        ((*str)++)
-#define skip_whitespaces(str) while (isspace(**string)) { skip_char(string); }
+#define NOT_FOUND          ((size_t)-1)
+#define OBJECT_INDEX_THRESHOLD    16
+#define INTERN_MIN_SIZE           64
+#define PARSER_CHUNK_SIZE      65536
+/* Decimal digits kept exactly in a 64-bit mantissa */
+#define NUMBER_MAX_DIGITS         19
+#define NUMBER_MAX_EXPONENT   100000
+/* "-1.2345678901234567e-308" and the terminator */
+#define NUMBER_BUF_SIZE           32
+#define WRITER_BUFFER_SIZE     16384
+/* Names of objects up to this size are sorted without a heap buffer */
+#define FORMAT_SORT_STACK         32
+/* NDJSON input is handed to workers in batches of whole lines */
+#define LINES_BATCH_SIZE      262144
+#define LINES_MAX_THREADS         64
+/* A top-level array is split into slices of at least this size */
+#define ARRAY_SLICE_MIN_SIZE  262144
+/* Binary encoding: magic, version and value tags */
+#define BINARY_MAGIC           "KJB\001"
+#define BINARY_MAGIC_SIZE          4
+#define BINARY_NULL             0x00
+#define BINARY_FALSE            0x01
+#define BINARY_TRUE             0x02
+#define BINARY_NUMBER           0x03
+#define BINARY_INTEGER          0x04
+#define BINARY_STRING           0x05
+#define BINARY_ARRAY            0x06
+#define BINARY_OBJECT           0x07
+#define JSON_POW5_MIN           -342
+#define JSON_POW5_MAX            308
+#define is_space(c)                                             \
+    (((c) == ' ') || ((c) == '\n') || ((c) == '\r') || ((c) == '\t'))
+#define is_digit(c)           (((c) >= '0') && ((c) <= '9'))
+#define json_emit(p, event, args)                               \
+    (((p)->handler->event == NULL) || (p)->handler->event args)
+#define json_write_literal(w, s)  json_write((w), (s), sizeof(s) - 1)
+#define json_object_load(o)                                     \
+    (!(o)->lazy || json_lazy_load_object((KJSD_JSON_Object*)(o)))
+#define json_array_load(a)                                      \
+    (!(a)->lazy || json_lazy_load_array((KJSD_JSON_Array*)(a)))
 #define MAX(a, b)             ((a) > (b) ? (a) : (b))
-
-#define json_malloc(a)     malloc(a)
-#define json_free(a)       free((void*)a)
-#define json_realloc(a, b) realloc(a, b)
+#define ARENA_CHUNK_SIZE       65536
+#define ARENA_ALIGN(a)                                          \
+    (((a) + sizeof(json_align) - 1) & ~(sizeof(json_align) - 1))
+#define arena_chunk_data(c)                                     \
+    ((char*)(c) + ARENA_ALIGN(sizeof(json_arena_chunk)))
+#define json_block_values(b)                                    \
+    ((KJSD_JSON_Value*)((char*)(b) + ARENA_ALIGN(sizeof(json_value_block))))
+
+#define json_malloc(a)                                          \
+    json_allocator.alloc(json_allocator.ctx, (a))
+#define json_free(a)                                            \
+    json_allocator.release(json_allocator.ctx, (void*)(a))
+#define json_realloc(a, b)                                      \
+    json_allocator.resize(json_allocator.ctx, (a), (b))
 
 /* Type definitions */
+/* Lazy DOM: boundaries of a container found by the structural pass.
+   Containers are numbered in document order and next is the number
+   of the first container after this one's subtree. */
+typedef struct
+{
+    const char *begin;
+    const char *end;
+    size_t next;
+} json_lazy_span;
+
+/* A container whose members are not built yet. They are parsed from
+   a span of the source text, or copied from the container of a shared
+   base document when base is set. */
+typedef struct
+{
+    const json_lazy_span *spans;
+    size_t index;
+    const void *base;
+} json_lazy;
+
 typedef union
 {
     const char *string;
     double number;
+    int64_t integer;
     KJSD_JSON_Object *object;
     KJSD_JSON_Array *array;
     int bool;
@@ -45,1388 +162,8529 @@ typedef union
 struct KJSD_JSON_ValueT
 {
     KJSD_JSON_Type type;
+    /* A number is held exactly in value.integer */
+    unsigned char is_integer;
+    /* Lies in a block of its container instead of its own allocation */
+    unsigned char is_inline;
     json_value_value value;
 };
 
+/* Scalar members or items of a heap container, allocated together when
+   the container is parsed. The values follow the header. */
+typedef struct json_value_block_tag
+{
+    struct json_value_block_tag *next;
+} json_value_block;
+
 struct KJSD_JSON_ObjectT
 {
+    KJSD_JSON_Arena *arena;
     const char **names;
     KJSD_JSON_Value **values;
     size_t count;
     size_t capacity;
+    /* Open addressing table of (member index + 1) over names. It is
+       built once the object reaches OBJECT_INDEX_THRESHOLD members. */
+    size_t *index;
+    size_t index_size;
+    const json_lazy *lazy;
+    json_value_block *blocks;
 };
 
 struct KJSD_JSON_ArrayT
 {
+    KJSD_JSON_Arena *arena;
     KJSD_JSON_Value **items;
     size_t count;
     size_t capacity;
+    const json_lazy *lazy;
+    json_value_block *blocks;
 };
 
-typedef enum
+/* Arena */
+typedef union
+{
+    double d;
+    void *p;
+    size_t s;
+    long l;
+} json_align;
+
+typedef struct json_arena_chunk_tag
 {
-    JSON_DEV_FILE,
-    JSON_DEV_MEM,
+    struct json_arena_chunk_tag *next;
+    size_t size;
+    size_t used;
+} json_arena_chunk;
 
-    JSON_DEV_NULL
-} json_accessor_type;
+/* A file mapping kept alive for strings parsed in situ from it */
+typedef struct json_arena_map_tag
+{
+    struct json_arena_map_tag *next;
+    void *addr;
+    size_t size;
+} json_arena_map;
 
+/* Member names are interned, so that a name repeated over records is
+   stored once and names of a document compare by address. Documents
+   in an arena share the table of the arena. A heap document has its
+   own table while it is built, and each of its names counts the
+   members holding it. */
 typedef struct
 {
-    char* buf;
+    const char **keys;
+    size_t *hashes;
+    size_t count;
     size_t size;
-} json_accessor_str;
+} json_intern;
+
+/* Header of a heap name, in front of its characters */
+typedef struct
+{
+    size_t refs;
+} json_key;
+
+struct KJSD_JSON_ArenaT
+{
+    json_arena_chunk *chunks;
+    size_t chunk_size;
+    const void *last;
+    json_arena_map *maps;
+    json_intern keys;
+    /* Chunks and the arena itself come from this */
+    KJSD_JSON_Allocator allocator;
+};
+
+/* Serializer */
+typedef enum
+{
+    JSON_SINK_FILE,
+    JSON_SINK_MEM,
+    JSON_SINK_BUFFER,
+    JSON_SINK_FD,
+    JSON_SINK_CALLBACK,
+
+    JSON_SINK_NULL
+} json_sink_type;
 
 typedef union
 {
-    FILE* file;
-    json_accessor_str str;
-} json_accessor_obj;
+    FILE *file;
+    int fd;
+    struct
+    {
+        KJSD_JSON_WriteFunc func;
+        void *ctx;
+    } callback;
+} json_sink;
+
+/* Output is staged in buf and handed to the sink in large blocks.
+   The memory sink points buf at the caller's buffer directly, so
+   flushing it only means running out of room. The buffer sink owns a
+   heap buffer and grows it instead. */
+typedef struct
+{
+    json_sink_type type;
+    json_sink sink;
+    char *buf;
+    size_t used;
+    size_t capacity;
+    size_t total;
+    int error;
+    char block[WRITER_BUFFER_SIZE];
+} json_writer;
+
+/* Binary */
+typedef struct
+{
+    KJSD_JSON_Arena *arena;
+    const unsigned char *cur;
+    const unsigned char *end;
+    size_t depth;
+    json_intern keys;
+} json_binary_reader;
+
+/* How a mapped file is parsed */
+typedef enum
+{
+    JSON_LOAD_COPY,
+    JSON_LOAD_INSITU,
+    JSON_LOAD_LAZY
+} json_load_mode;
+
+/* Path */
+typedef enum
+{
+    JSON_PATH_MEMBER,
+    JSON_PATH_ITEM,
+    JSON_PATH_ANY_MEMBER,
+    JSON_PATH_ANY_ITEM
+} json_path_step_type;
+
+typedef struct
+{
+    json_path_step_type type;
+    const char *name;
+    size_t length;
+    /* The item index, or the member slot where name was last found */
+    size_t index;
+} json_path_step;
+
+struct KJSD_JSON_PathT
+{
+    json_path_step *steps;
+    size_t count;
+    int has_wildcard;
+};
+
+/* Parser */
+typedef enum
+{
+    JSON_PS_VALUE,
+    JSON_PS_ARRAY_FIRST,
+    JSON_PS_OBJECT_FIRST,
+    JSON_PS_KEY,
+    JSON_PS_COLON,
+    JSON_PS_NEXT,
+    JSON_PS_STRING,
+    JSON_PS_NUMBER,
+    JSON_PS_LITERAL,
+    JSON_PS_SKIP,
+    JSON_PS_DONE,
+    JSON_PS_ERROR
+} json_parser_state;
+
+typedef enum
+{
+    JSON_NS_BEGIN,
+    JSON_NS_SIGN,
+    JSON_NS_ZERO,
+    JSON_NS_INT,
+    JSON_NS_DOT,
+    JSON_NS_FRAC,
+    JSON_NS_EXP,
+    JSON_NS_EXP_SIGN,
+    JSON_NS_EXP_DIGIT
+} json_number_state;
+
+/* A push tokenizer. Every token can be split across chunks, so the
+   parser keeps the state of the token in progress and resumes it on
+   the next chunk. Tokens found inside a single chunk are reported by
+   pointing into the chunk without copying. */
+typedef struct
+{
+    const KJSD_JSON_Handler *handler;
+    void *ctx;
+    json_parser_state state;
+    unsigned char stack[MAX_NESTING + 1];
+    size_t depth;
+    /* Token in progress */
+    int is_key;
+    int buffered;
+    int escape;
+    unsigned int code;
+    unsigned int surrogate;
+    json_number_state number;
+    int negative;
+    int truncated;
+    uint64_t mantissa;
+    int digits;
+    int exp10;
+    int exponent;
+    int exp_negative;
+    const char *literal;
+    size_t literal_pos;
+    char *buf;
+    size_t length;
+    size_t capacity;
+    /* A handler sets skip_value from object_key to pass over the
+       member value without reporting it */
+    int skip_value;
+    size_t skip_depth;
+    int skip_string;
+    int skip_scalar;
+} json_parser;
+
+/* DOM builder */
+typedef struct
+{
+    KJSD_JSON_Value value;
+    /* Member or item index in the container */
+    size_t slot;
+} json_scalar;
+
+typedef struct
+{
+    KJSD_JSON_Arena *arena;
+    KJSD_JSON_Value *root;
+    KJSD_JSON_Value *stack[MAX_NESTING + 1];
+    size_t depth;
+    /* In situ mode: strings are terminated and referenced in place */
+    char *insitu;
+    const char *insitu_end;
+    /* Name of the member whose value comes next */
+    const char *name;
+    size_t key_length;
+    json_intern keys;
+    /* Heap mode: scalars of the open containers are staged here and
+       moved into one block per container when it closes */
+    json_scalar *scalars;
+    size_t scalar_count;
+    size_t scalar_capacity;
+    size_t scalar_base[MAX_NESTING + 1];
+} json_builder;
+
+/* Builds one level of a lazy container. Nested containers are fed to
+   the tokenizer as a "null" placeholder, which is turned into a lazy
+   stub for the span in child. */
+typedef struct
+{
+    /* First, so that the builder callbacks can take this as ctx */
+    json_builder builder;
+    const json_lazy_span *spans;
+    size_t child;
+} json_lazy_builder;
+
+/* Deep copy. An arena copy is carved from one block sized beforehand,
+   with the strings at its end. A heap copy puts the values of each
+   container in a block of their own. */
+typedef struct
+{
+    KJSD_JSON_Arena *arena;
+    /* Names of a heap copy */
+    json_intern keys;
+    char *next;
+    char *strings;
+} json_cloner;
+
+/* JSON Patch generation. path is the JSON Pointer of the values being
+   compared. */
+typedef struct
+{
+    KJSD_JSON_Array *ops;
+    char *path;
+    size_t length;
+    size_t capacity;
+} json_differ;
+
+/* Binding */
+typedef struct
+{
+    const KJSD_JSON_Field *fields;
+    char *base;
+    /* Members usually come in the order of the table */
+    const KJSD_JSON_Field *next;
+} json_bind_frame;
+
+typedef struct
+{
+    json_parser parser;
+    const KJSD_JSON_Field *fields;
+    void *out;
+    json_bind_frame stack[MAX_NESTING + 1];
+    size_t depth;
+    /* Field of the value to come */
+    const KJSD_JSON_Field *field;
+} json_binder;
+
+/* NDJSON */
+typedef enum
+{
+    JSON_LINES_FREE,
+    JSON_LINES_BUSY,
+    JSON_LINES_READY
+} json_lines_state;
+
+/* A batch of lines and the records parsed from it */
+typedef struct
+{
+    json_lines_state state;
+    size_t batch;
+    const char *begin;
+    const char *end;
+    KJSD_JSON_Arena *arena;
+    /* One per record, NULL for an invalid record */
+    KJSD_JSON_Value **values;
+    size_t count;
+    size_t capacity;
+    int error;
+} json_lines_slot;
+
+/* Batch b is parsed into slots[b % slot_count] by whichever worker
+   claims it, and handed to func in order on the calling thread. */
+typedef struct
+{
+    const char *cur;
+    const char *end;
+    json_lines_slot *slots;
+    size_t slot_count;
+    size_t next_batch;
+    int stop;
+#if defined(JSON_HAVE_THREADS)
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+} json_lines;
+
+/* Parallel array: elements of the root array between two top-level
+   commas, parsed as an array of their own */
+typedef struct
+{
+    const char *begin;
+    const char *end;
+    KJSD_JSON_Value *value;
+} json_array_slice;
+
+/* Number */
+typedef struct
+{
+    uint64_t high;
+    uint64_t low;
+} json_uint128;
 
+/* Floating point value f * 2^e for Grisu2 */
 typedef struct
 {
-    json_accessor_type sym;
-    json_accessor_obj obj;
-} json_accessor;
+    uint64_t f;
+    int e;
+} json_diyfp;
+
+struct KJSD_JSON_ParserT
+{
+    json_parser parser;
+    json_builder builder;
+};
 
 /* Various */
-static int try_realloc(void **ptr, size_t new_size);
-static char* json_strndup(const char *string, size_t n);
-static int is_utf(const unsigned char *string);
-static int is_decimal(const char *string, size_t length);
-static const char* json_escape_string(const char* src);
-static size_t json_strchg(const char* src,
-                          const char* old_str, const char* new_str,
-                          char* dst, size_t dst_sz);
+static int try_realloc(KJSD_JSON_Arena *arena, void **ptr,
+                       size_t old_size, size_t new_size);
+static void* json_alloc(KJSD_JSON_Arena *arena, size_t size);
+static void json_dealloc(KJSD_JSON_Arena *arena, const void *ptr);
+static char* json_strndup(KJSD_JSON_Arena *arena,
+                          const char *string, size_t n);
+static size_t json_grow_capacity(size_t capacity, size_t max_capacity,
+                                 size_t element_size);
+static size_t json_hash(const char *string, size_t n);
+static int json_name_equals(const char *name, const char *string, size_t n);
+
+/* Key interning */
+static json_intern* json_intern_table(KJSD_JSON_Arena *arena,
+                                      json_intern *own);
+static const char* json_intern_key(KJSD_JSON_Arena *arena,
+                                   json_intern *table,
+                                   const char *name, size_t n);
+static int json_intern_grow(KJSD_JSON_Arena *arena, json_intern *table);
+static void json_intern_release(json_intern *table);
+static const char* json_key_new(KJSD_JSON_Arena *arena,
+                                const char *name, size_t n);
+static void json_key_retain(KJSD_JSON_Arena *arena, const char *key);
+static void json_key_release(KJSD_JSON_Arena *arena, const char *key);
+
+/* Allocator */
+static void* json_libc_alloc(void *ctx, size_t size);
+static void* json_libc_resize(void *ctx, void *ptr, size_t size);
+static void json_libc_release(void *ctx, void *ptr);
+
+static KJSD_JSON_Allocator json_allocator = {
+    json_libc_alloc,
+    json_libc_resize,
+    json_libc_release,
+    NULL
+};
+
+/* Arena */
+static json_arena_chunk* json_arena_chunk_init(KJSD_JSON_Arena *arena,
+                                               size_t size);
+static void json_arena_chunk_free(KJSD_JSON_Arena *arena,
+                                  json_arena_chunk *chunk);
+static void json_arena_unmap(KJSD_JSON_Arena *arena);
+static void* json_arena_alloc(KJSD_JSON_Arena *arena, size_t size);
+static void* json_arena_realloc(KJSD_JSON_Arena *arena, void *ptr,
+                                size_t old_size, size_t new_size);
 
 /* JSON Object */
-static KJSD_JSON_Object* json_object_init(void);
+static KJSD_JSON_Object* json_object_init(KJSD_JSON_Arena *arena);
 static int json_object_add(KJSD_JSON_Object *object,
-                           const char *name, KJSD_JSON_Value *value);
+                           const char *name, size_t n,
+                           KJSD_JSON_Value *value);
+static int json_object_add_key(KJSD_JSON_Object *object,
+                               const char *key, size_t n,
+                               KJSD_JSON_Value *value);
+static int json_object_insert(KJSD_JSON_Object *object,
+                              const char *name, size_t n,
+                              KJSD_JSON_Value *value);
+static int json_object_append(KJSD_JSON_Object *object,
+                              const char *name, KJSD_JSON_Value *value);
 static int json_object_resize(KJSD_JSON_Object *object,
                               size_t capacity);
 static KJSD_JSON_Value* json_object_nget_value(
     const KJSD_JSON_Object *object, const char *name, size_t n);
+static size_t json_object_nfind(const KJSD_JSON_Object *object,
+                                const char *name, size_t n);
+static size_t json_object_find_key(const KJSD_JSON_Object *object,
+                                   const char *key, size_t n);
+static int json_object_reindex(KJSD_JSON_Object *object,
+                               size_t index_size);
+static void json_object_index_insert(KJSD_JSON_Object *object,
+                                     size_t member);
+static KJSD_JSON_Value* json_object_set(KJSD_JSON_Object *object,
+                                        const char *name,
+                                        KJSD_JSON_Type type);
 static void json_object_free(KJSD_JSON_Object *object);
 
 /* JSON Array */
-static KJSD_JSON_Array* json_array_init(void);
+static KJSD_JSON_Array* json_array_init(KJSD_JSON_Arena *arena);
 static int json_array_add(KJSD_JSON_Array *array,
                           KJSD_JSON_Value *value);
 static int json_array_resize(KJSD_JSON_Array *array,
                              size_t capacity);
+static KJSD_JSON_Value* json_array_set(KJSD_JSON_Array *array,
+                                       size_t index, KJSD_JSON_Type type);
+static KJSD_JSON_Value* json_array_insert(KJSD_JSON_Array *array,
+                                          size_t index,
+                                          KJSD_JSON_Type type);
 static void json_array_free(KJSD_JSON_Array *array);
 
 /* JSON Value */
-static KJSD_JSON_Value* json_value_init_object(void);
-static KJSD_JSON_Value* json_value_init_array(void);
-static KJSD_JSON_Value* json_value_init_string(const char *string);
-static KJSD_JSON_Value* json_value_init_number(double number);
-static KJSD_JSON_Value* json_value_init_bool(int bool);
-static KJSD_JSON_Value* json_value_init_null(void);
+static KJSD_JSON_Value* json_value_alloc(KJSD_JSON_Arena *arena,
+                                         KJSD_JSON_Type type);
+static void json_value_reuse(KJSD_JSON_Arena *arena,
+                             KJSD_JSON_Value *value, KJSD_JSON_Type type);
+static void json_value_blocks_free(json_value_block *block);
+static KJSD_JSON_Value* json_value_init_object(KJSD_JSON_Arena *arena);
+static KJSD_JSON_Value* json_value_init_array(KJSD_JSON_Arena *arena);
+static KJSD_JSON_Value* json_value_init_string(KJSD_JSON_Arena *arena,
+                                               const char *string);
+static KJSD_JSON_Value* json_value_init_number(KJSD_JSON_Arena *arena,
+                                               double number);
+static KJSD_JSON_Value* json_value_init_integer(KJSD_JSON_Arena *arena,
+                                                int64_t integer);
+static KJSD_JSON_Value* json_value_init_bool(KJSD_JSON_Arena *arena,
+                                             int bool);
+static KJSD_JSON_Value* json_value_init_null(KJSD_JSON_Arena *arena);
+static void json_value_free(KJSD_JSON_Arena *arena,
+                            KJSD_JSON_Value *value);
+
+/* Scanner */
+static const char* json_skip_spaces(const char *cur, const char *end);
+static const char* json_scan_string(const char *cur, const char *end);
+static const char* json_scan_escape(const char *cur, const char *end);
+
+/* Path */
+static KJSD_JSON_Value* json_path_step_into(json_path_step *step,
+                                            const KJSD_JSON_Value *value);
+static int json_path_walk(KJSD_JSON_Path *path, size_t step,
+                          KJSD_JSON_Value *value,
+                          KJSD_JSON_PathFunc func, void *ctx,
+                          size_t *matches);
+static int json_path_first(void *ctx, KJSD_JSON_Value *value);
 
 /* Parser */
-static void skip_quotes(const char **string);
-static const char* get_processed_string(const char **string);
-static KJSD_JSON_Value* parse_object_value(const char **string,
-                                           size_t nesting);
-static KJSD_JSON_Value* parse_array_value(const char **string,
-                                          size_t nesting);
-static KJSD_JSON_Value* parse_string_value(const char **string);
-static KJSD_JSON_Value* parse_bool_value(const char **string);
-static KJSD_JSON_Value* parse_number_value(const char **string);
-static KJSD_JSON_Value* parse_null_value(const char **string);
-static KJSD_JSON_Value* parse_value(const char **string,
-                                    size_t nesting);
+static void json_parser_init(json_parser *p,
+                             const KJSD_JSON_Handler *handler, void *ctx);
+static void json_parser_reset(json_parser *p);
+static void json_parser_release(json_parser *p);
+static size_t json_parser_feed(json_parser *p,
+                               const char *data, size_t size);
+static int json_parser_finish(json_parser *p);
+static const char* json_parser_token(json_parser *p, const char *cur);
+static const char* json_parser_begin_value(json_parser *p,
+                                           const char *cur);
+static const char* json_parser_end_container(json_parser *p,
+                                             const char *cur,
+                                             unsigned char open);
+static void json_parser_end_value(json_parser *p);
+static void json_parser_begin_token(json_parser *p,
+                                    json_parser_state state);
+static const char* json_parser_string(json_parser *p,
+                                      const char *cur, const char *end);
+static const char* json_parser_escape(json_parser *p,
+                                      const char *cur, const char *end);
+static const char* json_parser_number(json_parser *p,
+                                      const char *cur, const char *end);
+static void json_parser_digit(json_parser *p, char c, int fraction);
+static int json_parser_end_number(json_parser *p,
+                                  const char *start, const char *cur);
+static int json_parser_emit_number(json_parser *p,
+                                   const char *text, size_t length);
+static const char* json_parser_skip(json_parser *p,
+                                    const char *cur, const char *end);
+static const char* json_parser_literal(json_parser *p,
+                                       const char *cur, const char *end);
+static int json_parser_append(json_parser *p,
+                              const char *data, size_t n);
+static int json_parser_put(json_parser *p, const char *data, size_t n);
+static int json_parser_put_code(json_parser *p, unsigned int code);
+static int json_parser_flush_surrogate(json_parser *p);
+static int json_parser_put_utf8(json_parser *p, unsigned int code);
+static int json_parse_file(json_parser *p, FILE* in, int container_only);
+
+/* DOM builder */
+static void json_builder_init(json_builder *b, KJSD_JSON_Arena *arena);
+static KJSD_JSON_Value* json_builder_finish(json_builder *b, int success);
+static void json_builder_reset(json_builder *b);
+static void json_builder_discard(json_builder *b);
+static KJSD_JSON_Value* json_builder_value(json_builder *b,
+                                           KJSD_JSON_Type type);
+static int json_builder_add(json_builder *b, KJSD_JSON_Value *value);
+static int json_builder_inline(json_builder *b, KJSD_JSON_Value *value);
+static const char* json_builder_insitu(json_builder *b,
+                                       const char *string, size_t length);
+static int json_builder_push(json_builder *b, KJSD_JSON_Value *value);
+static int json_builder_pop(void *ctx);
+static int json_builder_null(void *ctx);
+static int json_builder_bool(void *ctx, int value);
+static int json_builder_number(void *ctx, double value);
+static int json_builder_integer(void *ctx, int64_t value);
+static int json_builder_string(void *ctx, const char *value, size_t length);
+static int json_builder_start_object(void *ctx);
+static int json_builder_key(void *ctx, const char *name, size_t length);
+static int json_builder_start_array(void *ctx);
+static KJSD_JSON_Value* json_deserialize(KJSD_JSON_Arena *arena,
+                                         FILE* in);
+static KJSD_JSON_Value* json_deserialize_string(KJSD_JSON_Arena *arena,
+                                                const char *string,
+                                                char *insitu);
+static KJSD_JSON_Value* json_deserialize_buffer(KJSD_JSON_Arena *arena,
+                                                const char *data,
+                                                size_t length,
+                                                char *insitu);
+static KJSD_JSON_Value* json_deserialize_file(KJSD_JSON_Arena *arena,
+                                              const char *path,
+                                              json_load_mode mode);
+
+static const KJSD_JSON_Handler json_builder_handler = {
+    json_builder_null,
+    json_builder_bool,
+    json_builder_number,
+    json_builder_string,
+    json_builder_start_object,
+    json_builder_key,
+    json_builder_pop,
+    json_builder_start_array,
+    json_builder_pop,
+    json_builder_integer
+};
+
+/* Number */
+static unsigned int json_clz64(uint64_t x);
+static json_uint128 json_mul64(uint64_t a, uint64_t b);
+static int json_decimal_to_double(uint64_t w, int q, int negative,
+                                  double *out);
+static int json_strtod(const char *text, size_t length, double *out);
+static size_t json_format_integer(int64_t value, char *buf);
+static size_t json_format_double(double value, char *buf);
+static json_diyfp json_diyfp_mul(json_diyfp x, json_diyfp y);
+static int json_grisu2(double value, char *digits, int *K);
+static int json_digit_gen(json_diyfp w, json_diyfp mp, uint64_t delta,
+                          char *buffer, int *K);
+static void json_grisu_round(char *buffer, int length, uint64_t delta,
+                             uint64_t rest, uint64_t ten_kappa,
+                             uint64_t wp_w);
+
+/* Binding */
+static void json_bind_init(json_binder *b, const KJSD_JSON_Field *fields,
+                           void *out);
+static const KJSD_JSON_Field* json_bind_take(json_binder *b,
+                                             KJSD_JSON_FieldType type);
+static int json_bind_store_integer(void *ptr, size_t size, int64_t value);
+static int json_bind_null(void *ctx);
+static int json_bind_bool(void *ctx, int value);
+static int json_bind_number(void *ctx, double value);
+static int json_bind_integer(void *ctx, int64_t value);
+static int json_bind_string(void *ctx, const char *value, size_t length);
+static int json_bind_start_object(void *ctx);
+static int json_bind_key(void *ctx, const char *name, size_t length);
+static int json_bind_end_object(void *ctx);
+static int json_bind_start_array(void *ctx);
+
+static const KJSD_JSON_Handler json_bind_handler = {
+    json_bind_null,
+    json_bind_bool,
+    json_bind_number,
+    json_bind_string,
+    json_bind_start_object,
+    json_bind_key,
+    json_bind_end_object,
+    json_bind_start_array,
+    NULL,
+    json_bind_integer
+};
+
+/* NDJSON */
+static int json_lines_run(const char *data, size_t size, size_t threads,
+                          KJSD_JSON_RecordFunc func, void *ctx);
+static const char* json_lines_split(const char *cur, const char *end);
+static void json_lines_claim(json_lines *lines, json_lines_slot *slot);
+static void json_lines_parse(json_lines_slot *slot);
+static int json_lines_deliver(json_lines_slot *slot, size_t *index,
+                              KJSD_JSON_RecordFunc func, void *ctx);
+#if defined(JSON_HAVE_THREADS)
+static void* json_lines_worker(void *arg);
+#endif
+
+/* Parallel array */
+static KJSD_JSON_Value* json_deserialize_parallel(const char *data,
+                                                  size_t length,
+                                                  size_t threads);
+#if defined(JSON_HAVE_THREADS)
+static size_t json_array_split(const char *data, size_t length,
+                               json_array_slice *slices, size_t count);
+static void* json_array_slice_parse(void *arg);
+#endif
+
+/* Lazy DOM */
+static unsigned int json_structural_mask(const char *p, size_t n);
+#if defined(JSON_HAVE_THREADS)
+static unsigned int json_comma_mask(const char *p, size_t n);
+#endif
+static json_lazy_span* json_lazy_index(KJSD_JSON_Arena *arena,
+                                       const char *data, size_t length);
+static KJSD_JSON_Value* json_lazy_value(KJSD_JSON_Arena *arena,
+                                        const json_lazy_span *spans,
+                                        size_t index);
+static KJSD_JSON_Value* json_lazy_build(KJSD_JSON_Arena *arena,
+                                        const json_lazy *lazy);
+static int json_lazy_load_object(KJSD_JSON_Object *object);
+static int json_lazy_load_array(KJSD_JSON_Array *array);
+static int json_lazy_null(void *ctx);
+static KJSD_JSON_Value* json_deserialize_lazy(KJSD_JSON_Arena *arena,
+                                              const char *data,
+                                              size_t length);
+
+static const KJSD_JSON_Handler json_lazy_handler = {
+    json_lazy_null,
+    json_builder_bool,
+    json_builder_number,
+    json_builder_string,
+    json_builder_start_object,
+    json_builder_key,
+    json_builder_pop,
+    json_builder_start_array,
+    json_builder_pop,
+    json_builder_integer
+};
+
+/* Copy */
+static const KJSD_JSON_Object* json_object_source(
+    const KJSD_JSON_Object *object);
+static const KJSD_JSON_Array* json_array_source(
+    const KJSD_JSON_Array *array);
+static int json_clone_size(const KJSD_JSON_Value *value,
+                           size_t *size, size_t *strings);
+static void* json_cloner_alloc(json_cloner *c, size_t size);
+static KJSD_JSON_Value* json_cloner_values(json_cloner *c, size_t n,
+                                           json_value_block **blocks);
+static const char* json_cloner_key(json_cloner *c, const char *name);
+static char* json_cloner_string(json_cloner *c, const char *string);
+static int json_clone_into(json_cloner *c, KJSD_JSON_Value *value,
+                           const KJSD_JSON_Value *source);
+static int json_clone_object(json_cloner *c, KJSD_JSON_Object *object,
+                             const KJSD_JSON_Object *source);
+static int json_clone_array(json_cloner *c, KJSD_JSON_Array *array,
+                            const KJSD_JSON_Array *source);
+static int json_cloner_init(json_cloner *c, KJSD_JSON_Arena *arena,
+                            const KJSD_JSON_Value *value, size_t size);
+static KJSD_JSON_Value* json_clone(KJSD_JSON_Arena *arena,
+                                   const KJSD_JSON_Value *value);
+static int json_copy_value(KJSD_JSON_Arena *arena, KJSD_JSON_Value *value,
+                           const KJSD_JSON_Value *source);
+static int json_share_value(KJSD_JSON_Arena *arena, KJSD_JSON_Value *value,
+                            const KJSD_JSON_Value *base);
+static KJSD_JSON_Object* json_share_object(KJSD_JSON_Arena *arena,
+                                           const KJSD_JSON_Object *base);
+static KJSD_JSON_Array* json_share_array(KJSD_JSON_Arena *arena,
+                                         const KJSD_JSON_Array *base);
+static int json_share_load_object(KJSD_JSON_Object *object);
+static int json_share_load_array(KJSD_JSON_Array *array);
+
+/* Patch */
+static KJSD_JSON_Arena* json_value_arena(const KJSD_JSON_Value *value);
+static int json_value_equals(const KJSD_JSON_Value *a,
+                             const KJSD_JSON_Value *b);
+static int json_object_equals(const KJSD_JSON_Object *a,
+                              const KJSD_JSON_Object *b);
+static int json_array_equals(const KJSD_JSON_Array *a,
+                             const KJSD_JSON_Array *b);
+static int json_pointer_token(const char **cur, char *buf, size_t *n);
+static int json_pointer_index(const char *token, size_t n, size_t *index);
+static KJSD_JSON_Value* json_pointer_child(const KJSD_JSON_Value *value,
+                                           const char *token, size_t n);
+static KJSD_JSON_Value* json_pointer_parent(KJSD_JSON_Value *root,
+                                            const char *pointer,
+                                            char *buf, size_t *n);
+static KJSD_JSON_Value* json_pointer_get(KJSD_JSON_Value *root,
+                                         const char *pointer, char *buf);
+static KJSD_JSON_Value* json_patch_slot(KJSD_JSON_Value *root,
+                                        const char *pointer, char *buf,
+                                        int replace,
+                                        KJSD_JSON_Arena **arena);
+static int json_patch_put(KJSD_JSON_Value *root, const char *path,
+                          const KJSD_JSON_Value *value, char *buf,
+                          int replace);
+static int json_patch_remove(KJSD_JSON_Value *parent,
+                             const char *token, size_t n);
+static void json_patch_adopt(KJSD_JSON_Value *slot,
+                             const KJSD_JSON_Value *value);
+static int json_patch_move(KJSD_JSON_Value *root, const char *from,
+                           const char *path, char *buf);
+static int json_patch_copy(KJSD_JSON_Value *root, const char *from,
+                           const char *path, char *buf);
+static int json_patch_op(KJSD_JSON_Value *root, const KJSD_JSON_Object *op);
+static int json_merge_patch(KJSD_JSON_Arena *arena, KJSD_JSON_Value *target,
+                            const KJSD_JSON_Value *patch);
+static int json_differ_push(json_differ *d, const char *token, size_t n);
+static int json_differ_push_index(json_differ *d, size_t index);
+static void json_differ_pop(json_differ *d, size_t length);
+static int json_differ_op(json_differ *d, const char *op,
+                          const KJSD_JSON_Value *value);
+static int json_diff_value(json_differ *d, const KJSD_JSON_Value *from,
+                           const KJSD_JSON_Value *to);
+static int json_diff_object(json_differ *d, const KJSD_JSON_Object *a,
+                            const KJSD_JSON_Object *b);
+static int json_diff_array(json_differ *d, const KJSD_JSON_Array *a,
+                           const KJSD_JSON_Array *b);
+static int json_merge_diff(KJSD_JSON_Value *patch,
+                           const KJSD_JSON_Value *from,
+                           const KJSD_JSON_Value *to);
 
 /* Serializer */
-static size_t json_serialize(const KJSD_JSON_Value* value,
-                             json_accessor* out);
-static size_t json_serialize_object(KJSD_JSON_Object* value,
-                                    json_accessor* out);
-static size_t json_serialize_array(KJSD_JSON_Array* value,
-                                   json_accessor* out);
-static size_t json_serialize_string(const char* value,
-                                    json_accessor* out);
-static size_t json_serialize_number(double value,
-                                    json_accessor* out);
-static size_t json_serialize_bool(int value,
-                                  json_accessor* out);
-static size_t json_serialize_vanilla(const char* value,
-                                     json_accessor* out);
+static void json_writer_init(json_writer *w, json_sink_type type);
+static void json_writer_flush(json_writer *w);
+static size_t json_writer_finish(json_writer *w);
+static void json_write(json_writer *w, const char *data, size_t n);
+static void json_write_char(json_writer *w, char c);
+static size_t json_serialize_with(const KJSD_JSON_Value* value,
+                                  json_writer *w);
+static void json_serialize(const KJSD_JSON_Value* value, json_writer *w);
+static void json_serialize_object(const KJSD_JSON_Object* value,
+                                  json_writer *w);
+static void json_serialize_array(const KJSD_JSON_Array* value,
+                                 json_writer *w);
+static void json_serialize_string(const char* value, json_writer *w);
+static void json_serialize_number(const KJSD_JSON_Value* value,
+                                  json_writer *w);
+static void json_serialize_formatted(const KJSD_JSON_Value* value,
+                                     const KJSD_JSON_Format *format,
+                                     json_writer *w);
+static void json_serialize_format(const KJSD_JSON_Value* value,
+                                  const KJSD_JSON_Format *format,
+                                  size_t depth, json_writer *w);
+static void json_serialize_format_object(const KJSD_JSON_Object* value,
+                                         const KJSD_JSON_Format *format,
+                                         size_t depth, json_writer *w);
+static void json_serialize_format_array(const KJSD_JSON_Array* value,
+                                        const KJSD_JSON_Format *format,
+                                        size_t depth, json_writer *w);
+static void json_write_indent(json_writer *w, const KJSD_JSON_Format *format,
+                              size_t depth);
+static int json_name_compare(const void *a, const void *b);
+static int json_writer_init_buffer(json_writer *w);
+static char* json_writer_release(json_writer *w, size_t *length);
+
+/* Binary */
+static void json_write_varint(json_writer *w, uint64_t value);
+static void json_write_u64(json_writer *w, uint64_t value);
+static void json_serialize_binary(const KJSD_JSON_Value* value,
+                                  json_writer *w);
+static KJSD_JSON_Value* json_deserialize_binary(KJSD_JSON_Arena *arena,
+                                                const void *data,
+                                                size_t size);
+static KJSD_JSON_Value* json_binary_value(json_binary_reader *r);
+static int json_binary_varint(json_binary_reader *r, uint64_t *value);
+static int json_binary_count(json_binary_reader *r, size_t *value);
+static char* json_binary_string(json_binary_reader *r, size_t *length);
+static int json_binary_array(json_binary_reader *r,
+                             KJSD_JSON_Array *array);
+static int json_binary_object(json_binary_reader *r,
+                              KJSD_JSON_Object *object);
 
 
 /* Various */
-static int try_realloc(void **ptr, size_t new_size)
+static int try_realloc(KJSD_JSON_Arena *arena, void **ptr,
+                       size_t old_size, size_t new_size)
 {
-    void *reallocated_ptr = json_realloc(*ptr, new_size);
+    void *reallocated_ptr = arena ?
+        json_arena_realloc(arena, *ptr, old_size, new_size):
+        json_realloc(*ptr, new_size);
     if (!reallocated_ptr) return ERROR;
 
     *ptr = reallocated_ptr;
     return SUCCESS;
 }
 
-static char* json_strndup(const char *string, size_t n)
+static void* json_alloc(KJSD_JSON_Arena *arena, size_t size)
 {
-    char *output_string = (char*)json_malloc(n + 1);
-    if (!output_string) return NULL;
-
-    output_string[n] = '\0';
-    strncpy(output_string, string, n);
-    return output_string;
+    return arena ? json_arena_alloc(arena, size): json_malloc(size);
 }
 
-static int is_utf(const unsigned char *s)
+static void json_dealloc(KJSD_JSON_Arena *arena, const void *ptr)
 {
-    return isxdigit(s[0]) && isxdigit(s[1])
-        && isxdigit(s[2]) && isxdigit(s[3]);
+    /* Arena memory is released all at once by the arena itself */
+    if (!arena) json_free(ptr);
 }
 
-static int is_decimal(const char *string, size_t length)
+static char* json_strndup(KJSD_JSON_Arena *arena,
+                          const char *string, size_t n)
 {
-    if (length > 1 && string[0] == '0' && string[1] != '.') return 0;
-    if (length > 2 && !strncmp(string, "-0", 2) && string[2] != '.')
-        return 0;
+    char *output_string = (char*)json_alloc(arena, n + 1);
+    if (!output_string) return NULL;
 
-    while (length--)
-    {
-        if (strchr("xX", string[length])) return 0;
-    }
-    return 1;
+    output_string[n] = '\0';
+    memcpy(output_string, string, n);
+    return output_string;
 }
 
-/* JSON Object */
-static KJSD_JSON_Object * json_object_init(void)
+static size_t json_grow_capacity(size_t capacity, size_t max_capacity,
+                                 size_t element_size)
 {
-    KJSD_JSON_Object *new_obj =
-        (KJSD_JSON_Object*)json_malloc(sizeof(KJSD_JSON_Object));
-    if (!new_obj) return NULL;
-
-    new_obj->names = (const char**)NULL;
-    new_obj->values = (KJSD_JSON_Value**)NULL;
-    new_obj->capacity = 0;
-    new_obj->count = 0;
-    return new_obj;
-}
+    size_t new_capacity;
 
-static int json_object_add(KJSD_JSON_Object *object,
-                           const char *name, KJSD_JSON_Value *value)
-{
-    size_t index;
+    if (capacity < STARTING_CAPACITY)
+        new_capacity = STARTING_CAPACITY;
+    else if (capacity < GROWTH_DOUBLING_LIMIT)
+        new_capacity = capacity * 2;
+    else
+        new_capacity = capacity + capacity / 2;
 
-    if (object->count >= object->capacity)
+    if (max_capacity > 0)
     {
-        size_t new_capacity = MAX(object->capacity * 2, STARTING_CAPACITY);
-        if (new_capacity > OBJECT_MAX_CAPACITY) return ERROR;
-        if (json_object_resize(object, new_capacity) == ERROR) 
-            return ERROR;
+        if (capacity >= max_capacity) return 0;
+        if (new_capacity > max_capacity) new_capacity = max_capacity;
     }
-    if (KJSD_JSON_objectGetValue(object, name) != NULL) 
-        return ERROR;
-
-    index = object->count;
-    object->names[index] = json_strndup(name, strlen(name));
-    if (!object->names[index]) return ERROR;
+    if ((new_capacity < capacity) ||
+        (new_capacity > ((size_t)-1) / element_size)) return 0;
 
-    object->values[index] = value;
-    object->count++;
-    return SUCCESS;
+    return new_capacity;
 }
 
-static int json_object_resize(KJSD_JSON_Object *object,
-                              size_t capacity)
+/* FNV-1a */
+static size_t json_hash(const char *string, size_t n)
 {
-    if (try_realloc((void**)&object->names,
-                    capacity * sizeof(char*)) == ERROR) return ERROR;
-    if (try_realloc((void**)&object->values,
-                    capacity * sizeof(KJSD_JSON_Value*)) == ERROR)
-        return ERROR;
+    size_t hash = (size_t)2166136261U;
 
-    object->capacity = capacity;
-    return SUCCESS;
+    while (n--)
+    {
+        hash ^= (unsigned char)*string++;
+        hash *= 16777619U;
+    }
+    return hash;
 }
 
-static KJSD_JSON_Value* json_object_nget_value(
-    const KJSD_JSON_Object *object, const char *name, size_t n)
+/* string holds n bytes and may contain a NUL from a \u0000 escape,
+   which never equals a name */
+static int json_name_equals(const char *name, const char *string, size_t n)
 {
-    size_t i, name_length;
+    size_t i;
 
-    for (i = 0; i < KJSD_JSON_objectGetCount(object); i++)
+    if (name == string) return name[n] == '\0';
+    for (i = 0; i < n; i++)
     {
-        name_length = strlen(object->names[i]);
-        if (name_length != n) continue;
-        if (strncmp(object->names[i], name, n) == 0) 
-        {
-            return object->values[i];
-        }
+        if ((name[i] != string[i]) || (name[i] == '\0')) return 0;
     }
-
-    return NULL;
+    return name[n] == '\0';
 }
 
-static void json_object_free(KJSD_JSON_Object *object)
+/* Key interning */
+static json_intern* json_intern_table(KJSD_JSON_Arena *arena,
+                                      json_intern *own)
 {
-    while (object->count--)
-    {
-        json_free(object->names[object->count]);
-        KJSD_JSON_free(object->values[object->count]);
-    }
-    json_free(object->names);
-    json_free(object->values);
-    json_free(object);
+    return arena ? &arena->keys: own;
 }
 
-/* JSON Array */
-static KJSD_JSON_Array * json_array_init(void) 
+/* Returns the copy of name held by table, adding it if it is not there
+   yet. The table keeps a reference to the copy. */
+static const char* json_intern_key(KJSD_JSON_Arena *arena,
+                                   json_intern *table,
+                                   const char *name, size_t n)
 {
-    KJSD_JSON_Array *new_array =
-        (KJSD_JSON_Array*)json_malloc(sizeof(KJSD_JSON_Array));
-    if (!new_array) return NULL;
+    size_t hash = json_hash(name, n);
+    size_t mask, i;
+    const char *key;
 
-    new_array->items = (KJSD_JSON_Value**)NULL;
-    new_array->capacity = 0;
-    new_array->count = 0;
-    return new_array;
-}
+    if (((table->count + 1) * 2 > table->size) &&
+        (json_intern_grow(arena, table) == ERROR)) return NULL;
 
-static int json_array_add(KJSD_JSON_Array *array,
-                          KJSD_JSON_Value *value)
-{
-    if (array->count >= array->capacity)
+    mask = table->size - 1;
+    for (i = hash & mask; (key = table->keys[i]) != NULL;
+         i = (i + 1) & mask)
     {
-        size_t new_capacity = MAX(array->capacity * 2, STARTING_CAPACITY);
-        if (new_capacity > ARRAY_MAX_CAPACITY) return ERROR;
-        if (!json_array_resize(array, new_capacity)) return ERROR;
+        if ((table->hashes[i] == hash) && json_name_equals(key, name, n))
+            return key;
     }
 
-    array->items[array->count] = value;
-    array->count++;
-    return SUCCESS;
+    key = json_key_new(arena, name, n);
+    if (!key) return NULL;
+
+    table->keys[i] = key;
+    table->hashes[i] = hash;
+    table->count++;
+    return key;
 }
 
-static int json_array_resize(KJSD_JSON_Array *array, size_t capacity)
+static int json_intern_grow(KJSD_JSON_Arena *arena, json_intern *table)
 {
-    if (try_realloc((void**)&array->items,
-                    capacity * sizeof(KJSD_JSON_Value*)) == ERROR)
+    size_t size = (table->size > 0) ? table->size * 2: INTERN_MIN_SIZE;
+    size_t mask = size - 1;
+    size_t i, j;
+    const char **keys;
+    size_t *hashes;
+
+    if (size > (size_t)-1 / (sizeof(char*) + sizeof(size_t)))
         return ERROR;
+    keys = (const char**)json_alloc(arena,
+                                    size * (sizeof(char*) + sizeof(size_t)));
+    if (!keys) return ERROR;
 
-    array->capacity = capacity;
+    hashes = (size_t*)(keys + size);
+    memset(keys, 0, size * sizeof(char*));
+    for (i = 0; i < table->size; i++)
+    {
+        if (!table->keys[i]) continue;
+
+        for (j = table->hashes[i] & mask; keys[j] != NULL;
+             j = (j + 1) & mask);
+        keys[j] = table->keys[i];
+        hashes[j] = table->hashes[i];
+    }
+    json_dealloc(arena, table->keys);
+    table->keys = keys;
+    table->hashes = hashes;
+    table->size = size;
     return SUCCESS;
 }
 
-static void json_array_free(KJSD_JSON_Array *array)
+/* Drops the references of a heap table */
+static void json_intern_release(json_intern *table)
 {
-    while (array->count--)
+    size_t i;
+
+    for (i = 0; i < table->size; i++)
     {
-        KJSD_JSON_free(array->items[array->count]);
+        if (table->keys[i]) json_key_release(NULL, table->keys[i]);
     }
-    json_free(array->items);
-    json_free(array);
+    json_free(table->keys);
+    memset(table, 0, sizeof(json_intern));
 }
 
-/* JSON Value */
-static KJSD_JSON_Value* json_value_init_object(void)
+/* Names in an arena live as long as the arena, so only heap names carry
+   a reference count */
+static const char* json_key_new(KJSD_JSON_Arena *arena,
+                                const char *name, size_t n)
 {
-    KJSD_JSON_Value* new_value =
-        (KJSD_JSON_Value*)json_malloc(sizeof(KJSD_JSON_Value));
-    if (!new_value) return NULL;
+    json_key *key;
 
-    new_value->type = KJSD_JSON_OBJECT;
-    new_value->value.object = json_object_init();
+    if (arena) return json_strndup(arena, name, n);
 
-    if (!new_value->value.object)
-    {
-        json_free(new_value);
-        return NULL;
-    }
-    return new_value;
+    key = (json_key*)json_malloc(sizeof(json_key) + n + 1);
+    if (!key) return NULL;
+
+    key->refs = 1;
+    memcpy(key + 1, name, n);
+    ((char*)(key + 1))[n] = '\0';
+    return (const char*)(key + 1);
 }
 
-static KJSD_JSON_Value * json_value_init_array(void)
+static void json_key_retain(KJSD_JSON_Arena *arena, const char *key)
 {
-    KJSD_JSON_Value *new_value =
-        (KJSD_JSON_Value*)json_malloc(sizeof(KJSD_JSON_Value));
-    if (!new_value) return NULL;
+    if (!arena) ((json_key*)key - 1)->refs++;
+}
 
-    new_value->type = KJSD_JSON_ARRAY;
-    new_value->value.array = json_array_init();
+static void json_key_release(KJSD_JSON_Arena *arena, const char *key)
+{
+    json_key *header;
 
-    if (!new_value->value.array)
-    {
-        json_free(new_value);
-        return NULL;
-    }
-    return new_value;
+    if (arena) return;
+
+    header = (json_key*)key - 1;
+    if (--header->refs == 0) json_free(header);
 }
 
-static KJSD_JSON_Value * json_value_init_string(const char *string)
+/* Allocator */
+static void* json_libc_alloc(void *ctx, size_t size)
 {
-    KJSD_JSON_Value *new_value =
-        (KJSD_JSON_Value*)json_malloc(sizeof(KJSD_JSON_Value));
-    if (!new_value) return NULL;
+    (void)ctx;
+    return malloc(size);
+}
 
-    new_value->type = KJSD_JSON_STRING;
-    new_value->value.string = string;
-    return new_value;
+static void* json_libc_resize(void *ctx, void *ptr, size_t size)
+{
+    (void)ctx;
+    return realloc(ptr, size);
 }
 
-static KJSD_JSON_Value * json_value_init_number(double number)
+static void json_libc_release(void *ctx, void *ptr)
 {
-    KJSD_JSON_Value *new_value =
-        (KJSD_JSON_Value*)json_malloc(sizeof(KJSD_JSON_Value));
-    if (!new_value) return NULL;
+    (void)ctx;
+    free(ptr);
+}
 
-    new_value->type = KJSD_JSON_NUMBER;
-    new_value->value.number = number;
-    return new_value;
+/* Arena */
+static json_arena_chunk* json_arena_chunk_init(KJSD_JSON_Arena *arena,
+                                               size_t size)
+{
+    json_arena_chunk *chunk = (json_arena_chunk*)arena->allocator.alloc(
+        arena->allocator.ctx, ARENA_ALIGN(sizeof(json_arena_chunk)) + size);
+    if (!chunk) return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
 }
 
-static KJSD_JSON_Value * json_value_init_bool(int bool)
+static void json_arena_chunk_free(KJSD_JSON_Arena *arena,
+                                  json_arena_chunk *chunk)
 {
-    KJSD_JSON_Value *new_value =
-        (KJSD_JSON_Value*)json_malloc(sizeof(KJSD_JSON_Value));
-    if (!new_value) return NULL;
+    json_arena_chunk *next;
 
-    new_value->type = KJSD_JSON_BOOL;
-    new_value->value.bool = bool;
-    return new_value;
+    for (; chunk != NULL; chunk = next)
+    {
+        next = chunk->next;
+        arena->allocator.release(arena->allocator.ctx, chunk);
+    }
 }
 
-static KJSD_JSON_Value * json_value_init_null(void)
+static void json_arena_unmap(KJSD_JSON_Arena *arena)
 {
-    KJSD_JSON_Value *new_value =
-        (KJSD_JSON_Value*)json_malloc(sizeof(KJSD_JSON_Value));
-    if (!new_value) return NULL;
+#if defined(JSON_HAVE_MMAP)
+    json_arena_map *map;
 
-    new_value->type = KJSD_JSON_NULL;
-    return new_value;
+    /* The list itself lives in the arena chunks */
+    for (map = arena->maps; map != NULL; map = map->next)
+    {
+        munmap(map->addr, map->size);
+    }
+#endif
+    arena->maps = NULL;
 }
 
-/* Parser */
-static void skip_quotes(const char **string)
+static void* json_arena_alloc(KJSD_JSON_Arena *arena, size_t size)
 {
-    skip_char(string);
-    while (**string != '\"')
+    json_arena_chunk *chunk = arena->chunks;
+    void *ptr;
+
+    size = ARENA_ALIGN(size);
+    if (!chunk || (chunk->size - chunk->used < size))
     {
-        if (**string == '\0') return;
-        if (**string == '\\')
+        chunk = json_arena_chunk_init(arena, MAX(size, arena->chunk_size));
+        if (!chunk) return NULL;
+
+        if (arena->chunks && (size > arena->chunk_size / 4))
         {
-            skip_char(string);
-            if (**string == '\0') return;
+            /* Keep the room of the current chunk for following
+               small requests */
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+            chunk->used = size;
+            return arena_chunk_data(chunk);
         }
-        skip_char(string);
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
     }
-    skip_char(string);
+
+    ptr = arena_chunk_data(chunk) + chunk->used;
+    chunk->used += size;
+    arena->last = ptr;
+    return ptr;
 }
 
-/* Returns contents of a string inside double quotes and parses escaped
-   characters inside.
-   Example: "\u006Corem ipsum" -> lorem ipsum */
-static const char * get_processed_string(const char **string)
+static void* json_arena_realloc(KJSD_JSON_Arena *arena, void *ptr,
+                                size_t old_size, size_t new_size)
 {
-    const char *string_start = *string;
-    char *output, *processed_ptr, *unprocessed_ptr, current_char;
-    unsigned int utf_val;
+    json_arena_chunk *chunk = arena->chunks;
+    void *new_ptr;
 
-    skip_quotes(string);
-    if (**string == '\0') return NULL;
+    if (!ptr) return json_arena_alloc(arena, new_size);
 
-    output = json_strndup(string_start + 1, *string  - string_start - 2);
-    if (!output) return NULL;
-
-    processed_ptr = unprocessed_ptr = output;
-    while (*unprocessed_ptr)
+    old_size = ARENA_ALIGN(old_size);
+    new_size = ARENA_ALIGN(new_size);
+    if (ptr == arena->last)
     {
-        current_char = *unprocessed_ptr;
-        if (current_char == '\\')
-        {
-            unprocessed_ptr++;
-            current_char = *unprocessed_ptr;
-            switch (current_char)
-            {
-            case '\"': case '\\': case '/': break;
-            case 'b': current_char = '\b'; break;
-            case 'f': current_char = '\f'; break;
-            case 'n': current_char = '\n'; break;
-            case 'r': current_char = '\r'; break;
-            case 't': current_char = '\t'; break;
-            case 'u':
-                unprocessed_ptr++;
-                if (!is_utf((const unsigned char*)unprocessed_ptr) ||
-                    sscanf(unprocessed_ptr, "%4x", &utf_val) == EOF)
-                {
-                    json_free(output);
-                    return NULL;
-                }
-                if (utf_val < 0x80)
-                {
-                    current_char = utf_val;
-                }
-                else if (utf_val < 0x800)
-                {
-                    *processed_ptr++ = (utf_val >> 6) | 0xC0;
-                    current_char = ((utf_val | 0x80) & 0xBF);
-                }
-                else
-                {
-                    *processed_ptr++ = (utf_val >> 12) | 0xE0;
-                    *processed_ptr++ = (((utf_val >> 6) | 0x80) & 0xBF);
-                    current_char = ((utf_val | 0x80) & 0xBF);
-                }
-                unprocessed_ptr += 3;
-                break;
-            default:
-                json_free(output);
-                return NULL;
-                break;
-            }
-        }
-        else if ((unsigned char)current_char < 0x20)
+        /* The latest block can be grown or shrunk in place */
+        size_t offset = (char*)ptr - arena_chunk_data(chunk);
+        if (offset + new_size <= chunk->size)
         {
-            /* 0x00-0x19 are invalid characters for json string
-               (http://www.ietf.org/rfc/rfc4627.txt) */
-            json_free(output);
-            return NULL;
+            chunk->used = offset + new_size;
+            return ptr;
         }
-        *processed_ptr = current_char;
-        processed_ptr++;
-        unprocessed_ptr++;
     }
-    *processed_ptr = '\0';
-    if (try_realloc((void**)&output, strlen(output) + 1) == ERROR)
-        return NULL;
+    if (new_size <= old_size) return ptr;
 
-    return output;
+    new_ptr = json_arena_alloc(arena, new_size);
+    if (!new_ptr) return NULL;
+
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
 }
 
-static KJSD_JSON_Value * parse_value(const char **string,
-                                     size_t nesting)
+/* JSON Object */
+static KJSD_JSON_Object * json_object_init(KJSD_JSON_Arena *arena)
 {
-    if (nesting > MAX_NESTING) return NULL;
+    KJSD_JSON_Object *new_obj =
+        (KJSD_JSON_Object*)json_alloc(arena, sizeof(KJSD_JSON_Object));
+    if (!new_obj) return NULL;
 
-    skip_whitespaces(string);
-    switch (**string)
+    new_obj->arena = arena;
+    new_obj->names = (const char**)NULL;
+    new_obj->values = (KJSD_JSON_Value**)NULL;
+    new_obj->capacity = 0;
+    new_obj->count = 0;
+    new_obj->index = NULL;
+    new_obj->index_size = 0;
+    new_obj->lazy = NULL;
+    new_obj->blocks = NULL;
+    return new_obj;
+}
+
+static int json_object_add(KJSD_JSON_Object *object,
+                           const char *name, size_t n,
+                           KJSD_JSON_Value *value)
+{
+    const char *new_name = object->arena ?
+        json_intern_key(object->arena, &object->arena->keys, name, n):
+        json_key_new(NULL, name, n);
+
+    if (!new_name) return ERROR;
+
+    if (json_object_insert(object, new_name, n, value) == ERROR)
     {
-    case '{':
-        return parse_object_value(string, nesting + 1);
-    case '[':
-        return parse_array_value(string, nesting + 1);
-    case '\"':
-        return parse_string_value(string);
-    case 'f': case 't':
-        return parse_bool_value(string);
-    case '-':
-    case '0': case '1': case '2': case '3': case '4':
-    case '5': case '6': case '7': case '8': case '9':
-        return parse_number_value(string);
-    case 'n':
-        return parse_null_value(string);
-    default:
-        return NULL;
+        json_key_release(object->arena, new_name);
+        return ERROR;
     }
+    return SUCCESS;
+}
+
+/* Adds a member under a key interned in the table the other names of
+   object come from. The key is retained on success. */
+static int json_object_add_key(KJSD_JSON_Object *object,
+                               const char *key, size_t n,
+                               KJSD_JSON_Value *value)
+{
+    if (!json_object_load(object) ||
+        (json_object_find_key(object, key, n) != NOT_FOUND) ||
+        (json_object_append(object, key, value) == ERROR)) return ERROR;
+
+    json_key_retain(object->arena, key);
+    return SUCCESS;
+}
+
+/* Takes the ownership of name */
+static int json_object_insert(KJSD_JSON_Object *object,
+                              const char *name, size_t n,
+                              KJSD_JSON_Value *value)
+{
+    if (!json_object_load(object) ||
+        (json_object_nfind(object, name, n) != NOT_FOUND)) return ERROR;
+
+    return json_object_append(object, name, value);
 }
 
-static KJSD_JSON_Value * parse_object_value(const char **string,
-                                            size_t nesting)
+/* Takes the ownership of name, which must not be in object yet */
+static int json_object_append(KJSD_JSON_Object *object,
+                              const char *name, KJSD_JSON_Value *value)
 {
-    KJSD_JSON_Value* output_value = json_value_init_object();
-    KJSD_JSON_Value* new_value = NULL;
-    KJSD_JSON_Object* output_object =
-        KJSD_JSON_valueGetObject(output_value);
-    const char *new_key = NULL;
+    size_t index;
 
-    if (!output_value) return NULL;
+    if (object->count >= object->capacity)
+    {
+        size_t new_capacity =
+            json_grow_capacity(object->capacity, OBJECT_MAX_CAPACITY,
+                               sizeof(KJSD_JSON_Value*));
+        if (new_capacity == 0) return ERROR;
+        if (json_object_resize(object, new_capacity) == ERROR) 
+            return ERROR;
+    }
 
-    skip_char(string);
-    skip_whitespaces(string);
+    index = object->count;
+    object->names[index] = name;
+    object->values[index] = value;
+    object->count++;
 
-    if (**string == '}')
+    if (object->index && (object->count * 2 <= object->index_size))
     {
-        /* empty object */
-        skip_char(string);
-        return output_value;
+        json_object_index_insert(object, index);
     }
-    while (**string != '\0')
+    else if ((object->count >= OBJECT_INDEX_THRESHOLD) &&
+             (json_object_reindex(object,
+                                  MAX(object->index_size * 2,
+                                      OBJECT_INDEX_THRESHOLD * 4))
+              == ERROR))
     {
-        new_key = get_processed_string(string);
-        skip_whitespaces(string);
-        if (!new_key || **string != ':')
-        {
-            KJSD_JSON_free(output_value);
-            return NULL;
-        }
-        skip_char(string);
-        new_value = parse_value(string, nesting);
-        if (!new_value)
+        object->count--;
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+static int json_object_resize(KJSD_JSON_Object *object,
+                              size_t capacity)
+{
+    if (try_realloc(object->arena, (void**)&object->names,
+                    object->capacity * sizeof(char*),
+                    capacity * sizeof(char*)) == ERROR) return ERROR;
+    if (try_realloc(object->arena, (void**)&object->values,
+                    object->capacity * sizeof(KJSD_JSON_Value*),
+                    capacity * sizeof(KJSD_JSON_Value*)) == ERROR)
+        return ERROR;
+
+    object->capacity = capacity;
+    return SUCCESS;
+}
+
+static KJSD_JSON_Value* json_object_nget_value(
+    const KJSD_JSON_Object *object, const char *name, size_t n)
+{
+    size_t i = json_object_nfind(object, name, n);
+
+    return (i != NOT_FOUND) ? object->values[i]: NULL;
+}
+
+/* Returns the member slot of name or NOT_FOUND */
+static size_t json_object_nfind(const KJSD_JSON_Object *object,
+                                const char *name, size_t n)
+{
+    size_t i, mask, entry;
+
+    if ((object == NULL) || !json_object_load(object)) return NOT_FOUND;
+
+    if (object->index)
+    {
+        mask = object->index_size - 1;
+        for (i = json_hash(name, n) & mask;
+             (entry = object->index[i]) != 0;
+             i = (i + 1) & mask)
         {
-            json_free(new_key);
-            KJSD_JSON_free(output_value);
-            return NULL;
+            if (json_name_equals(object->names[entry - 1], name, n))
+            {
+                return entry - 1;
+            }
         }
-        if (!json_object_add(output_object, new_key, new_value))
+        return NOT_FOUND;
+    }
+
+    for (i = 0; i < object->count; i++)
+    {
+        if (json_name_equals(object->names[i], name, n)) return i;
+    }
+
+    return NOT_FOUND;
+}
+
+/* Interned names are equal only if they are the same */
+static size_t json_object_find_key(const KJSD_JSON_Object *object,
+                                   const char *key, size_t n)
+{
+    size_t i;
+
+    if (object->index) return json_object_nfind(object, key, n);
+
+    for (i = 0; i < object->count; i++)
+    {
+        if (object->names[i] == key) return i;
+    }
+    return NOT_FOUND;
+}
+
+/* index_size must be a power of two */
+static int json_object_reindex(KJSD_JSON_Object *object,
+                               size_t index_size)
+{
+    size_t i;
+    size_t *new_index =
+        (size_t*)json_alloc(object->arena, index_size * sizeof(size_t));
+    if (!new_index) return ERROR;
+
+    memset(new_index, 0, index_size * sizeof(size_t));
+    json_dealloc(object->arena, object->index);
+    object->index = new_index;
+    object->index_size = index_size;
+
+    for (i = 0; i < object->count; i++)
+    {
+        json_object_index_insert(object, i);
+    }
+    return SUCCESS;
+}
+
+static void json_object_index_insert(KJSD_JSON_Object *object,
+                                     size_t member)
+{
+    const char *name = object->names[member];
+    size_t mask = object->index_size - 1;
+    size_t i;
+
+    for (i = json_hash(name, strlen(name)) & mask;
+         object->index[i] != 0;
+         i = (i + 1) & mask);
+    object->index[i] = member + 1;
+}
+
+/* Returns the value of name turned into an empty one of type, or a new
+   member for it. The caller fills in the value. */
+static KJSD_JSON_Value* json_object_set(KJSD_JSON_Object *object,
+                                        const char *name,
+                                        KJSD_JSON_Type type)
+{
+    size_t n = strlen(name);
+    size_t i = json_object_nfind(object, name, n);
+    KJSD_JSON_Value *value;
+
+    if (i != NOT_FOUND)
+    {
+        value = object->values[i];
+        json_value_reuse(object->arena, value, type);
+        return value;
+    }
+
+    value = json_value_alloc(object->arena, type);
+    if (!value) return NULL;
+
+    if (json_object_add(object, name, n, value) == ERROR)
+    {
+        json_dealloc(object->arena, value);
+        return NULL;
+    }
+    return value;
+}
+
+static void json_object_free(KJSD_JSON_Object *object)
+{
+    while (object->count--)
+    {
+        json_key_release(NULL, object->names[object->count]);
+        KJSD_JSON_free(object->values[object->count]);
+    }
+    json_value_blocks_free(object->blocks);
+    json_free(object->names);
+    json_free(object->values);
+    json_free(object->index);
+    json_free(object);
+}
+
+/* JSON Array */
+static KJSD_JSON_Array * json_array_init(KJSD_JSON_Arena *arena) 
+{
+    KJSD_JSON_Array *new_array =
+        (KJSD_JSON_Array*)json_alloc(arena, sizeof(KJSD_JSON_Array));
+    if (!new_array) return NULL;
+
+    new_array->arena = arena;
+    new_array->items = (KJSD_JSON_Value**)NULL;
+    new_array->capacity = 0;
+    new_array->count = 0;
+    new_array->lazy = NULL;
+    new_array->blocks = NULL;
+    return new_array;
+}
+
+static int json_array_add(KJSD_JSON_Array *array,
+                          KJSD_JSON_Value *value)
+{
+    if (!json_array_load(array)) return ERROR;
+    if (array->count >= array->capacity)
+    {
+        size_t new_capacity =
+            json_grow_capacity(array->capacity, ARRAY_MAX_CAPACITY,
+                               sizeof(KJSD_JSON_Value*));
+        if (new_capacity == 0) return ERROR;
+        if (!json_array_resize(array, new_capacity)) return ERROR;
+    }
+
+    array->items[array->count] = value;
+    array->count++;
+    return SUCCESS;
+}
+
+static int json_array_resize(KJSD_JSON_Array *array, size_t capacity)
+{
+    if (try_realloc(array->arena, (void**)&array->items,
+                    array->capacity * sizeof(KJSD_JSON_Value*),
+                    capacity * sizeof(KJSD_JSON_Value*)) == ERROR)
+        return ERROR;
+
+    array->capacity = capacity;
+    return SUCCESS;
+}
+
+/* Returns the item turned into an empty value of type */
+static KJSD_JSON_Value* json_array_set(KJSD_JSON_Array *array,
+                                       size_t index, KJSD_JSON_Type type)
+{
+    KJSD_JSON_Value *value;
+
+    if (!json_array_load(array) || (index >= array->count)) return NULL;
+
+    value = array->items[index];
+    json_value_reuse(array->arena, value, type);
+    return value;
+}
+
+/* Returns a new item of type put before index. The caller fills in the
+   value. */
+static KJSD_JSON_Value* json_array_insert(KJSD_JSON_Array *array,
+                                          size_t index,
+                                          KJSD_JSON_Type type)
+{
+    KJSD_JSON_Value *value;
+
+    if (!json_array_load(array) || (index > array->count)) return NULL;
+
+    value = json_value_alloc(array->arena, type);
+    if (!value) return NULL;
+
+    if (json_array_add(array, value) == ERROR)
+    {
+        json_dealloc(array->arena, value);
+        return NULL;
+    }
+    memmove(array->items + index + 1, array->items + index,
+            (array->count - 1 - index) * sizeof(KJSD_JSON_Value*));
+    array->items[index] = value;
+    return value;
+}
+
+static void json_array_free(KJSD_JSON_Array *array)
+{
+    while (array->count--)
+    {
+        KJSD_JSON_free(array->items[array->count]);
+    }
+    json_value_blocks_free(array->blocks);
+    json_free(array->items);
+    json_free(array);
+}
+
+/* JSON Value */
+static KJSD_JSON_Value* json_value_alloc(KJSD_JSON_Arena *arena,
+                                         KJSD_JSON_Type type)
+{
+    KJSD_JSON_Value* new_value =
+        (KJSD_JSON_Value*)json_alloc(arena, sizeof(KJSD_JSON_Value));
+    if (!new_value) return NULL;
+
+    new_value->type = type;
+    new_value->is_integer = 0;
+    new_value->is_inline = 0;
+    return new_value;
+}
+
+/* Releases what value holds, keeping the value itself in its slot */
+static void json_value_reuse(KJSD_JSON_Arena *arena,
+                             KJSD_JSON_Value *value, KJSD_JSON_Type type)
+{
+    if (!arena)
+    {
+        switch (value->type)
         {
-            json_free(new_key);
-            json_free(new_value);
-            KJSD_JSON_free(output_value);
-            return NULL;
+        case KJSD_JSON_OBJECT:
+            json_object_free(value->value.object);
+            break;
+        case KJSD_JSON_ARRAY:
+            json_array_free(value->value.array);
+            break;
+        case KJSD_JSON_STRING:
+            json_free(value->value.string);
+            break;
+        default:
+            break;
         }
-        json_free(new_key);
-        skip_whitespaces(string);
-        if (**string != ',') break;
+    }
+    value->type = type;
+    value->is_integer = 0;
+}
+
+static KJSD_JSON_Value* json_value_init_object(KJSD_JSON_Arena *arena)
+{
+    KJSD_JSON_Value* new_value = json_value_alloc(arena, KJSD_JSON_OBJECT);
+    if (!new_value) return NULL;
+
+    new_value->value.object = json_object_init(arena);
 
-        skip_char(string);
-        skip_whitespaces(string);
+    if (!new_value->value.object)
+    {
+        json_dealloc(arena, new_value);
+        return NULL;
     }
-    skip_whitespaces(string);
-    if ((**string != '}') ||
-        json_object_resize(output_object,
-                           KJSD_JSON_objectGetCount(output_object))
-        == ERROR)
+    return new_value;
+}
+
+static KJSD_JSON_Value * json_value_init_array(KJSD_JSON_Arena *arena)
+{
+    KJSD_JSON_Value *new_value = json_value_alloc(arena, KJSD_JSON_ARRAY);
+    if (!new_value) return NULL;
+
+    new_value->value.array = json_array_init(arena);
+
+    if (!new_value->value.array)
     {
-        /* Trim object after parsing is over */
-        KJSD_JSON_free(output_value);
+        json_dealloc(arena, new_value);
         return NULL;
     }
+    return new_value;
+}
+
+static KJSD_JSON_Value * json_value_init_string(KJSD_JSON_Arena *arena,
+                                                const char *string)
+{
+    KJSD_JSON_Value *new_value = json_value_alloc(arena, KJSD_JSON_STRING);
+    if (!new_value) return NULL;
+
+    new_value->value.string = string;
+    return new_value;
+}
+
+static KJSD_JSON_Value * json_value_init_number(KJSD_JSON_Arena *arena,
+                                                double number)
+{
+    KJSD_JSON_Value *new_value = json_value_alloc(arena, KJSD_JSON_NUMBER);
+    if (!new_value) return NULL;
+
+    new_value->value.number = number;
+    return new_value;
+}
+
+static KJSD_JSON_Value * json_value_init_integer(KJSD_JSON_Arena *arena,
+                                                 int64_t integer)
+{
+    KJSD_JSON_Value *new_value = json_value_alloc(arena, KJSD_JSON_NUMBER);
+    if (!new_value) return NULL;
+
+    new_value->is_integer = 1;
+    new_value->value.integer = integer;
+    return new_value;
+}
+
+static KJSD_JSON_Value * json_value_init_bool(KJSD_JSON_Arena *arena,
+                                              int bool)
+{
+    KJSD_JSON_Value *new_value = json_value_alloc(arena, KJSD_JSON_BOOL);
+    if (!new_value) return NULL;
+
+    new_value->value.bool = bool;
+    return new_value;
+}
+
+static KJSD_JSON_Value * json_value_init_null(KJSD_JSON_Arena *arena)
+{
+    return json_value_alloc(arena, KJSD_JSON_NULL);
+}
+
+static void json_value_free(KJSD_JSON_Arena *arena,
+                            KJSD_JSON_Value *value)
+{
+    if (!arena) KJSD_JSON_free(value);
+}
+
+static void json_value_blocks_free(json_value_block *block)
+{
+    while (block)
+    {
+        json_value_block *next = block->next;
+        json_free(block);
+        block = next;
+    }
+}
+
+/* 10^(-348 + 8 * i) as normalized 64-bit significands and binary
+   exponents, for the double formatting (Grisu2) */
+static const uint64_t json_cached_pow10_f[] = {
+    UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76),
+    UINT64_C(0x8b16fb203055ac76), UINT64_C(0xcf42894a5dce35ea),
+    UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+    UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f),
+    UINT64_C(0xbe5691ef416bd60c), UINT64_C(0x8dd01fad907ffc3c),
+    UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+    UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d),
+    UINT64_C(0x823c12795db6ce57), UINT64_C(0xc21094364dfb5637),
+    UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+    UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5),
+    UINT64_C(0xb23867fb2a35b28e), UINT64_C(0x84c8d4dfd2c63f3b),
+    UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+    UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6),
+    UINT64_C(0xf3e2f893dec3f126), UINT64_C(0xb5b5ada8aaff80b8),
+    UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+    UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd),
+    UINT64_C(0xa6dfbd9fb8e5b88f), UINT64_C(0xf8a95fcf88747d94),
+    UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+    UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac),
+    UINT64_C(0xe45c10c42a2b3b06), UINT64_C(0xaa242499697392d3),
+    UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+    UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c),
+    UINT64_C(0x9c40000000000000), UINT64_C(0xe8d4a51000000000),
+    UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+    UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70),
+    UINT64_C(0xd5d238a4abe98068), UINT64_C(0x9f4f2726179a2245),
+    UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+    UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a),
+    UINT64_C(0x924d692ca61be758), UINT64_C(0xda01ee641a708dea),
+    UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+    UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2),
+    UINT64_C(0xc83553c5c8965d3d), UINT64_C(0x952ab45cfa97a0b3),
+    UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+    UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece),
+    UINT64_C(0x88fcf317f22241e2), UINT64_C(0xcc20ce9bd35c78a5),
+    UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+    UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c),
+    UINT64_C(0xbb764c4ca7a44410), UINT64_C(0x8bab8eefb6409c1a),
+    UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+    UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429),
+    UINT64_C(0x80444b5e7aa7cf85), UINT64_C(0xbf21e44003acdd2d),
+    UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+    UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9),
+    UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+static const short json_cached_pow10_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+/* 5^q for q in [JSON_POW5_MIN, JSON_POW5_MAX] as 128-bit values
+   normalized to the highest bit (high and low words), for the
+   decimal to double conversion (Eisel-Lemire) */
+static const uint64_t json_pow5_128[][2] = {
+    { UINT64_C(0xeef453d6923bd65a), UINT64_C(0x113faa2906a13b3f) },
+    { UINT64_C(0x9558b4661b6565f8), UINT64_C(0x4ac7ca59a424c507) },
+    { UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x5d79bcf00d2df649) },
+    { UINT64_C(0xe95a99df8ace6f53), UINT64_C(0xf4d82c2c107973dc) },
+    { UINT64_C(0x91d8a02bb6c10594), UINT64_C(0x79071b9b8a4be869) },
+    { UINT64_C(0xb64ec836a47146f9), UINT64_C(0x9748e2826cdee284) },
+    { UINT64_C(0xe3e27a444d8d98b7), UINT64_C(0xfd1b1b2308169b25) },
+    { UINT64_C(0x8e6d8c6ab0787f72), UINT64_C(0xfe30f0f5e50e20f7) },
+    { UINT64_C(0xb208ef855c969f4f), UINT64_C(0xbdbd2d335e51a935) },
+    { UINT64_C(0xde8b2b66b3bc4723), UINT64_C(0xad2c788035e61382) },
+    { UINT64_C(0x8b16fb203055ac76), UINT64_C(0x4c3bcb5021afcc31) },
+    { UINT64_C(0xaddcb9e83c6b1793), UINT64_C(0xdf4abe242a1bbf3d) },
+    { UINT64_C(0xd953e8624b85dd78), UINT64_C(0xd71d6dad34a2af0d) },
+    { UINT64_C(0x87d4713d6f33aa6b), UINT64_C(0x8672648c40e5ad68) },
+    { UINT64_C(0xa9c98d8ccb009506), UINT64_C(0x680efdaf511f18c2) },
+    { UINT64_C(0xd43bf0effdc0ba48), UINT64_C(0x0212bd1b2566def2) },
+    { UINT64_C(0x84a57695fe98746d), UINT64_C(0x014bb630f7604b57) },
+    { UINT64_C(0xa5ced43b7e3e9188), UINT64_C(0x419ea3bd35385e2d) },
+    { UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x52064cac828675b9) },
+    { UINT64_C(0x818995ce7aa0e1b2), UINT64_C(0x7343efebd1940993) },
+    { UINT64_C(0xa1ebfb4219491a1f), UINT64_C(0x1014ebe6c5f90bf8) },
+    { UINT64_C(0xca66fa129f9b60a6), UINT64_C(0xd41a26e077774ef6) },
+    { UINT64_C(0xfd00b897478238d0), UINT64_C(0x8920b098955522b4) },
+    { UINT64_C(0x9e20735e8cb16382), UINT64_C(0x55b46e5f5d5535b0) },
+    { UINT64_C(0xc5a890362fddbc62), UINT64_C(0xeb2189f734aa831d) },
+    { UINT64_C(0xf712b443bbd52b7b), UINT64_C(0xa5e9ec7501d523e4) },
+    { UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0x47b233c92125366e) },
+    { UINT64_C(0xc1069cd4eabe89f8), UINT64_C(0x999ec0bb696e840a) },
+    { UINT64_C(0xf148440a256e2c76), UINT64_C(0xc00670ea43ca250d) },
+    { UINT64_C(0x96cd2a865764dbca), UINT64_C(0x380406926a5e5728) },
+    { UINT64_C(0xbc807527ed3e12bc), UINT64_C(0xc605083704f5ecf2) },
+    { UINT64_C(0xeba09271e88d976b), UINT64_C(0xf7864a44c633682e) },
+    { UINT64_C(0x93445b8731587ea3), UINT64_C(0x7ab3ee6afbe0211d) },
+    { UINT64_C(0xb8157268fdae9e4c), UINT64_C(0x5960ea05bad82964) },
+    { UINT64_C(0xe61acf033d1a45df), UINT64_C(0x6fb92487298e33bd) },
+    { UINT64_C(0x8fd0c16206306bab), UINT64_C(0xa5d3b6d479f8e056) },
+    { UINT64_C(0xb3c4f1ba87bc8696), UINT64_C(0x8f48a4899877186c) },
+    { UINT64_C(0xe0b62e2929aba83c), UINT64_C(0x331acdabfe94de87) },
+    { UINT64_C(0x8c71dcd9ba0b4925), UINT64_C(0x9ff0c08b7f1d0b14) },
+    { UINT64_C(0xaf8e5410288e1b6f), UINT64_C(0x07ecf0ae5ee44dd9) },
+    { UINT64_C(0xdb71e91432b1a24a), UINT64_C(0xc9e82cd9f69d6150) },
+    { UINT64_C(0x892731ac9faf056e), UINT64_C(0xbe311c083a225cd2) },
+    { UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0x6dbd630a48aaf406) },
+    { UINT64_C(0xd64d3d9db981787d), UINT64_C(0x092cbbccdad5b108) },
+    { UINT64_C(0x85f0468293f0eb4e), UINT64_C(0x25bbf56008c58ea5) },
+    { UINT64_C(0xa76c582338ed2621), UINT64_C(0xaf2af2b80af6f24e) },
+    { UINT64_C(0xd1476e2c07286faa), UINT64_C(0x1af5af660db4aee1) },
+    { UINT64_C(0x82cca4db847945ca), UINT64_C(0x50d98d9fc890ed4d) },
+    { UINT64_C(0xa37fce126597973c), UINT64_C(0xe50ff107bab528a0) },
+    { UINT64_C(0xcc5fc196fefd7d0c), UINT64_C(0x1e53ed49a96272c8) },
+    { UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0x25e8e89c13bb0f7a) },
+    { UINT64_C(0x9faacf3df73609b1), UINT64_C(0x77b191618c54e9ac) },
+    { UINT64_C(0xc795830d75038c1d), UINT64_C(0xd59df5b9ef6a2417) },
+    { UINT64_C(0xf97ae3d0d2446f25), UINT64_C(0x4b0573286b44ad1d) },
+    { UINT64_C(0x9becce62836ac577), UINT64_C(0x4ee367f9430aec32) },
+    { UINT64_C(0xc2e801fb244576d5), UINT64_C(0x229c41f793cda73f) },
+    { UINT64_C(0xf3a20279ed56d48a), UINT64_C(0x6b43527578c1110f) },
+    { UINT64_C(0x9845418c345644d6), UINT64_C(0x830a13896b78aaa9) },
+    { UINT64_C(0xbe5691ef416bd60c), UINT64_C(0x23cc986bc656d553) },
+    { UINT64_C(0xedec366b11c6cb8f), UINT64_C(0x2cbfbe86b7ec8aa8) },
+    { UINT64_C(0x94b3a202eb1c3f39), UINT64_C(0x7bf7d71432f3d6a9) },
+    { UINT64_C(0xb9e08a83a5e34f07), UINT64_C(0xdaf5ccd93fb0cc53) },
+    { UINT64_C(0xe858ad248f5c22c9), UINT64_C(0xd1b3400f8f9cff68) },
+    { UINT64_C(0x91376c36d99995be), UINT64_C(0x23100809b9c21fa1) },
+    { UINT64_C(0xb58547448ffffb2d), UINT64_C(0xabd40a0c2832a78a) },
+    { UINT64_C(0xe2e69915b3fff9f9), UINT64_C(0x16c90c8f323f516c) },
+    { UINT64_C(0x8dd01fad907ffc3b), UINT64_C(0xae3da7d97f6792e3) },
+    { UINT64_C(0xb1442798f49ffb4a), UINT64_C(0x99cd11cfdf41779c) },
+    { UINT64_C(0xdd95317f31c7fa1d), UINT64_C(0x40405643d711d583) },
+    { UINT64_C(0x8a7d3eef7f1cfc52), UINT64_C(0x482835ea666b2572) },
+    { UINT64_C(0xad1c8eab5ee43b66), UINT64_C(0xda3243650005eecf) },
+    { UINT64_C(0xd863b256369d4a40), UINT64_C(0x90bed43e40076a82) },
+    { UINT64_C(0x873e4f75e2224e68), UINT64_C(0x5a7744a6e804a291) },
+    { UINT64_C(0xa90de3535aaae202), UINT64_C(0x711515d0a205cb36) },
+    { UINT64_C(0xd3515c2831559a83), UINT64_C(0x0d5a5b44ca873e03) },
+    { UINT64_C(0x8412d9991ed58091), UINT64_C(0xe858790afe9486c2) },
+    { UINT64_C(0xa5178fff668ae0b6), UINT64_C(0x626e974dbe39a872) },
+    { UINT64_C(0xce5d73ff402d98e3), UINT64_C(0xfb0a3d212dc8128f) },
+    { UINT64_C(0x80fa687f881c7f8e), UINT64_C(0x7ce66634bc9d0b99) },
+    { UINT64_C(0xa139029f6a239f72), UINT64_C(0x1c1fffc1ebc44e80) },
+    { UINT64_C(0xc987434744ac874e), UINT64_C(0xa327ffb266b56220) },
+    { UINT64_C(0xfbe9141915d7a922), UINT64_C(0x4bf1ff9f0062baa8) },
+    { UINT64_C(0x9d71ac8fada6c9b5), UINT64_C(0x6f773fc3603db4a9) },
+    { UINT64_C(0xc4ce17b399107c22), UINT64_C(0xcb550fb4384d21d3) },
+    { UINT64_C(0xf6019da07f549b2b), UINT64_C(0x7e2a53a146606a48) },
+    { UINT64_C(0x99c102844f94e0fb), UINT64_C(0x2eda7444cbfc426d) },
+    { UINT64_C(0xc0314325637a1939), UINT64_C(0xfa911155fefb5308) },
+    { UINT64_C(0xf03d93eebc589f88), UINT64_C(0x793555ab7eba27ca) },
+    { UINT64_C(0x96267c7535b763b5), UINT64_C(0x4bc1558b2f3458de) },
+    { UINT64_C(0xbbb01b9283253ca2), UINT64_C(0x9eb1aaedfb016f16) },
+    { UINT64_C(0xea9c227723ee8bcb), UINT64_C(0x465e15a979c1cadc) },
+    { UINT64_C(0x92a1958a7675175f), UINT64_C(0x0bfacd89ec191ec9) },
+    { UINT64_C(0xb749faed14125d36), UINT64_C(0xcef980ec671f667b) },
+    { UINT64_C(0xe51c79a85916f484), UINT64_C(0x82b7e12780e7401a) },
+    { UINT64_C(0x8f31cc0937ae58d2), UINT64_C(0xd1b2ecb8b0908810) },
+    { UINT64_C(0xb2fe3f0b8599ef07), UINT64_C(0x861fa7e6dcb4aa15) },
+    { UINT64_C(0xdfbdcece67006ac9), UINT64_C(0x67a791e093e1d49a) },
+    { UINT64_C(0x8bd6a141006042bd), UINT64_C(0xe0c8bb2c5c6d24e0) },
+    { UINT64_C(0xaecc49914078536d), UINT64_C(0x58fae9f773886e18) },
+    { UINT64_C(0xda7f5bf590966848), UINT64_C(0xaf39a475506a899e) },
+    { UINT64_C(0x888f99797a5e012d), UINT64_C(0x6d8406c952429603) },
+    { UINT64_C(0xaab37fd7d8f58178), UINT64_C(0xc8e5087ba6d33b83) },
+    { UINT64_C(0xd5605fcdcf32e1d6), UINT64_C(0xfb1e4a9a90880a64) },
+    { UINT64_C(0x855c3be0a17fcd26), UINT64_C(0x5cf2eea09a55067f) },
+    { UINT64_C(0xa6b34ad8c9dfc06f), UINT64_C(0xf42faa48c0ea481e) },
+    { UINT64_C(0xd0601d8efc57b08b), UINT64_C(0xf13b94daf124da26) },
+    { UINT64_C(0x823c12795db6ce57), UINT64_C(0x76c53d08d6b70858) },
+    { UINT64_C(0xa2cb1717b52481ed), UINT64_C(0x54768c4b0c64ca6e) },
+    { UINT64_C(0xcb7ddcdda26da268), UINT64_C(0xa9942f5dcf7dfd09) },
+    { UINT64_C(0xfe5d54150b090b02), UINT64_C(0xd3f93b35435d7c4c) },
+    { UINT64_C(0x9efa548d26e5a6e1), UINT64_C(0xc47bc5014a1a6daf) },
+    { UINT64_C(0xc6b8e9b0709f109a), UINT64_C(0x359ab6419ca1091b) },
+    { UINT64_C(0xf867241c8cc6d4c0), UINT64_C(0xc30163d203c94b62) },
+    { UINT64_C(0x9b407691d7fc44f8), UINT64_C(0x79e0de63425dcf1d) },
+    { UINT64_C(0xc21094364dfb5636), UINT64_C(0x985915fc12f542e4) },
+    { UINT64_C(0xf294b943e17a2bc4), UINT64_C(0x3e6f5b7b17b2939d) },
+    { UINT64_C(0x979cf3ca6cec5b5a), UINT64_C(0xa705992ceecf9c42) },
+    { UINT64_C(0xbd8430bd08277231), UINT64_C(0x50c6ff782a838353) },
+    { UINT64_C(0xece53cec4a314ebd), UINT64_C(0xa4f8bf5635246428) },
+    { UINT64_C(0x940f4613ae5ed136), UINT64_C(0x871b7795e136be99) },
+    { UINT64_C(0xb913179899f68584), UINT64_C(0x28e2557b59846e3f) },
+    { UINT64_C(0xe757dd7ec07426e5), UINT64_C(0x331aeada2fe589cf) },
+    { UINT64_C(0x9096ea6f3848984f), UINT64_C(0x3ff0d2c85def7621) },
+    { UINT64_C(0xb4bca50b065abe63), UINT64_C(0x0fed077a756b53a9) },
+    { UINT64_C(0xe1ebce4dc7f16dfb), UINT64_C(0xd3e8495912c62894) },
+    { UINT64_C(0x8d3360f09cf6e4bd), UINT64_C(0x64712dd7abbbd95c) },
+    { UINT64_C(0xb080392cc4349dec), UINT64_C(0xbd8d794d96aacfb3) },
+    { UINT64_C(0xdca04777f541c567), UINT64_C(0xecf0d7a0fc5583a0) },
+    { UINT64_C(0x89e42caaf9491b60), UINT64_C(0xf41686c49db57244) },
+    { UINT64_C(0xac5d37d5b79b6239), UINT64_C(0x311c2875c522ced5) },
+    { UINT64_C(0xd77485cb25823ac7), UINT64_C(0x7d633293366b828b) },
+    { UINT64_C(0x86a8d39ef77164bc), UINT64_C(0xae5dff9c02033197) },
+    { UINT64_C(0xa8530886b54dbdeb), UINT64_C(0xd9f57f830283fdfc) },
+    { UINT64_C(0xd267caa862a12d66), UINT64_C(0xd072df63c324fd7b) },
+    { UINT64_C(0x8380dea93da4bc60), UINT64_C(0x4247cb9e59f71e6d) },
+    { UINT64_C(0xa46116538d0deb78), UINT64_C(0x52d9be85f074e608) },
+    { UINT64_C(0xcd795be870516656), UINT64_C(0x67902e276c921f8b) },
+    { UINT64_C(0x806bd9714632dff6), UINT64_C(0x00ba1cd8a3db53b6) },
+    { UINT64_C(0xa086cfcd97bf97f3), UINT64_C(0x80e8a40eccd228a4) },
+    { UINT64_C(0xc8a883c0fdaf7df0), UINT64_C(0x6122cd128006b2cd) },
+    { UINT64_C(0xfad2a4b13d1b5d6c), UINT64_C(0x796b805720085f81) },
+    { UINT64_C(0x9cc3a6eec6311a63), UINT64_C(0xcbe3303674053bb0) },
+    { UINT64_C(0xc3f490aa77bd60fc), UINT64_C(0xbedbfc4411068a9c) },
+    { UINT64_C(0xf4f1b4d515acb93b), UINT64_C(0xee92fb5515482d44) },
+    { UINT64_C(0x991711052d8bf3c5), UINT64_C(0x751bdd152d4d1c4a) },
+    { UINT64_C(0xbf5cd54678eef0b6), UINT64_C(0xd262d45a78a0635d) },
+    { UINT64_C(0xef340a98172aace4), UINT64_C(0x86fb897116c87c34) },
+    { UINT64_C(0x9580869f0e7aac0e), UINT64_C(0xd45d35e6ae3d4da0) },
+    { UINT64_C(0xbae0a846d2195712), UINT64_C(0x8974836059cca109) },
+    { UINT64_C(0xe998d258869facd7), UINT64_C(0x2bd1a438703fc94b) },
+    { UINT64_C(0x91ff83775423cc06), UINT64_C(0x7b6306a34627ddcf) },
+    { UINT64_C(0xb67f6455292cbf08), UINT64_C(0x1a3bc84c17b1d542) },
+    { UINT64_C(0xe41f3d6a7377eeca), UINT64_C(0x20caba5f1d9e4a93) },
+    { UINT64_C(0x8e938662882af53e), UINT64_C(0x547eb47b7282ee9c) },
+    { UINT64_C(0xb23867fb2a35b28d), UINT64_C(0xe99e619a4f23aa43) },
+    { UINT64_C(0xdec681f9f4c31f31), UINT64_C(0x6405fa00e2ec94d4) },
+    { UINT64_C(0x8b3c113c38f9f37e), UINT64_C(0xde83bc408dd3dd04) },
+    { UINT64_C(0xae0b158b4738705e), UINT64_C(0x9624ab50b148d445) },
+    { UINT64_C(0xd98ddaee19068c76), UINT64_C(0x3badd624dd9b0957) },
+    { UINT64_C(0x87f8a8d4cfa417c9), UINT64_C(0xe54ca5d70a80e5d6) },
+    { UINT64_C(0xa9f6d30a038d1dbc), UINT64_C(0x5e9fcf4ccd211f4c) },
+    { UINT64_C(0xd47487cc8470652b), UINT64_C(0x7647c3200069671f) },
+    { UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0x29ecd9f40041e073) },
+    { UINT64_C(0xa5fb0a17c777cf09), UINT64_C(0xf468107100525890) },
+    { UINT64_C(0xcf79cc9db955c2cc), UINT64_C(0x7182148d4066eeb4) },
+    { UINT64_C(0x81ac1fe293d599bf), UINT64_C(0xc6f14cd848405530) },
+    { UINT64_C(0xa21727db38cb002f), UINT64_C(0xb8ada00e5a506a7c) },
+    { UINT64_C(0xca9cf1d206fdc03b), UINT64_C(0xa6d90811f0e4851c) },
+    { UINT64_C(0xfd442e4688bd304a), UINT64_C(0x908f4a166d1da663) },
+    { UINT64_C(0x9e4a9cec15763e2e), UINT64_C(0x9a598e4e043287fe) },
+    { UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x40eff1e1853f29fd) },
+    { UINT64_C(0xf7549530e188c128), UINT64_C(0xd12bee59e68ef47c) },
+    { UINT64_C(0x9a94dd3e8cf578b9), UINT64_C(0x82bb74f8301958ce) },
+    { UINT64_C(0xc13a148e3032d6e7), UINT64_C(0xe36a52363c1faf01) },
+    { UINT64_C(0xf18899b1bc3f8ca1), UINT64_C(0xdc44e6c3cb279ac1) },
+    { UINT64_C(0x96f5600f15a7b7e5), UINT64_C(0x29ab103a5ef8c0b9) },
+    { UINT64_C(0xbcb2b812db11a5de), UINT64_C(0x7415d448f6b6f0e7) },
+    { UINT64_C(0xebdf661791d60f56), UINT64_C(0x111b495b3464ad21) },
+    { UINT64_C(0x936b9fcebb25c995), UINT64_C(0xcab10dd900beec34) },
+    { UINT64_C(0xb84687c269ef3bfb), UINT64_C(0x3d5d514f40eea742) },
+    { UINT64_C(0xe65829b3046b0afa), UINT64_C(0x0cb4a5a3112a5112) },
+    { UINT64_C(0x8ff71a0fe2c2e6dc), UINT64_C(0x47f0e785eaba72ab) },
+    { UINT64_C(0xb3f4e093db73a093), UINT64_C(0x59ed216765690f56) },
+    { UINT64_C(0xe0f218b8d25088b8), UINT64_C(0x306869c13ec3532c) },
+    { UINT64_C(0x8c974f7383725573), UINT64_C(0x1e414218c73a13fb) },
+    { UINT64_C(0xafbd2350644eeacf), UINT64_C(0xe5d1929ef90898fa) },
+    { UINT64_C(0xdbac6c247d62a583), UINT64_C(0xdf45f746b74abf39) },
+    { UINT64_C(0x894bc396ce5da772), UINT64_C(0x6b8bba8c328eb783) },
+    { UINT64_C(0xab9eb47c81f5114f), UINT64_C(0x066ea92f3f326564) },
+    { UINT64_C(0xd686619ba27255a2), UINT64_C(0xc80a537b0efefebd) },
+    { UINT64_C(0x8613fd0145877585), UINT64_C(0xbd06742ce95f5f36) },
+    { UINT64_C(0xa798fc4196e952e7), UINT64_C(0x2c48113823b73704) },
+    { UINT64_C(0xd17f3b51fca3a7a0), UINT64_C(0xf75a15862ca504c5) },
+    { UINT64_C(0x82ef85133de648c4), UINT64_C(0x9a984d73dbe722fb) },
+    { UINT64_C(0xa3ab66580d5fdaf5), UINT64_C(0xc13e60d0d2e0ebba) },
+    { UINT64_C(0xcc963fee10b7d1b3), UINT64_C(0x318df905079926a8) },
+    { UINT64_C(0xffbbcfe994e5c61f), UINT64_C(0xfdf17746497f7052) },
+    { UINT64_C(0x9fd561f1fd0f9bd3), UINT64_C(0xfeb6ea8bedefa633) },
+    { UINT64_C(0xc7caba6e7c5382c8), UINT64_C(0xfe64a52ee96b8fc0) },
+    { UINT64_C(0xf9bd690a1b68637b), UINT64_C(0x3dfdce7aa3c673b0) },
+    { UINT64_C(0x9c1661a651213e2d), UINT64_C(0x06bea10ca65c084e) },
+    { UINT64_C(0xc31bfa0fe5698db8), UINT64_C(0x486e494fcff30a62) },
+    { UINT64_C(0xf3e2f893dec3f126), UINT64_C(0x5a89dba3c3efccfa) },
+    { UINT64_C(0x986ddb5c6b3a76b7), UINT64_C(0xf89629465a75e01c) },
+    { UINT64_C(0xbe89523386091465), UINT64_C(0xf6bbb397f1135823) },
+    { UINT64_C(0xee2ba6c0678b597f), UINT64_C(0x746aa07ded582e2c) },
+    { UINT64_C(0x94db483840b717ef), UINT64_C(0xa8c2a44eb4571cdc) },
+    { UINT64_C(0xba121a4650e4ddeb), UINT64_C(0x92f34d62616ce413) },
+    { UINT64_C(0xe896a0d7e51e1566), UINT64_C(0x77b020baf9c81d17) },
+    { UINT64_C(0x915e2486ef32cd60), UINT64_C(0x0ace1474dc1d122e) },
+    { UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x0d819992132456ba) },
+    { UINT64_C(0xe3231912d5bf60e6), UINT64_C(0x10e1fff697ed6c69) },
+    { UINT64_C(0x8df5efabc5979c8f), UINT64_C(0xca8d3ffa1ef463c1) },
+    { UINT64_C(0xb1736b96b6fd83b3), UINT64_C(0xbd308ff8a6b17cb2) },
+    { UINT64_C(0xddd0467c64bce4a0), UINT64_C(0xac7cb3f6d05ddbde) },
+    { UINT64_C(0x8aa22c0dbef60ee4), UINT64_C(0x6bcdf07a423aa96b) },
+    { UINT64_C(0xad4ab7112eb3929d), UINT64_C(0x86c16c98d2c953c6) },
+    { UINT64_C(0xd89d64d57a607744), UINT64_C(0xe871c7bf077ba8b7) },
+    { UINT64_C(0x87625f056c7c4a8b), UINT64_C(0x11471cd764ad4972) },
+    { UINT64_C(0xa93af6c6c79b5d2d), UINT64_C(0xd598e40d3dd89bcf) },
+    { UINT64_C(0xd389b47879823479), UINT64_C(0x4aff1d108d4ec2c3) },
+    { UINT64_C(0x843610cb4bf160cb), UINT64_C(0xcedf722a585139ba) },
+    { UINT64_C(0xa54394fe1eedb8fe), UINT64_C(0xc2974eb4ee658828) },
+    { UINT64_C(0xce947a3da6a9273e), UINT64_C(0x733d226229feea32) },
+    { UINT64_C(0x811ccc668829b887), UINT64_C(0x0806357d5a3f525f) },
+    { UINT64_C(0xa163ff802a3426a8), UINT64_C(0xca07c2dcb0cf26f7) },
+    { UINT64_C(0xc9bcff6034c13052), UINT64_C(0xfc89b393dd02f0b5) },
+    { UINT64_C(0xfc2c3f3841f17c67), UINT64_C(0xbbac2078d443ace2) },
+    { UINT64_C(0x9d9ba7832936edc0), UINT64_C(0xd54b944b84aa4c0d) },
+    { UINT64_C(0xc5029163f384a931), UINT64_C(0x0a9e795e65d4df11) },
+    { UINT64_C(0xf64335bcf065d37d), UINT64_C(0x4d4617b5ff4a16d5) },
+    { UINT64_C(0x99ea0196163fa42e), UINT64_C(0x504bced1bf8e4e45) },
+    { UINT64_C(0xc06481fb9bcf8d39), UINT64_C(0xe45ec2862f71e1d6) },
+    { UINT64_C(0xf07da27a82c37088), UINT64_C(0x5d767327bb4e5a4c) },
+    { UINT64_C(0x964e858c91ba2655), UINT64_C(0x3a6a07f8d510f86f) },
+    { UINT64_C(0xbbe226efb628afea), UINT64_C(0x890489f70a55368b) },
+    { UINT64_C(0xeadab0aba3b2dbe5), UINT64_C(0x2b45ac74ccea842e) },
+    { UINT64_C(0x92c8ae6b464fc96f), UINT64_C(0x3b0b8bc90012929d) },
+    { UINT64_C(0xb77ada0617e3bbcb), UINT64_C(0x09ce6ebb40173744) },
+    { UINT64_C(0xe55990879ddcaabd), UINT64_C(0xcc420a6a101d0515) },
+    { UINT64_C(0x8f57fa54c2a9eab6), UINT64_C(0x9fa946824a12232d) },
+    { UINT64_C(0xb32df8e9f3546564), UINT64_C(0x47939822dc96abf9) },
+    { UINT64_C(0xdff9772470297ebd), UINT64_C(0x59787e2b93bc56f7) },
+    { UINT64_C(0x8bfbea76c619ef36), UINT64_C(0x57eb4edb3c55b65a) },
+    { UINT64_C(0xaefae51477a06b03), UINT64_C(0xede622920b6b23f1) },
+    { UINT64_C(0xdab99e59958885c4), UINT64_C(0xe95fab368e45eced) },
+    { UINT64_C(0x88b402f7fd75539b), UINT64_C(0x11dbcb0218ebb414) },
+    { UINT64_C(0xaae103b5fcd2a881), UINT64_C(0xd652bdc29f26a119) },
+    { UINT64_C(0xd59944a37c0752a2), UINT64_C(0x4be76d3346f0495f) },
+    { UINT64_C(0x857fcae62d8493a5), UINT64_C(0x6f70a4400c562ddb) },
+    { UINT64_C(0xa6dfbd9fb8e5b88e), UINT64_C(0xcb4ccd500f6bb952) },
+    { UINT64_C(0xd097ad07a71f26b2), UINT64_C(0x7e2000a41346a7a7) },
+    { UINT64_C(0x825ecc24c873782f), UINT64_C(0x8ed400668c0c28c8) },
+    { UINT64_C(0xa2f67f2dfa90563b), UINT64_C(0x728900802f0f32fa) },
+    { UINT64_C(0xcbb41ef979346bca), UINT64_C(0x4f2b40a03ad2ffb9) },
+    { UINT64_C(0xfea126b7d78186bc), UINT64_C(0xe2f610c84987bfa8) },
+    { UINT64_C(0x9f24b832e6b0f436), UINT64_C(0x0dd9ca7d2df4d7c9) },
+    { UINT64_C(0xc6ede63fa05d3143), UINT64_C(0x91503d1c79720dbb) },
+    { UINT64_C(0xf8a95fcf88747d94), UINT64_C(0x75a44c6397ce912a) },
+    { UINT64_C(0x9b69dbe1b548ce7c), UINT64_C(0xc986afbe3ee11aba) },
+    { UINT64_C(0xc24452da229b021b), UINT64_C(0xfbe85badce996168) },
+    { UINT64_C(0xf2d56790ab41c2a2), UINT64_C(0xfae27299423fb9c3) },
+    { UINT64_C(0x97c560ba6b0919a5), UINT64_C(0xdccd879fc967d41a) },
+    { UINT64_C(0xbdb6b8e905cb600f), UINT64_C(0x5400e987bbc1c920) },
+    { UINT64_C(0xed246723473e3813), UINT64_C(0x290123e9aab23b68) },
+    { UINT64_C(0x9436c0760c86e30b), UINT64_C(0xf9a0b6720aaf6521) },
+    { UINT64_C(0xb94470938fa89bce), UINT64_C(0xf808e40e8d5b3e69) },
+    { UINT64_C(0xe7958cb87392c2c2), UINT64_C(0xb60b1d1230b20e04) },
+    { UINT64_C(0x90bd77f3483bb9b9), UINT64_C(0xb1c6f22b5e6f48c2) },
+    { UINT64_C(0xb4ecd5f01a4aa828), UINT64_C(0x1e38aeb6360b1af3) },
+    { UINT64_C(0xe2280b6c20dd5232), UINT64_C(0x25c6da63c38de1b0) },
+    { UINT64_C(0x8d590723948a535f), UINT64_C(0x579c487e5a38ad0e) },
+    { UINT64_C(0xb0af48ec79ace837), UINT64_C(0x2d835a9df0c6d851) },
+    { UINT64_C(0xdcdb1b2798182244), UINT64_C(0xf8e431456cf88e65) },
+    { UINT64_C(0x8a08f0f8bf0f156b), UINT64_C(0x1b8e9ecb641b58ff) },
+    { UINT64_C(0xac8b2d36eed2dac5), UINT64_C(0xe272467e3d222f3f) },
+    { UINT64_C(0xd7adf884aa879177), UINT64_C(0x5b0ed81dcc6abb0f) },
+    { UINT64_C(0x86ccbb52ea94baea), UINT64_C(0x98e947129fc2b4e9) },
+    { UINT64_C(0xa87fea27a539e9a5), UINT64_C(0x3f2398d747b36224) },
+    { UINT64_C(0xd29fe4b18e88640e), UINT64_C(0x8eec7f0d19a03aad) },
+    { UINT64_C(0x83a3eeeef9153e89), UINT64_C(0x1953cf68300424ac) },
+    { UINT64_C(0xa48ceaaab75a8e2b), UINT64_C(0x5fa8c3423c052dd7) },
+    { UINT64_C(0xcdb02555653131b6), UINT64_C(0x3792f412cb06794d) },
+    { UINT64_C(0x808e17555f3ebf11), UINT64_C(0xe2bbd88bbee40bd0) },
+    { UINT64_C(0xa0b19d2ab70e6ed6), UINT64_C(0x5b6aceaeae9d0ec4) },
+    { UINT64_C(0xc8de047564d20a8b), UINT64_C(0xf245825a5a445275) },
+    { UINT64_C(0xfb158592be068d2e), UINT64_C(0xeed6e2f0f0d56712) },
+    { UINT64_C(0x9ced737bb6c4183d), UINT64_C(0x55464dd69685606b) },
+    { UINT64_C(0xc428d05aa4751e4c), UINT64_C(0xaa97e14c3c26b886) },
+    { UINT64_C(0xf53304714d9265df), UINT64_C(0xd53dd99f4b3066a8) },
+    { UINT64_C(0x993fe2c6d07b7fab), UINT64_C(0xe546a8038efe4029) },
+    { UINT64_C(0xbf8fdb78849a5f96), UINT64_C(0xde98520472bdd033) },
+    { UINT64_C(0xef73d256a5c0f77c), UINT64_C(0x963e66858f6d4440) },
+    { UINT64_C(0x95a8637627989aad), UINT64_C(0xdde7001379a44aa8) },
+    { UINT64_C(0xbb127c53b17ec159), UINT64_C(0x5560c018580d5d52) },
+    { UINT64_C(0xe9d71b689dde71af), UINT64_C(0xaab8f01e6e10b4a6) },
+    { UINT64_C(0x9226712162ab070d), UINT64_C(0xcab3961304ca70e8) },
+    { UINT64_C(0xb6b00d69bb55c8d1), UINT64_C(0x3d607b97c5fd0d22) },
+    { UINT64_C(0xe45c10c42a2b3b05), UINT64_C(0x8cb89a7db77c506a) },
+    { UINT64_C(0x8eb98a7a9a5b04e3), UINT64_C(0x77f3608e92adb242) },
+    { UINT64_C(0xb267ed1940f1c61c), UINT64_C(0x55f038b237591ed3) },
+    { UINT64_C(0xdf01e85f912e37a3), UINT64_C(0x6b6c46dec52f6688) },
+    { UINT64_C(0x8b61313bbabce2c6), UINT64_C(0x2323ac4b3b3da015) },
+    { UINT64_C(0xae397d8aa96c1b77), UINT64_C(0xabec975e0a0d081a) },
+    { UINT64_C(0xd9c7dced53c72255), UINT64_C(0x96e7bd358c904a21) },
+    { UINT64_C(0x881cea14545c7575), UINT64_C(0x7e50d64177da2e54) },
+    { UINT64_C(0xaa242499697392d2), UINT64_C(0xdde50bd1d5d0b9e9) },
+    { UINT64_C(0xd4ad2dbfc3d07787), UINT64_C(0x955e4ec64b44e864) },
+    { UINT64_C(0x84ec3c97da624ab4), UINT64_C(0xbd5af13bef0b113e) },
+    { UINT64_C(0xa6274bbdd0fadd61), UINT64_C(0xecb1ad8aeacdd58e) },
+    { UINT64_C(0xcfb11ead453994ba), UINT64_C(0x67de18eda5814af2) },
+    { UINT64_C(0x81ceb32c4b43fcf4), UINT64_C(0x80eacf948770ced7) },
+    { UINT64_C(0xa2425ff75e14fc31), UINT64_C(0xa1258379a94d028d) },
+    { UINT64_C(0xcad2f7f5359a3b3e), UINT64_C(0x096ee45813a04330) },
+    { UINT64_C(0xfd87b5f28300ca0d), UINT64_C(0x8bca9d6e188853fc) },
+    { UINT64_C(0x9e74d1b791e07e48), UINT64_C(0x775ea264cf55347e) },
+    { UINT64_C(0xc612062576589dda), UINT64_C(0x95364afe032a819e) },
+    { UINT64_C(0xf79687aed3eec551), UINT64_C(0x3a83ddbd83f52205) },
+    { UINT64_C(0x9abe14cd44753b52), UINT64_C(0xc4926a9672793543) },
+    { UINT64_C(0xc16d9a0095928a27), UINT64_C(0x75b7053c0f178294) },
+    { UINT64_C(0xf1c90080baf72cb1), UINT64_C(0x5324c68b12dd6339) },
+    { UINT64_C(0x971da05074da7bee), UINT64_C(0xd3f6fc16ebca5e04) },
+    { UINT64_C(0xbce5086492111aea), UINT64_C(0x88f4bb1ca6bcf585) },
+    { UINT64_C(0xec1e4a7db69561a5), UINT64_C(0x2b31e9e3d06c32e6) },
+    { UINT64_C(0x9392ee8e921d5d07), UINT64_C(0x3aff322e62439fd0) },
+    { UINT64_C(0xb877aa3236a4b449), UINT64_C(0x09befeb9fad487c3) },
+    { UINT64_C(0xe69594bec44de15b), UINT64_C(0x4c2ebe687989a9b4) },
+    { UINT64_C(0x901d7cf73ab0acd9), UINT64_C(0x0f9d37014bf60a11) },
+    { UINT64_C(0xb424dc35095cd80f), UINT64_C(0x538484c19ef38c95) },
+    { UINT64_C(0xe12e13424bb40e13), UINT64_C(0x2865a5f206b06fba) },
+    { UINT64_C(0x8cbccc096f5088cb), UINT64_C(0xf93f87b7442e45d4) },
+    { UINT64_C(0xafebff0bcb24aafe), UINT64_C(0xf78f69a51539d749) },
+    { UINT64_C(0xdbe6fecebdedd5be), UINT64_C(0xb573440e5a884d1c) },
+    { UINT64_C(0x89705f4136b4a597), UINT64_C(0x31680a88f8953031) },
+    { UINT64_C(0xabcc77118461cefc), UINT64_C(0xfdc20d2b36ba7c3e) },
+    { UINT64_C(0xd6bf94d5e57a42bc), UINT64_C(0x3d32907604691b4d) },
+    { UINT64_C(0x8637bd05af6c69b5), UINT64_C(0xa63f9a49c2c1b110) },
+    { UINT64_C(0xa7c5ac471b478423), UINT64_C(0x0fcf80dc33721d54) },
+    { UINT64_C(0xd1b71758e219652b), UINT64_C(0xd3c36113404ea4a9) },
+    { UINT64_C(0x83126e978d4fdf3b), UINT64_C(0x645a1cac083126ea) },
+    { UINT64_C(0xa3d70a3d70a3d70a), UINT64_C(0x3d70a3d70a3d70a4) },
+    { UINT64_C(0xcccccccccccccccc), UINT64_C(0xcccccccccccccccd) },
+    { UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xa000000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xc800000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xfa00000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x9c40000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xc350000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xf424000000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xbebc200000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xee6b280000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x9502f90000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xba43b74000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xe8d4a51000000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x9184e72a00000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xb5e620f480000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xe35fa931a0000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x8e1bc9bf04000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xb1a2bc2ec5000000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xde0b6b3a76400000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x8ac7230489e80000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xad78ebc5ac620000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xd8d726b7177a8000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x878678326eac9000), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xa968163f0a57b400), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xd3c21bcecceda100), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x84595161401484a0), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xa56fa5b99019a5c8), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0xcecb8f27f4200f3a), UINT64_C(0x0000000000000000) },
+    { UINT64_C(0x813f3978f8940984), UINT64_C(0x4000000000000000) },
+    { UINT64_C(0xa18f07d736b90be5), UINT64_C(0x5000000000000000) },
+    { UINT64_C(0xc9f2c9cd04674ede), UINT64_C(0xa400000000000000) },
+    { UINT64_C(0xfc6f7c4045812296), UINT64_C(0x4d00000000000000) },
+    { UINT64_C(0x9dc5ada82b70b59d), UINT64_C(0xf020000000000000) },
+    { UINT64_C(0xc5371912364ce305), UINT64_C(0x6c28000000000000) },
+    { UINT64_C(0xf684df56c3e01bc6), UINT64_C(0xc732000000000000) },
+    { UINT64_C(0x9a130b963a6c115c), UINT64_C(0x3c7f400000000000) },
+    { UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x4b9f100000000000) },
+    { UINT64_C(0xf0bdc21abb48db20), UINT64_C(0x1e86d40000000000) },
+    { UINT64_C(0x96769950b50d88f4), UINT64_C(0x1314448000000000) },
+    { UINT64_C(0xbc143fa4e250eb31), UINT64_C(0x17d955a000000000) },
+    { UINT64_C(0xeb194f8e1ae525fd), UINT64_C(0x5dcfab0800000000) },
+    { UINT64_C(0x92efd1b8d0cf37be), UINT64_C(0x5aa1cae500000000) },
+    { UINT64_C(0xb7abc627050305ad), UINT64_C(0xf14a3d9e40000000) },
+    { UINT64_C(0xe596b7b0c643c719), UINT64_C(0x6d9ccd05d0000000) },
+    { UINT64_C(0x8f7e32ce7bea5c6f), UINT64_C(0xe4820023a2000000) },
+    { UINT64_C(0xb35dbf821ae4f38b), UINT64_C(0xdda2802c8a800000) },
+    { UINT64_C(0xe0352f62a19e306e), UINT64_C(0xd50b2037ad200000) },
+    { UINT64_C(0x8c213d9da502de45), UINT64_C(0x4526f422cc340000) },
+    { UINT64_C(0xaf298d050e4395d6), UINT64_C(0x9670b12b7f410000) },
+    { UINT64_C(0xdaf3f04651d47b4c), UINT64_C(0x3c0cdd765f114000) },
+    { UINT64_C(0x88d8762bf324cd0f), UINT64_C(0xa5880a69fb6ac800) },
+    { UINT64_C(0xab0e93b6efee0053), UINT64_C(0x8eea0d047a457a00) },
+    { UINT64_C(0xd5d238a4abe98068), UINT64_C(0x72a4904598d6d880) },
+    { UINT64_C(0x85a36366eb71f041), UINT64_C(0x47a6da2b7f864750) },
+    { UINT64_C(0xa70c3c40a64e6c51), UINT64_C(0x999090b65f67d924) },
+    { UINT64_C(0xd0cf4b50cfe20765), UINT64_C(0xfff4b4e3f741cf6d) },
+    { UINT64_C(0x82818f1281ed449f), UINT64_C(0xbff8f10e7a8921a4) },
+    { UINT64_C(0xa321f2d7226895c7), UINT64_C(0xaff72d52192b6a0d) },
+    { UINT64_C(0xcbea6f8ceb02bb39), UINT64_C(0x9bf4f8a69f764490) },
+    { UINT64_C(0xfee50b7025c36a08), UINT64_C(0x02f236d04753d5b4) },
+    { UINT64_C(0x9f4f2726179a2245), UINT64_C(0x01d762422c946590) },
+    { UINT64_C(0xc722f0ef9d80aad6), UINT64_C(0x424d3ad2b7b97ef5) },
+    { UINT64_C(0xf8ebad2b84e0d58b), UINT64_C(0xd2e0898765a7deb2) },
+    { UINT64_C(0x9b934c3b330c8577), UINT64_C(0x63cc55f49f88eb2f) },
+    { UINT64_C(0xc2781f49ffcfa6d5), UINT64_C(0x3cbf6b71c76b25fb) },
+    { UINT64_C(0xf316271c7fc3908a), UINT64_C(0x8bef464e3945ef7a) },
+    { UINT64_C(0x97edd871cfda3a56), UINT64_C(0x97758bf0e3cbb5ac) },
+    { UINT64_C(0xbde94e8e43d0c8ec), UINT64_C(0x3d52eeed1cbea317) },
+    { UINT64_C(0xed63a231d4c4fb27), UINT64_C(0x4ca7aaa863ee4bdd) },
+    { UINT64_C(0x945e455f24fb1cf8), UINT64_C(0x8fe8caa93e74ef6a) },
+    { UINT64_C(0xb975d6b6ee39e436), UINT64_C(0xb3e2fd538e122b44) },
+    { UINT64_C(0xe7d34c64a9c85d44), UINT64_C(0x60dbbca87196b616) },
+    { UINT64_C(0x90e40fbeea1d3a4a), UINT64_C(0xbc8955e946fe31cd) },
+    { UINT64_C(0xb51d13aea4a488dd), UINT64_C(0x6babab6398bdbe41) },
+    { UINT64_C(0xe264589a4dcdab14), UINT64_C(0xc696963c7eed2dd1) },
+    { UINT64_C(0x8d7eb76070a08aec), UINT64_C(0xfc1e1de5cf543ca2) },
+    { UINT64_C(0xb0de65388cc8ada8), UINT64_C(0x3b25a55f43294bcb) },
+    { UINT64_C(0xdd15fe86affad912), UINT64_C(0x49ef0eb713f39ebe) },
+    { UINT64_C(0x8a2dbf142dfcc7ab), UINT64_C(0x6e3569326c784337) },
+    { UINT64_C(0xacb92ed9397bf996), UINT64_C(0x49c2c37f07965404) },
+    { UINT64_C(0xd7e77a8f87daf7fb), UINT64_C(0xdc33745ec97be906) },
+    { UINT64_C(0x86f0ac99b4e8dafd), UINT64_C(0x69a028bb3ded71a3) },
+    { UINT64_C(0xa8acd7c0222311bc), UINT64_C(0xc40832ea0d68ce0c) },
+    { UINT64_C(0xd2d80db02aabd62b), UINT64_C(0xf50a3fa490c30190) },
+    { UINT64_C(0x83c7088e1aab65db), UINT64_C(0x792667c6da79e0fa) },
+    { UINT64_C(0xa4b8cab1a1563f52), UINT64_C(0x577001b891185938) },
+    { UINT64_C(0xcde6fd5e09abcf26), UINT64_C(0xed4c0226b55e6f86) },
+    { UINT64_C(0x80b05e5ac60b6178), UINT64_C(0x544f8158315b05b4) },
+    { UINT64_C(0xa0dc75f1778e39d6), UINT64_C(0x696361ae3db1c721) },
+    { UINT64_C(0xc913936dd571c84c), UINT64_C(0x03bc3a19cd1e38e9) },
+    { UINT64_C(0xfb5878494ace3a5f), UINT64_C(0x04ab48a04065c723) },
+    { UINT64_C(0x9d174b2dcec0e47b), UINT64_C(0x62eb0d64283f9c76) },
+    { UINT64_C(0xc45d1df942711d9a), UINT64_C(0x3ba5d0bd324f8394) },
+    { UINT64_C(0xf5746577930d6500), UINT64_C(0xca8f44ec7ee36479) },
+    { UINT64_C(0x9968bf6abbe85f20), UINT64_C(0x7e998b13cf4e1ecb) },
+    { UINT64_C(0xbfc2ef456ae276e8), UINT64_C(0x9e3fedd8c321a67e) },
+    { UINT64_C(0xefb3ab16c59b14a2), UINT64_C(0xc5cfe94ef3ea101e) },
+    { UINT64_C(0x95d04aee3b80ece5), UINT64_C(0xbba1f1d158724a12) },
+    { UINT64_C(0xbb445da9ca61281f), UINT64_C(0x2a8a6e45ae8edc97) },
+    { UINT64_C(0xea1575143cf97226), UINT64_C(0xf52d09d71a3293bd) },
+    { UINT64_C(0x924d692ca61be758), UINT64_C(0x593c2626705f9c56) },
+    { UINT64_C(0xb6e0c377cfa2e12e), UINT64_C(0x6f8b2fb00c77836c) },
+    { UINT64_C(0xe498f455c38b997a), UINT64_C(0x0b6dfb9c0f956447) },
+    { UINT64_C(0x8edf98b59a373fec), UINT64_C(0x4724bd4189bd5eac) },
+    { UINT64_C(0xb2977ee300c50fe7), UINT64_C(0x58edec91ec2cb657) },
+    { UINT64_C(0xdf3d5e9bc0f653e1), UINT64_C(0x2f2967b66737e3ed) },
+    { UINT64_C(0x8b865b215899f46c), UINT64_C(0xbd79e0d20082ee74) },
+    { UINT64_C(0xae67f1e9aec07187), UINT64_C(0xecd8590680a3aa11) },
+    { UINT64_C(0xda01ee641a708de9), UINT64_C(0xe80e6f4820cc9495) },
+    { UINT64_C(0x884134fe908658b2), UINT64_C(0x3109058d147fdcdd) },
+    { UINT64_C(0xaa51823e34a7eede), UINT64_C(0xbd4b46f0599fd415) },
+    { UINT64_C(0xd4e5e2cdc1d1ea96), UINT64_C(0x6c9e18ac7007c91a) },
+    { UINT64_C(0x850fadc09923329e), UINT64_C(0x03e2cf6bc604ddb0) },
+    { UINT64_C(0xa6539930bf6bff45), UINT64_C(0x84db8346b786151c) },
+    { UINT64_C(0xcfe87f7cef46ff16), UINT64_C(0xe612641865679a63) },
+    { UINT64_C(0x81f14fae158c5f6e), UINT64_C(0x4fcb7e8f3f60c07e) },
+    { UINT64_C(0xa26da3999aef7749), UINT64_C(0xe3be5e330f38f09d) },
+    { UINT64_C(0xcb090c8001ab551c), UINT64_C(0x5cadf5bfd3072cc5) },
+    { UINT64_C(0xfdcb4fa002162a63), UINT64_C(0x73d9732fc7c8f7f6) },
+    { UINT64_C(0x9e9f11c4014dda7e), UINT64_C(0x2867e7fddcdd9afa) },
+    { UINT64_C(0xc646d63501a1511d), UINT64_C(0xb281e1fd541501b8) },
+    { UINT64_C(0xf7d88bc24209a565), UINT64_C(0x1f225a7ca91a4226) },
+    { UINT64_C(0x9ae757596946075f), UINT64_C(0x3375788de9b06958) },
+    { UINT64_C(0xc1a12d2fc3978937), UINT64_C(0x0052d6b1641c83ae) },
+    { UINT64_C(0xf209787bb47d6b84), UINT64_C(0xc0678c5dbd23a49a) },
+    { UINT64_C(0x9745eb4d50ce6332), UINT64_C(0xf840b7ba963646e0) },
+    { UINT64_C(0xbd176620a501fbff), UINT64_C(0xb650e5a93bc3d898) },
+    { UINT64_C(0xec5d3fa8ce427aff), UINT64_C(0xa3e51f138ab4cebe) },
+    { UINT64_C(0x93ba47c980e98cdf), UINT64_C(0xc66f336c36b10137) },
+    { UINT64_C(0xb8a8d9bbe123f017), UINT64_C(0xb80b0047445d4184) },
+    { UINT64_C(0xe6d3102ad96cec1d), UINT64_C(0xa60dc059157491e5) },
+    { UINT64_C(0x9043ea1ac7e41392), UINT64_C(0x87c89837ad68db2f) },
+    { UINT64_C(0xb454e4a179dd1877), UINT64_C(0x29babe4598c311fb) },
+    { UINT64_C(0xe16a1dc9d8545e94), UINT64_C(0xf4296dd6fef3d67a) },
+    { UINT64_C(0x8ce2529e2734bb1d), UINT64_C(0x1899e4a65f58660c) },
+    { UINT64_C(0xb01ae745b101e9e4), UINT64_C(0x5ec05dcff72e7f8f) },
+    { UINT64_C(0xdc21a1171d42645d), UINT64_C(0x76707543f4fa1f73) },
+    { UINT64_C(0x899504ae72497eba), UINT64_C(0x6a06494a791c53a8) },
+    { UINT64_C(0xabfa45da0edbde69), UINT64_C(0x0487db9d17636892) },
+    { UINT64_C(0xd6f8d7509292d603), UINT64_C(0x45a9d2845d3c42b6) },
+    { UINT64_C(0x865b86925b9bc5c2), UINT64_C(0x0b8a2392ba45a9b2) },
+    { UINT64_C(0xa7f26836f282b732), UINT64_C(0x8e6cac7768d7141e) },
+    { UINT64_C(0xd1ef0244af2364ff), UINT64_C(0x3207d795430cd926) },
+    { UINT64_C(0x8335616aed761f1f), UINT64_C(0x7f44e6bd49e807b8) },
+    { UINT64_C(0xa402b9c5a8d3a6e7), UINT64_C(0x5f16206c9c6209a6) },
+    { UINT64_C(0xcd036837130890a1), UINT64_C(0x36dba887c37a8c0f) },
+    { UINT64_C(0x802221226be55a64), UINT64_C(0xc2494954da2c9789) },
+    { UINT64_C(0xa02aa96b06deb0fd), UINT64_C(0xf2db9baa10b7bd6c) },
+    { UINT64_C(0xc83553c5c8965d3d), UINT64_C(0x6f92829494e5acc7) },
+    { UINT64_C(0xfa42a8b73abbf48c), UINT64_C(0xcb772339ba1f17f9) },
+    { UINT64_C(0x9c69a97284b578d7), UINT64_C(0xff2a760414536efb) },
+    { UINT64_C(0xc38413cf25e2d70d), UINT64_C(0xfef5138519684aba) },
+    { UINT64_C(0xf46518c2ef5b8cd1), UINT64_C(0x7eb258665fc25d69) },
+    { UINT64_C(0x98bf2f79d5993802), UINT64_C(0xef2f773ffbd97a61) },
+    { UINT64_C(0xbeeefb584aff8603), UINT64_C(0xaafb550ffacfd8fa) },
+    { UINT64_C(0xeeaaba2e5dbf6784), UINT64_C(0x95ba2a53f983cf38) },
+    { UINT64_C(0x952ab45cfa97a0b2), UINT64_C(0xdd945a747bf26183) },
+    { UINT64_C(0xba756174393d88df), UINT64_C(0x94f971119aeef9e4) },
+    { UINT64_C(0xe912b9d1478ceb17), UINT64_C(0x7a37cd5601aab85d) },
+    { UINT64_C(0x91abb422ccb812ee), UINT64_C(0xac62e055c10ab33a) },
+    { UINT64_C(0xb616a12b7fe617aa), UINT64_C(0x577b986b314d6009) },
+    { UINT64_C(0xe39c49765fdf9d94), UINT64_C(0xed5a7e85fda0b80b) },
+    { UINT64_C(0x8e41ade9fbebc27d), UINT64_C(0x14588f13be847307) },
+    { UINT64_C(0xb1d219647ae6b31c), UINT64_C(0x596eb2d8ae258fc8) },
+    { UINT64_C(0xde469fbd99a05fe3), UINT64_C(0x6fca5f8ed9aef3bb) },
+    { UINT64_C(0x8aec23d680043bee), UINT64_C(0x25de7bb9480d5854) },
+    { UINT64_C(0xada72ccc20054ae9), UINT64_C(0xaf561aa79a10ae6a) },
+    { UINT64_C(0xd910f7ff28069da4), UINT64_C(0x1b2ba1518094da04) },
+    { UINT64_C(0x87aa9aff79042286), UINT64_C(0x90fb44d2f05d0842) },
+    { UINT64_C(0xa99541bf57452b28), UINT64_C(0x353a1607ac744a53) },
+    { UINT64_C(0xd3fa922f2d1675f2), UINT64_C(0x42889b8997915ce8) },
+    { UINT64_C(0x847c9b5d7c2e09b7), UINT64_C(0x69956135febada11) },
+    { UINT64_C(0xa59bc234db398c25), UINT64_C(0x43fab9837e699095) },
+    { UINT64_C(0xcf02b2c21207ef2e), UINT64_C(0x94f967e45e03f4bb) },
+    { UINT64_C(0x8161afb94b44f57d), UINT64_C(0x1d1be0eebac278f5) },
+    { UINT64_C(0xa1ba1ba79e1632dc), UINT64_C(0x6462d92a69731732) },
+    { UINT64_C(0xca28a291859bbf93), UINT64_C(0x7d7b8f7503cfdcfe) },
+    { UINT64_C(0xfcb2cb35e702af78), UINT64_C(0x5cda735244c3d43e) },
+    { UINT64_C(0x9defbf01b061adab), UINT64_C(0x3a0888136afa64a7) },
+    { UINT64_C(0xc56baec21c7a1916), UINT64_C(0x088aaa1845b8fdd0) },
+    { UINT64_C(0xf6c69a72a3989f5b), UINT64_C(0x8aad549e57273d45) },
+    { UINT64_C(0x9a3c2087a63f6399), UINT64_C(0x36ac54e2f678864b) },
+    { UINT64_C(0xc0cb28a98fcf3c7f), UINT64_C(0x84576a1bb416a7dd) },
+    { UINT64_C(0xf0fdf2d3f3c30b9f), UINT64_C(0x656d44a2a11c51d5) },
+    { UINT64_C(0x969eb7c47859e743), UINT64_C(0x9f644ae5a4b1b325) },
+    { UINT64_C(0xbc4665b596706114), UINT64_C(0x873d5d9f0dde1fee) },
+    { UINT64_C(0xeb57ff22fc0c7959), UINT64_C(0xa90cb506d155a7ea) },
+    { UINT64_C(0x9316ff75dd87cbd8), UINT64_C(0x09a7f12442d588f2) },
+    { UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x0c11ed6d538aeb2f) },
+    { UINT64_C(0xe5d3ef282a242e81), UINT64_C(0x8f1668c8a86da5fa) },
+    { UINT64_C(0x8fa475791a569d10), UINT64_C(0xf96e017d694487bc) },
+    { UINT64_C(0xb38d92d760ec4455), UINT64_C(0x37c981dcc395a9ac) },
+    { UINT64_C(0xe070f78d3927556a), UINT64_C(0x85bbe253f47b1417) },
+    { UINT64_C(0x8c469ab843b89562), UINT64_C(0x93956d7478ccec8e) },
+    { UINT64_C(0xaf58416654a6babb), UINT64_C(0x387ac8d1970027b2) },
+    { UINT64_C(0xdb2e51bfe9d0696a), UINT64_C(0x06997b05fcc0319e) },
+    { UINT64_C(0x88fcf317f22241e2), UINT64_C(0x441fece3bdf81f03) },
+    { UINT64_C(0xab3c2fddeeaad25a), UINT64_C(0xd527e81cad7626c3) },
+    { UINT64_C(0xd60b3bd56a5586f1), UINT64_C(0x8a71e223d8d3b074) },
+    { UINT64_C(0x85c7056562757456), UINT64_C(0xf6872d5667844e49) },
+    { UINT64_C(0xa738c6bebb12d16c), UINT64_C(0xb428f8ac016561db) },
+    { UINT64_C(0xd106f86e69d785c7), UINT64_C(0xe13336d701beba52) },
+    { UINT64_C(0x82a45b450226b39c), UINT64_C(0xecc0024661173473) },
+    { UINT64_C(0xa34d721642b06084), UINT64_C(0x27f002d7f95d0190) },
+    { UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x31ec038df7b441f4) },
+    { UINT64_C(0xff290242c83396ce), UINT64_C(0x7e67047175a15271) },
+    { UINT64_C(0x9f79a169bd203e41), UINT64_C(0x0f0062c6e984d386) },
+    { UINT64_C(0xc75809c42c684dd1), UINT64_C(0x52c07b78a3e60868) },
+    { UINT64_C(0xf92e0c3537826145), UINT64_C(0xa7709a56ccdf8a82) },
+    { UINT64_C(0x9bbcc7a142b17ccb), UINT64_C(0x88a66076400bb691) },
+    { UINT64_C(0xc2abf989935ddbfe), UINT64_C(0x6acff893d00ea435) },
+    { UINT64_C(0xf356f7ebf83552fe), UINT64_C(0x0583f6b8c4124d43) },
+    { UINT64_C(0x98165af37b2153de), UINT64_C(0xc3727a337a8b704a) },
+    { UINT64_C(0xbe1bf1b059e9a8d6), UINT64_C(0x744f18c0592e4c5c) },
+    { UINT64_C(0xeda2ee1c7064130c), UINT64_C(0x1162def06f79df73) },
+    { UINT64_C(0x9485d4d1c63e8be7), UINT64_C(0x8addcb5645ac2ba8) },
+    { UINT64_C(0xb9a74a0637ce2ee1), UINT64_C(0x6d953e2bd7173692) },
+    { UINT64_C(0xe8111c87c5c1ba99), UINT64_C(0xc8fa8db6ccdd0437) },
+    { UINT64_C(0x910ab1d4db9914a0), UINT64_C(0x1d9c9892400a22a2) },
+    { UINT64_C(0xb54d5e4a127f59c8), UINT64_C(0x2503beb6d00cab4b) },
+    { UINT64_C(0xe2a0b5dc971f303a), UINT64_C(0x2e44ae64840fd61d) },
+    { UINT64_C(0x8da471a9de737e24), UINT64_C(0x5ceaecfed289e5d2) },
+    { UINT64_C(0xb10d8e1456105dad), UINT64_C(0x7425a83e872c5f47) },
+    { UINT64_C(0xdd50f1996b947518), UINT64_C(0xd12f124e28f77719) },
+    { UINT64_C(0x8a5296ffe33cc92f), UINT64_C(0x82bd6b70d99aaa6f) },
+    { UINT64_C(0xace73cbfdc0bfb7b), UINT64_C(0x636cc64d1001550b) },
+    { UINT64_C(0xd8210befd30efa5a), UINT64_C(0x3c47f7e05401aa4e) },
+    { UINT64_C(0x8714a775e3e95c78), UINT64_C(0x65acfaec34810a71) },
+    { UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0x7f1839a741a14d0d) },
+    { UINT64_C(0xd31045a8341ca07c), UINT64_C(0x1ede48111209a050) },
+    { UINT64_C(0x83ea2b892091e44d), UINT64_C(0x934aed0aab460432) },
+    { UINT64_C(0xa4e4b66b68b65d60), UINT64_C(0xf81da84d5617853f) },
+    { UINT64_C(0xce1de40642e3f4b9), UINT64_C(0x36251260ab9d668e) },
+    { UINT64_C(0x80d2ae83e9ce78f3), UINT64_C(0xc1d72b7c6b426019) },
+    { UINT64_C(0xa1075a24e4421730), UINT64_C(0xb24cf65b8612f81f) },
+    { UINT64_C(0xc94930ae1d529cfc), UINT64_C(0xdee033f26797b627) },
+    { UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0x169840ef017da3b1) },
+    { UINT64_C(0x9d412e0806e88aa5), UINT64_C(0x8e1f289560ee864e) },
+    { UINT64_C(0xc491798a08a2ad4e), UINT64_C(0xf1a6f2bab92a27e2) },
+    { UINT64_C(0xf5b5d7ec8acb58a2), UINT64_C(0xae10af696774b1db) },
+    { UINT64_C(0x9991a6f3d6bf1765), UINT64_C(0xacca6da1e0a8ef29) },
+    { UINT64_C(0xbff610b0cc6edd3f), UINT64_C(0x17fd090a58d32af3) },
+    { UINT64_C(0xeff394dcff8a948e), UINT64_C(0xddfc4b4cef07f5b0) },
+    { UINT64_C(0x95f83d0a1fb69cd9), UINT64_C(0x4abdaf101564f98e) },
+    { UINT64_C(0xbb764c4ca7a4440f), UINT64_C(0x9d6d1ad41abe37f1) },
+    { UINT64_C(0xea53df5fd18d5513), UINT64_C(0x84c86189216dc5ed) },
+    { UINT64_C(0x92746b9be2f8552c), UINT64_C(0x32fd3cf5b4e49bb4) },
+    { UINT64_C(0xb7118682dbb66a77), UINT64_C(0x3fbc8c33221dc2a1) },
+    { UINT64_C(0xe4d5e82392a40515), UINT64_C(0x0fabaf3feaa5334a) },
+    { UINT64_C(0x8f05b1163ba6832d), UINT64_C(0x29cb4d87f2a7400e) },
+    { UINT64_C(0xb2c71d5bca9023f8), UINT64_C(0x743e20e9ef511012) },
+    { UINT64_C(0xdf78e4b2bd342cf6), UINT64_C(0x914da9246b255416) },
+    { UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0x1ad089b6c2f7548e) },
+    { UINT64_C(0xae9672aba3d0c320), UINT64_C(0xa184ac2473b529b1) },
+    { UINT64_C(0xda3c0f568cc4f3e8), UINT64_C(0xc9e5d72d90a2741e) },
+    { UINT64_C(0x8865899617fb1871), UINT64_C(0x7e2fa67c7a658892) },
+    { UINT64_C(0xaa7eebfb9df9de8d), UINT64_C(0xddbb901b98feeab7) },
+    { UINT64_C(0xd51ea6fa85785631), UINT64_C(0x552a74227f3ea565) },
+    { UINT64_C(0x8533285c936b35de), UINT64_C(0xd53a88958f87275f) },
+    { UINT64_C(0xa67ff273b8460356), UINT64_C(0x8a892abaf368f137) },
+    { UINT64_C(0xd01fef10a657842c), UINT64_C(0x2d2b7569b0432d85) },
+    { UINT64_C(0x8213f56a67f6b29b), UINT64_C(0x9c3b29620e29fc73) },
+    { UINT64_C(0xa298f2c501f45f42), UINT64_C(0x8349f3ba91b47b8f) },
+    { UINT64_C(0xcb3f2f7642717713), UINT64_C(0x241c70a936219a73) },
+    { UINT64_C(0xfe0efb53d30dd4d7), UINT64_C(0xed238cd383aa0110) },
+    { UINT64_C(0x9ec95d1463e8a506), UINT64_C(0xf4363804324a40aa) },
+    { UINT64_C(0xc67bb4597ce2ce48), UINT64_C(0xb143c6053edcd0d5) },
+    { UINT64_C(0xf81aa16fdc1b81da), UINT64_C(0xdd94b7868e94050a) },
+    { UINT64_C(0x9b10a4e5e9913128), UINT64_C(0xca7cf2b4191c8326) },
+    { UINT64_C(0xc1d4ce1f63f57d72), UINT64_C(0xfd1c2f611f63a3f0) },
+    { UINT64_C(0xf24a01a73cf2dccf), UINT64_C(0xbc633b39673c8cec) },
+    { UINT64_C(0x976e41088617ca01), UINT64_C(0xd5be0503e085d813) },
+    { UINT64_C(0xbd49d14aa79dbc82), UINT64_C(0x4b2d8644d8a74e18) },
+    { UINT64_C(0xec9c459d51852ba2), UINT64_C(0xddf8e7d60ed1219e) },
+    { UINT64_C(0x93e1ab8252f33b45), UINT64_C(0xcabb90e5c942b503) },
+    { UINT64_C(0xb8da1662e7b00a17), UINT64_C(0x3d6a751f3b936243) },
+    { UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0x0cc512670a783ad4) },
+    { UINT64_C(0x906a617d450187e2), UINT64_C(0x27fb2b80668b24c5) },
+    { UINT64_C(0xb484f9dc9641e9da), UINT64_C(0xb1f9f660802dedf6) },
+    { UINT64_C(0xe1a63853bbd26451), UINT64_C(0x5e7873f8a0396973) },
+    { UINT64_C(0x8d07e33455637eb2), UINT64_C(0xdb0b487b6423e1e8) },
+    { UINT64_C(0xb049dc016abc5e5f), UINT64_C(0x91ce1a9a3d2cda62) },
+    { UINT64_C(0xdc5c5301c56b75f7), UINT64_C(0x7641a140cc7810fb) },
+    { UINT64_C(0x89b9b3e11b6329ba), UINT64_C(0xa9e904c87fcb0a9d) },
+    { UINT64_C(0xac2820d9623bf429), UINT64_C(0x546345fa9fbdcd44) },
+    { UINT64_C(0xd732290fbacaf133), UINT64_C(0xa97c177947ad4095) },
+    { UINT64_C(0x867f59a9d4bed6c0), UINT64_C(0x49ed8eabcccc485d) },
+    { UINT64_C(0xa81f301449ee8c70), UINT64_C(0x5c68f256bfff5a74) },
+    { UINT64_C(0xd226fc195c6a2f8c), UINT64_C(0x73832eec6fff3111) },
+    { UINT64_C(0x83585d8fd9c25db7), UINT64_C(0xc831fd53c5ff7eab) },
+    { UINT64_C(0xa42e74f3d032f525), UINT64_C(0xba3e7ca8b77f5e55) },
+    { UINT64_C(0xcd3a1230c43fb26f), UINT64_C(0x28ce1bd2e55f35eb) },
+    { UINT64_C(0x80444b5e7aa7cf85), UINT64_C(0x7980d163cf5b81b3) },
+    { UINT64_C(0xa0555e361951c366), UINT64_C(0xd7e105bcc332621f) },
+    { UINT64_C(0xc86ab5c39fa63440), UINT64_C(0x8dd9472bf3fefaa7) },
+    { UINT64_C(0xfa856334878fc150), UINT64_C(0xb14f98f6f0feb951) },
+    { UINT64_C(0x9c935e00d4b9d8d2), UINT64_C(0x6ed1bf9a569f33d3) },
+    { UINT64_C(0xc3b8358109e84f07), UINT64_C(0x0a862f80ec4700c8) },
+    { UINT64_C(0xf4a642e14c6262c8), UINT64_C(0xcd27bb612758c0fa) },
+    { UINT64_C(0x98e7e9cccfbd7dbd), UINT64_C(0x8038d51cb897789c) },
+    { UINT64_C(0xbf21e44003acdd2c), UINT64_C(0xe0470a63e6bd56c3) },
+    { UINT64_C(0xeeea5d5004981478), UINT64_C(0x1858ccfce06cac74) },
+    { UINT64_C(0x95527a5202df0ccb), UINT64_C(0x0f37801e0c43ebc8) },
+    { UINT64_C(0xbaa718e68396cffd), UINT64_C(0xd30560258f54e6ba) },
+    { UINT64_C(0xe950df20247c83fd), UINT64_C(0x47c6b82ef32a2069) },
+    { UINT64_C(0x91d28b7416cdd27e), UINT64_C(0x4cdc331d57fa5441) },
+    { UINT64_C(0xb6472e511c81471d), UINT64_C(0xe0133fe4adf8e952) },
+    { UINT64_C(0xe3d8f9e563a198e5), UINT64_C(0x58180fddd97723a6) },
+    { UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0x570f09eaa7ea7648) }
+};
 
-    skip_char(string);
-    return output_value;
+/* Scanner */
+#if defined(_MSC_VER)
+static unsigned int json_ctz(unsigned int mask)
+{
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+}
+#elif defined(__GNUC__)
+#define json_ctz(mask) ((unsigned int)__builtin_ctz(mask))
+#else
+static unsigned int json_ctz(unsigned int mask)
+{
+    unsigned int index = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+}
+#endif
+
+/* Returns the first non-whitespace character or end */
+static const char* json_skip_spaces(const char *cur, const char *end)
+{
+    /* Most tokens are separated by a single space or none */
+    if ((cur == end) || !is_space(*cur)) return cur;
+    if ((++cur == end) || !is_space(*cur)) return cur;
+
+#if defined(JSON_SIMD_AVX2)
+    while (end - cur >= 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)cur);
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))));
+        unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(m);
+
+        if (mask) return cur + json_ctz(mask);
+        cur += 32;
+    }
+#elif defined(JSON_SIMD_SSE2)
+    while (end - cur >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)cur);
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+        unsigned int mask = ~(unsigned int)_mm_movemask_epi8(m) & 0xFFFF;
+
+        if (mask) return cur + json_ctz(mask);
+        cur += 16;
+    }
+#endif
+    while ((cur < end) && is_space(*cur)) cur++;
+    return cur;
+}
+
+/* Returns the first quote, backslash, control character or end */
+static const char* json_scan_string(const char *cur, const char *end)
+{
+#if defined(JSON_SIMD_AVX2)
+    while (end - cur >= 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)cur);
+        __m256i ctrl = _mm256_set1_epi8(0x1F);
+        /* v <= 0x1F as unsigned */
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(m);
+
+        if (mask) return cur + json_ctz(mask);
+        cur += 32;
+    }
+#elif defined(JSON_SIMD_SSE2)
+    while (end - cur >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)cur);
+        __m128i ctrl = _mm_set1_epi8(0x1F);
+        /* v <= 0x1F as unsigned */
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(m);
+
+        if (mask) return cur + json_ctz(mask);
+        cur += 16;
+    }
+#endif
+    while ((cur < end) &&
+           (*cur != '\"') && (*cur != '\\') &&
+           ((unsigned char)*cur >= 0x20))
+    {
+        cur++;
+    }
+    return cur;
+}
+
+/* Character following the backslash for each byte that must be
+   escaped, or 0. 'u' means \u00XX. '/' is escaped as before. */
+static const char json_escape_table[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '/',
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0
+};
+
+/* Same as json_scan_string but also stops at '/', for the serializer */
+static const char* json_scan_escape(const char *cur, const char *end)
+{
+#if defined(JSON_SIMD_AVX2)
+    while (end - cur >= 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)cur);
+        __m256i ctrl = _mm256_set1_epi8(0x1F);
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')),
+                            _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl),
+                                              ctrl)));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(m);
+
+        if (mask) return cur + json_ctz(mask);
+        cur += 32;
+    }
+#elif defined(JSON_SIMD_SSE2)
+    while (end - cur >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)cur);
+        __m128i ctrl = _mm_set1_epi8(0x1F);
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')),
+                         _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl)));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(m);
+
+        if (mask) return cur + json_ctz(mask);
+        cur += 16;
+    }
+#endif
+    while ((cur < end) && !json_escape_table[(unsigned char)*cur]) cur++;
+    return cur;
+}
+
+/* Bit i is set when p[i] is a quote, backslash or bracket. n is at
+   most JSON_STRUCTURAL_BLOCK. */
+#if defined(JSON_SIMD_AVX2)
+#define JSON_STRUCTURAL_BLOCK 32
+#else
+#define JSON_STRUCTURAL_BLOCK 16
+#endif
+static unsigned int json_structural_mask(const char *p, size_t n)
+{
+    unsigned int mask = 0;
+    size_t i;
+
+#if defined(JSON_SIMD_AVX2)
+    if (n == JSON_STRUCTURAL_BLOCK)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        /* '[' and ']' differ from '{' and '}' only in bit 5 */
+        __m256i b = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(b, _mm256_set1_epi8('{')),
+                            _mm256_cmpeq_epi8(b, _mm256_set1_epi8('}'))));
+        return (unsigned int)_mm256_movemask_epi8(m);
+    }
+#elif defined(JSON_SIMD_SSE2)
+    if (n == JSON_STRUCTURAL_BLOCK)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        /* '[' and ']' differ from '{' and '}' only in bit 5 */
+        __m128i b = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+            _mm_or_si128(_mm_cmpeq_epi8(b, _mm_set1_epi8('{')),
+                         _mm_cmpeq_epi8(b, _mm_set1_epi8('}'))));
+        return (unsigned int)_mm_movemask_epi8(m);
+    }
+#endif
+    for (i = 0; i < n; i++)
+    {
+        if ((p[i] == '"') || (p[i] == '\\') ||
+            ((p[i] | 0x20) == '{') || ((p[i] | 0x20) == '}'))
+        {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+#if defined(JSON_HAVE_THREADS)
+/* Bit i is set when p[i] is a comma */
+static unsigned int json_comma_mask(const char *p, size_t n)
+{
+    unsigned int mask = 0;
+    size_t i;
+
+#if defined(JSON_SIMD_AVX2)
+    if (n == JSON_STRUCTURAL_BLOCK)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        return (unsigned int)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+    }
+#elif defined(JSON_SIMD_SSE2)
+    if (n == JSON_STRUCTURAL_BLOCK)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        return (unsigned int)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+    }
+#endif
+    for (i = 0; i < n; i++)
+    {
+        if (p[i] == ',') mask |= 1u << i;
+    }
+    return mask;
+}
+#endif
+
+/* Number */
+static unsigned int json_clz64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_clzll(x);
+#else
+    unsigned int n = 0;
+
+    while (!(x & (UINT64_C(1) << 63)))
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static json_uint128 json_mul64(uint64_t a, uint64_t b)
+{
+    json_uint128 r;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128)a * b;
+
+    r.high = (uint64_t)(p >> 64);
+    r.low = (uint64_t)p;
+#else
+    uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+
+    r.high = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    r.low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+    return r;
+}
+
+/* Converts w * 10^q to the nearest double. Returns ERROR when the
+   result can not be decided without the full decimal text. */
+static int json_decimal_to_double(uint64_t w, int q, int negative,
+                                  double *out)
+{
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const uint64_t *pow5;
+    json_uint128 product;
+    uint64_t mantissa;
+    uint64_t bits;
+    unsigned int lz;
+    int upperbit;
+    int shift;
+    int power2;
+
+    if ((w == 0) || (q < JSON_POW5_MIN))
+    {
+        *out = negative ? -0.0: 0.0;
+        return SUCCESS;
+    }
+    if (q > JSON_POW5_MAX)
+    {
+        *out = negative ? -HUGE_VAL: HUGE_VAL;
+        return SUCCESS;
+    }
+
+    /* Clinger's fast path: both operands are exact doubles */
+    if ((w <= (UINT64_C(1) << 53)) && (q >= -22) && (q <= 22))
+    {
+        double d = (double)w;
+
+        d = (q < 0) ? d / pow10[-q]: d * pow10[q];
+        *out = negative ? -d: d;
+        return SUCCESS;
+    }
+
+    /* Eisel-Lemire: multiply by the 128-bit truncated 5^q */
+    pow5 = json_pow5_128[q - JSON_POW5_MIN];
+    lz = json_clz64(w);
+    w <<= lz;
+    product = json_mul64(w, pow5[0]);
+    if ((product.high & 0x1FF) == 0x1FF)
+    {
+        json_uint128 second = json_mul64(w, pow5[1]);
+
+        product.low += second.high;
+        if (second.high > product.low) product.high++;
+    }
+    if ((product.low == UINT64_MAX) && ((q < -27) || (q > 55)))
+        return ERROR;
+
+    upperbit = (int)(product.high >> 63);
+    shift = upperbit + 64 - 52 - 3;
+    mantissa = product.high >> shift;
+    power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - (int)lz + 1023;
+
+    if (power2 <= 0)
+    {
+        /* Subnormal, which may become normal by rounding up */
+        if (-power2 + 1 >= 64)
+        {
+            mantissa = 0;
+            power2 = 0;
+        }
+        else
+        {
+            mantissa >>= -power2 + 1;
+            mantissa += (mantissa & 1);
+            mantissa >>= 1;
+            power2 = (mantissa < (UINT64_C(1) << 52)) ? 0: 1;
+        }
+    }
+    else
+    {
+        /* Exactly halfway between two doubles: round to even */
+        if ((product.low <= 1) && (q >= -4) && (q <= 23) &&
+            ((mantissa & 3) == 1) && ((mantissa << shift) == product.high))
+        {
+            mantissa &= ~UINT64_C(1);
+        }
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        if (mantissa >= (UINT64_C(2) << 52))
+        {
+            mantissa = UINT64_C(1) << 52;
+            power2++;
+        }
+        mantissa &= ~(UINT64_C(1) << 52);
+        if (power2 >= 0x7FF)
+        {
+            mantissa = 0;
+            power2 = 0x7FF;
+        }
+    }
+
+    bits = mantissa | ((uint64_t)power2 << 52);
+    if (negative) bits |= UINT64_C(1) << 63;
+    memcpy(out, &bits, sizeof(double));
+    return SUCCESS;
+}
+
+/* Slow path for numbers the fast paths can not decide. strtod expects
+   the decimal point of the current locale, so '.' is replaced. */
+static int json_strtod(const char *text, size_t length, double *out)
+{
+    char local[64];
+    char *buf = local;
+    char *dot;
+    const char *point = localeconv()->decimal_point;
+
+    if (length >= sizeof(local))
+    {
+        buf = (char*)json_malloc(length + 1);
+        if (!buf) return ERROR;
+    }
+    memcpy(buf, text, length);
+    buf[length] = '\0';
+
+    dot = strchr(buf, '.');
+    if (dot && point && (*point != '\0')) *dot = *point;
+    *out = strtod(buf, NULL);
+
+    if (buf != local) json_free(buf);
+    return SUCCESS;
+}
+
+static size_t json_format_integer(int64_t value, char *buf)
+{
+    char digits[20];
+    uint64_t u = (value < 0) ? (uint64_t)0 - (uint64_t)value: (uint64_t)value;
+    size_t n = 0;
+    size_t len = 0;
+
+    do
+    {
+        digits[n++] = (char)('0' + (u % 10));
+        u /= 10;
+    } while (u > 0);
+
+    if (value < 0) buf[len++] = '-';
+    while (n > 0) buf[len++] = digits[--n];
+    buf[len] = '\0';
+    return len;
+}
+
+/* Formats short digits that read back to the same double, in the
+   notation of ECMAScript Number.prototype.toString. Grisu2 is not
+   always shortest: 1e23 comes out as 9.999999999999999e+22. */
+static size_t json_format_double(double value, char *buf)
+{
+    char digits[20];
+    char *p = buf;
+    uint64_t bits;
+    int length;
+    int K;
+    int point;
+    int i;
+
+    memcpy(&bits, &value, sizeof(double));
+    if (((bits >> 52) & 0x7FF) == 0x7FF)
+    {
+        /* JSON has neither Infinity nor NaN */
+        strcpy(buf, "null");
+        return 4;
+    }
+    if (bits >> 63)
+    {
+        *p++ = '-';
+        value = -value;
+    }
+    if (value == 0)
+    {
+        *p++ = '0';
+        *p = '\0';
+        return p - buf;
+    }
+
+    length = json_grisu2(value, digits, &K);
+    point = length + K;
+
+    if ((K >= 0) && (point <= 21))
+    {
+        /* 1500 */
+        memcpy(p, digits, length);
+        p += length;
+        for (i = 0; i < K; i++) *p++ = '0';
+    }
+    else if ((point > 0) && (point <= 21))
+    {
+        /* 1.25 */
+        memcpy(p, digits, point);
+        p += point;
+        *p++ = '.';
+        memcpy(p, digits + point, length - point);
+        p += length - point;
+    }
+    else if ((point > -6) && (point <= 0))
+    {
+        /* 0.00125 */
+        *p++ = '0';
+        *p++ = '.';
+        for (i = point; i < 0; i++) *p++ = '0';
+        memcpy(p, digits, length);
+        p += length;
+    }
+    else
+    {
+        /* 1.25e-7 */
+        *p++ = digits[0];
+        if (length > 1)
+        {
+            *p++ = '.';
+            memcpy(p, digits + 1, length - 1);
+            p += length - 1;
+        }
+        *p++ = 'e';
+        *p++ = (point - 1 < 0) ? '-': '+';
+        p += json_format_integer((point - 1 < 0) ? 1 - point: point - 1, p);
+    }
+    *p = '\0';
+    return p - buf;
+}
+
+static json_diyfp json_diyfp_mul(json_diyfp x, json_diyfp y)
+{
+    json_uint128 p = json_mul64(x.f, y.f);
+    json_diyfp r;
+
+    /* Rounded upper half */
+    r.f = p.high + (p.low >> 63);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+/* Writes the digits of a positive value and returns their count. The
+   value is digits * 10^K. */
+static int json_grisu2(double value, char *digits, int *K)
+{
+    json_diyfp v;
+    json_diyfp w;
+    json_diyfp plus;
+    json_diyfp minus;
+    json_diyfp c;
+    uint64_t bits;
+    unsigned int lz;
+    double dk;
+    int biased;
+    int k;
+    int index;
+
+    memcpy(&bits, &value, sizeof(double));
+    biased = (int)((bits >> 52) & 0x7FF);
+    v.f = bits & ((UINT64_C(1) << 52) - 1);
+    if (biased)
+    {
+        v.f += UINT64_C(1) << 52;
+        v.e = biased - 1075;
+    }
+    else
+    {
+        v.e = -1074;
+    }
+
+    /* Boundaries halfway to the neighbours, on the same exponent */
+    plus.f = (v.f << 1) + 1;
+    plus.e = v.e - 1;
+    lz = json_clz64(plus.f);
+    plus.f <<= lz;
+    plus.e -= lz;
+    if (v.f == (UINT64_C(1) << 52))
+    {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    }
+    else
+    {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    /* Cached power 10^-K bringing the exponent into [-60, -32] */
+    dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    k = (int)dk;
+    if (dk - k > 0.0) k++;
+    index = (k >> 3) + 1;
+    *K = -(-348 + index * 8);
+    c.f = json_cached_pow10_f[index];
+    c.e = json_cached_pow10_e[index];
+
+    lz = json_clz64(v.f);
+    w.f = v.f << lz;
+    w.e = v.e - (int)lz;
+    w = json_diyfp_mul(w, c);
+    plus = json_diyfp_mul(plus, c);
+    minus = json_diyfp_mul(minus, c);
+    minus.f++;
+    plus.f--;
+
+    return json_digit_gen(w, plus, plus.f - minus.f, digits, K);
+}
+
+static int json_digit_gen(json_diyfp w, json_diyfp mp, uint64_t delta,
+                          char *buffer, int *K)
+{
+    static const uint64_t pow10[] = {
+        UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000),
+        UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+        UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+        UINT64_C(10000000000), UINT64_C(100000000000),
+        UINT64_C(1000000000000), UINT64_C(10000000000000),
+        UINT64_C(100000000000000), UINT64_C(1000000000000000),
+        UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+        UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+    };
+    const int one_e = -mp.e;
+    const uint64_t one_f = UINT64_C(1) << one_e;
+    const uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> one_e);
+    uint64_t p2 = mp.f & (one_f - 1);
+    int kappa = 1;
+    int length = 0;
+
+    while ((kappa < 10) && (p1 >= pow10[kappa])) kappa++;
+
+    /* Integral part */
+    while (kappa > 0)
+    {
+        uint32_t d = (uint32_t)(p1 / pow10[kappa - 1]);
+        uint64_t rest;
+
+        p1 %= (uint32_t)pow10[kappa - 1];
+        if (d || length) buffer[length++] = (char)('0' + d);
+        kappa--;
+        rest = ((uint64_t)p1 << one_e) + p2;
+        if (rest <= delta)
+        {
+            *K += kappa;
+            json_grisu_round(buffer, length, delta, rest,
+                             pow10[kappa] << one_e, wp_w);
+            return length;
+        }
+    }
+
+    /* Fractional part */
+    for (;;)
+    {
+        char d;
+
+        p2 *= 10;
+        delta *= 10;
+        d = (char)(p2 >> one_e);
+        if (d || length) buffer[length++] = (char)('0' + d);
+        p2 &= one_f - 1;
+        kappa--;
+        if (p2 < delta)
+        {
+            *K += kappa;
+            json_grisu_round(buffer, length, delta, p2, one_f,
+                             wp_w * ((-kappa < 20) ? pow10[-kappa]: 0));
+            return length;
+        }
+    }
+}
+
+/* Moves the last digit towards w while it stays inside the boundaries */
+static void json_grisu_round(char *buffer, int length, uint64_t delta,
+                             uint64_t rest, uint64_t ten_kappa,
+                             uint64_t wp_w)
+{
+    while ((rest < wp_w) && (delta - rest >= ten_kappa) &&
+           ((rest + ten_kappa < wp_w) ||
+            (wp_w - rest > rest + ten_kappa - wp_w)))
+    {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/* Parser */
+static void json_parser_init(json_parser *p,
+                             const KJSD_JSON_Handler *handler, void *ctx)
+{
+    memset(p, 0, sizeof(json_parser));
+    p->handler = handler;
+    p->ctx = ctx;
+    p->state = JSON_PS_VALUE;
+}
+
+/* Starts a new document, keeping the scratch buffer */
+static void json_parser_reset(json_parser *p)
+{
+    p->state = JSON_PS_VALUE;
+    p->depth = 0;
+    p->length = 0;
+    p->skip_value = 0;
+}
+
+static void json_parser_release(json_parser *p)
+{
+    json_free(p->buf);
+    p->buf = NULL;
+    p->capacity = 0;
+}
+
+/* Returns the number of consumed bytes. The parser stops right after
+   the root value, so the rest of data is left to the caller. */
+static size_t json_parser_feed(json_parser *p,
+                               const char *data, size_t size)
+{
+    const char *cur = data;
+    const char *end = data + size;
+
+    while (cur < end)
+    {
+        switch (p->state)
+        {
+        case JSON_PS_STRING:
+            cur = json_parser_string(p, cur, end);
+            break;
+        case JSON_PS_NUMBER:
+            cur = json_parser_number(p, cur, end);
+            break;
+        case JSON_PS_LITERAL:
+            cur = json_parser_literal(p, cur, end);
+            break;
+        case JSON_PS_SKIP:
+            cur = json_parser_skip(p, cur, end);
+            break;
+        case JSON_PS_DONE:
+        case JSON_PS_ERROR:
+            return cur - data;
+        default:
+            cur = json_skip_spaces(cur, end);
+            if (cur == end) return size;
+            cur = json_parser_token(p, cur);
+            break;
+        }
+    }
+    return cur - data;
+}
+
+static int json_parser_finish(json_parser *p)
+{
+    /* A number at the top level is not terminated until the end */
+    if ((p->state == JSON_PS_NUMBER) && (p->depth == 0))
+    {
+        json_parser_end_number(p, NULL, NULL);
+    }
+    return p->state == JSON_PS_DONE;
+}
+
+static const char* json_parser_token(json_parser *p, const char *cur)
+{
+    switch (p->state)
+    {
+    case JSON_PS_OBJECT_FIRST:
+        if (*cur == '}') return json_parser_end_container(p, cur, '{');
+        /* fall through */
+    case JSON_PS_KEY:
+        if (*cur != '\"') break;
+        p->is_key = 1;
+        json_parser_begin_token(p, JSON_PS_STRING);
+        return cur + 1;
+    case JSON_PS_COLON:
+        if (*cur != ':') break;
+        p->state = JSON_PS_VALUE;
+        if (p->skip_value)
+        {
+            p->skip_value = 0;
+            p->skip_depth = 0;
+            p->skip_string = 0;
+            p->skip_scalar = 0;
+            p->escape = 0;
+            p->state = JSON_PS_SKIP;
+        }
+        return cur + 1;
+    case JSON_PS_ARRAY_FIRST:
+        if (*cur == ']') return json_parser_end_container(p, cur, '[');
+        /* fall through */
+    case JSON_PS_VALUE:
+        return json_parser_begin_value(p, cur);
+    case JSON_PS_NEXT:
+        if (*cur == ',')
+        {
+            p->state = (p->stack[p->depth - 1] == '{') ?
+                JSON_PS_KEY: JSON_PS_VALUE;
+            return cur + 1;
+        }
+        if (*cur == '}') return json_parser_end_container(p, cur, '{');
+        if (*cur == ']') return json_parser_end_container(p, cur, '[');
+        break;
+    default:
+        break;
+    }
+    p->state = JSON_PS_ERROR;
+    return cur;
+}
+
+static const char* json_parser_begin_value(json_parser *p,
+                                           const char *cur)
+{
+    switch (*cur)
+    {
+    case '{':
+    case '[':
+        if (p->depth > MAX_NESTING) break;
+        p->stack[p->depth++] = *cur;
+        if (*cur == '{')
+        {
+            if (!json_emit(p, start_object, (p->ctx))) break;
+            p->state = JSON_PS_OBJECT_FIRST;
+        }
+        else
+        {
+            if (!json_emit(p, start_array, (p->ctx))) break;
+            p->state = JSON_PS_ARRAY_FIRST;
+        }
+        return cur + 1;
+    case '\"':
+        p->is_key = 0;
+        json_parser_begin_token(p, JSON_PS_STRING);
+        return cur + 1;
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        /* The first character is consumed by the number scanner */
+        json_parser_begin_token(p, JSON_PS_NUMBER);
+        p->number = JSON_NS_BEGIN;
+        p->negative = 0;
+        p->truncated = 0;
+        p->mantissa = 0;
+        p->digits = 0;
+        p->exp10 = 0;
+        p->exponent = 0;
+        p->exp_negative = 0;
+        return cur;
+    case 't':
+    case 'f':
+    case 'n':
+        json_parser_begin_token(p, JSON_PS_LITERAL);
+        p->literal = (*cur == 't') ? "true": (*cur == 'f') ? "false": "null";
+        p->literal_pos = 1;
+        return cur + 1;
+    default:
+        break;
+    }
+    p->state = JSON_PS_ERROR;
+    return cur;
+}
+
+static const char* json_parser_end_container(json_parser *p,
+                                             const char *cur,
+                                             unsigned char open)
+{
+    int success;
+
+    if (p->stack[p->depth - 1] != open)
+    {
+        p->state = JSON_PS_ERROR;
+        return cur;
+    }
+    p->depth--;
+    success = (open == '{') ?
+        json_emit(p, end_object, (p->ctx)):
+        json_emit(p, end_array, (p->ctx));
+    if (!success)
+    {
+        p->state = JSON_PS_ERROR;
+        return cur;
+    }
+    json_parser_end_value(p);
+    return cur + 1;
+}
+
+static void json_parser_end_value(json_parser *p)
+{
+    p->state = (p->depth > 0) ? JSON_PS_NEXT: JSON_PS_DONE;
+}
+
+static void json_parser_begin_token(json_parser *p,
+                                    json_parser_state state)
+{
+    p->state = state;
+    p->buffered = 0;
+    p->length = 0;
+    p->escape = 0;
+    p->surrogate = 0;
+}
+
+static const char* json_parser_string(json_parser *p,
+                                      const char *cur, const char *end)
+{
+    const char *start = cur;
+    const char *value;
+    size_t length;
+    int success;
+
+    while (cur < end)
+    {
+        if (p->escape)
+        {
+            cur = json_parser_escape(p, cur, end);
+            if (p->state == JSON_PS_ERROR) return cur;
+            start = cur;
+            continue;
+        }
+
+        cur = json_scan_string(cur, end);
+        if (cur == end) break;
+
+        if (*cur == '\"')
+        {
+            if (p->buffered)
+            {
+                if (!json_parser_put(p, start, cur - start) ||
+                    !json_parser_flush_surrogate(p))
+                {
+                    p->state = JSON_PS_ERROR;
+                    return cur;
+                }
+                value = p->buf;
+                length = p->length;
+            }
+            else
+            {
+                /* No escapes nor chunk boundaries inside */
+                value = start;
+                length = cur - start;
+            }
+            success = p->is_key ?
+                json_emit(p, object_key, (p->ctx, value, length)):
+                json_emit(p, string_value, (p->ctx, value, length));
+            if (!success)
+            {
+                p->state = JSON_PS_ERROR;
+                return cur;
+            }
+            if (p->is_key) p->state = JSON_PS_COLON;
+            else json_parser_end_value(p);
+            return cur + 1;
+        }
+        if (*cur == '\\')
+        {
+            if (!json_parser_put(p, start, cur - start))
+            {
+                p->state = JSON_PS_ERROR;
+                return cur;
+            }
+            p->buffered = 1;
+            p->escape = 1;
+            start = ++cur;
+            continue;
+        }
+
+        /* 0x00-0x1F are invalid characters for json string
+           (http://www.ietf.org/rfc/rfc4627.txt) */
+        p->state = JSON_PS_ERROR;
+        return cur;
+    }
+
+    /* The string continues to the next chunk */
+    if (!json_parser_put(p, start, cur - start))
+    {
+        p->state = JSON_PS_ERROR;
+    }
+    p->buffered = 1;
+    return cur;
+}
+
+static const char* json_parser_escape(json_parser *p,
+                                      const char *cur, const char *end)
+{
+    char c;
+    int digit;
+
+    while ((cur < end) && p->escape)
+    {
+        c = *cur++;
+        if (p->escape == 1)
+        {
+            switch (c)
+            {
+            case '\"': case '\\': case '/': break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u':
+                p->escape = 2;
+                p->code = 0;
+                continue;
+            default:
+                p->state = JSON_PS_ERROR;
+                return cur;
+            }
+            p->escape = 0;
+            if (!json_parser_put(p, &c, 1)) p->state = JSON_PS_ERROR;
+            return cur;
+        }
+
+        /* \uXXXX */
+        if (is_digit(c)) digit = c - '0';
+        else if ((c >= 'a') && (c <= 'f')) digit = c - 'a' + 10;
+        else if ((c >= 'A') && (c <= 'F')) digit = c - 'A' + 10;
+        else
+        {
+            p->state = JSON_PS_ERROR;
+            return cur;
+        }
+        p->code = (p->code << 4) | digit;
+        if (++p->escape == 6)
+        {
+            p->escape = 0;
+            if (!json_parser_put_code(p, p->code))
+                p->state = JSON_PS_ERROR;
+        }
+    }
+    return cur;
+}
+
+/* Scans a number, accumulating its decimal mantissa and exponent so
+   that the value rarely needs the text again */
+static const char* json_parser_number(json_parser *p,
+                                      const char *cur, const char *end)
+{
+    const char *start = cur;
+
+    for (; cur < end; cur++)
+    {
+        char c = *cur;
+
+        switch (p->number)
+        {
+        case JSON_NS_BEGIN:
+            if (c == '-')
+            {
+                p->negative = 1;
+                p->number = JSON_NS_SIGN;
+            }
+            else if (c == '0') p->number = JSON_NS_ZERO;
+            else
+            {
+                json_parser_digit(p, c, 0);
+                p->number = JSON_NS_INT;
+            }
+            continue;
+        case JSON_NS_SIGN:
+            if (c == '0') p->number = JSON_NS_ZERO;
+            else if (is_digit(c))
+            {
+                json_parser_digit(p, c, 0);
+                p->number = JSON_NS_INT;
+            }
+            else break;
+            continue;
+        case JSON_NS_ZERO:
+        case JSON_NS_INT:
+            if ((p->number == JSON_NS_INT) && is_digit(c))
+            {
+                json_parser_digit(p, c, 0);
+                continue;
+            }
+            if (c == '.') p->number = JSON_NS_DOT;
+            else if ((c == 'e') || (c == 'E')) p->number = JSON_NS_EXP;
+            else break;
+            continue;
+        case JSON_NS_DOT:
+        case JSON_NS_FRAC:
+            if (is_digit(c))
+            {
+                json_parser_digit(p, c, 1);
+                p->number = JSON_NS_FRAC;
+                continue;
+            }
+            if ((p->number == JSON_NS_FRAC) && ((c == 'e') || (c == 'E')))
+                p->number = JSON_NS_EXP;
+            else break;
+            continue;
+        case JSON_NS_EXP:
+            if ((c == '+') || (c == '-'))
+            {
+                p->exp_negative = (c == '-');
+                p->number = JSON_NS_EXP_SIGN;
+                continue;
+            }
+            /* fall through */
+        case JSON_NS_EXP_SIGN:
+        case JSON_NS_EXP_DIGIT:
+            if (!is_digit(c)) break;
+            if (p->exponent < NUMBER_MAX_EXPONENT)
+                p->exponent = p->exponent * 10 + (c - '0');
+            p->number = JSON_NS_EXP_DIGIT;
+            continue;
+        }
+
+        /* The number ends just before c */
+        json_parser_end_number(p, start, cur);
+        return cur;
+    }
+
+    /* The number continues to the next chunk */
+    if (!json_parser_append(p, start, cur - start))
+    {
+        p->state = JSON_PS_ERROR;
+    }
+    p->buffered = 1;
+    return cur;
+}
+
+static void json_parser_digit(json_parser *p, char c, int fraction)
+{
+    if (p->digits < NUMBER_MAX_DIGITS)
+    {
+        p->mantissa = p->mantissa * 10 + (c - '0');
+        /* Leading zeros are not significant */
+        if (p->mantissa != 0) p->digits++;
+        if (fraction) p->exp10--;
+    }
+    else
+    {
+        /* Dropped digits are recovered from the text if nonzero */
+        if (c != '0') p->truncated = 1;
+        if (!fraction && (p->exp10 < NUMBER_MAX_EXPONENT)) p->exp10++;
+    }
+}
+
+static int json_parser_end_number(json_parser *p,
+                                  const char *start, const char *cur)
+{
+    const char *text = start;
+    size_t length = cur - start;
+
+    switch (p->number)
+    {
+    case JSON_NS_ZERO:
+    case JSON_NS_INT:
+    case JSON_NS_FRAC:
+    case JSON_NS_EXP_DIGIT:
+        break;
+    default:
+        p->state = JSON_PS_ERROR;
+        return ERROR;
+    }
+
+    if (p->buffered)
+    {
+        if (!json_parser_append(p, start, cur - start))
+        {
+            p->state = JSON_PS_ERROR;
+            return ERROR;
+        }
+        text = p->buf;
+        length = p->length;
+    }
+
+    if (!json_parser_emit_number(p, text, length))
+    {
+        p->state = JSON_PS_ERROR;
+        return ERROR;
+    }
+    json_parser_end_value(p);
+    return SUCCESS;
+}
+
+static int json_parser_emit_number(json_parser *p,
+                                   const char *text, size_t length)
+{
+    const KJSD_JSON_Handler *handler = p->handler;
+    uint64_t limit = (uint64_t)INT64_MAX + p->negative;
+    int q = p->exp10 + (p->exp_negative ? -p->exponent: p->exponent);
+    double value;
+
+    /* Integers are kept exactly unless they are -0 */
+    if (((p->number == JSON_NS_ZERO) || (p->number == JSON_NS_INT)) &&
+        !p->truncated && (p->exp10 == 0) && (p->mantissa <= limit) &&
+        !(p->negative && (p->mantissa == 0)))
+    {
+        int64_t integer = p->negative ?
+            -(int64_t)(p->mantissa - 1) - 1: (int64_t)p->mantissa;
+
+        if (handler->integer_value)
+            return handler->integer_value(p->ctx, integer);
+        value = (double)integer;
+    }
+    else if (p->truncated ||
+             !json_decimal_to_double(p->mantissa, q, p->negative, &value))
+    {
+        if (!json_strtod(text, length, &value)) return ERROR;
+    }
+
+    return json_emit(p, number_value, (p->ctx, value));
+}
+
+/* Passes over a value without tokenizing it. Strings and brackets are
+   matched, but scalars and the syntax between them are not checked. */
+static const char* json_parser_skip(json_parser *p,
+                                    const char *cur, const char *end)
+{
+    unsigned int mask;
+    size_t n;
+
+    while (cur < end)
+    {
+        if (p->skip_string)
+        {
+            if (p->escape)
+            {
+                p->escape = 0;
+                cur++;
+                continue;
+            }
+            cur = json_scan_string(cur, end);
+            if (cur == end) break;
+            if (*cur == '\\')
+            {
+                p->escape = 1;
+                cur++;
+                continue;
+            }
+            if (*cur != '\"') break;
+            p->skip_string = 0;
+            cur++;
+            if (p->skip_depth == 0)
+            {
+                json_parser_end_value(p);
+                return cur;
+            }
+            continue;
+        }
+
+        if (p->skip_scalar)
+        {
+            while ((cur < end) && !is_space(*cur) &&
+                   (*cur != ',') && (*cur != '}') && (*cur != ']')) cur++;
+            if (cur < end) json_parser_end_value(p);
+            return cur;
+        }
+
+        if (p->skip_depth == 0)
+        {
+            cur = json_skip_spaces(cur, end);
+            if (cur == end) break;
+            switch (*cur)
+            {
+            case '\"':
+                p->skip_string = 1;
+                break;
+            case '{':
+            case '[':
+                p->skip_depth = 1;
+                break;
+            case ',':
+            case '}':
+            case ']':
+                p->state = JSON_PS_ERROR;
+                return cur;
+            default:
+                p->skip_scalar = 1;
+                continue;
+            }
+            cur++;
+            continue;
+        }
+
+        /* Inside a container only quotes and brackets matter */
+        n = ((size_t)(end - cur) < JSON_STRUCTURAL_BLOCK) ?
+            (size_t)(end - cur): JSON_STRUCTURAL_BLOCK;
+        mask = json_structural_mask(cur, n);
+        if (mask == 0)
+        {
+            cur += n;
+            continue;
+        }
+        cur += json_ctz(mask);
+        switch (*cur++)
+        {
+        case '\"':
+            p->skip_string = 1;
+            break;
+        case '{':
+        case '[':
+            p->skip_depth++;
+            break;
+        case '}':
+        case ']':
+            if (--p->skip_depth == 0)
+            {
+                json_parser_end_value(p);
+                return cur;
+            }
+            break;
+        default:
+            p->state = JSON_PS_ERROR;
+            return cur - 1;
+        }
+    }
+
+    /* A control character inside a string */
+    if (cur < end) p->state = JSON_PS_ERROR;
+    return cur;
+}
+
+static const char* json_parser_literal(json_parser *p,
+                                       const char *cur, const char *end)
+{
+    int success;
+
+    while (p->literal[p->literal_pos] != '\0')
+    {
+        if (cur == end) return cur;
+        if (*cur != p->literal[p->literal_pos])
+        {
+            p->state = JSON_PS_ERROR;
+            return cur;
+        }
+        cur++;
+        p->literal_pos++;
+    }
+
+    switch (p->literal[0])
+    {
+    case 't':
+        success = json_emit(p, bool_value, (p->ctx, 1));
+        break;
+    case 'f':
+        success = json_emit(p, bool_value, (p->ctx, 0));
+        break;
+    default:
+        success = json_emit(p, null_value, (p->ctx));
+        break;
+    }
+    if (success) json_parser_end_value(p);
+    else p->state = JSON_PS_ERROR;
+    return cur;
+}
+
+static int json_parser_append(json_parser *p, const char *data, size_t n)
+{
+    if (n == 0) return SUCCESS;
+
+    if (p->length + n > p->capacity)
+    {
+        size_t new_capacity = MAX(p->capacity * 2, p->length + n);
+        new_capacity = MAX(new_capacity, 64);
+        if (try_realloc(NULL, (void**)&p->buf, p->capacity, new_capacity)
+            == ERROR) return ERROR;
+        p->capacity = new_capacity;
+    }
+    memcpy(p->buf + p->length, data, n);
+    p->length += n;
+    return SUCCESS;
+}
+
+/* Appends a part of string, encoding a pending high surrogate first */
+static int json_parser_put(json_parser *p, const char *data, size_t n)
+{
+    if (n == 0) return SUCCESS;
+    if (!json_parser_flush_surrogate(p)) return ERROR;
+
+    return json_parser_append(p, data, n);
+}
+
+static int json_parser_put_code(json_parser *p, unsigned int code)
+{
+    if ((code >= 0xDC00) && (code <= 0xDFFF) && p->surrogate)
+    {
+        code = 0x10000 + ((p->surrogate - 0xD800) << 10) + (code - 0xDC00);
+        p->surrogate = 0;
+        return json_parser_put_utf8(p, code);
+    }
+
+    if (!json_parser_flush_surrogate(p)) return ERROR;
+    if ((code >= 0xD800) && (code <= 0xDBFF))
+    {
+        /* Wait for the low surrogate */
+        p->surrogate = code;
+        return SUCCESS;
+    }
+    return json_parser_put_utf8(p, code);
+}
+
+/* Encodes code as UTF-8. A lone surrogate is encoded as it is. */
+static int json_parser_put_utf8(json_parser *p, unsigned int code)
+{
+    char utf8[4];
+    size_t n;
+
+    if (code < 0x80)
+    {
+        utf8[0] = code;
+        n = 1;
+    }
+    else if (code < 0x800)
+    {
+        utf8[0] = (code >> 6) | 0xC0;
+        utf8[1] = (code & 0x3F) | 0x80;
+        n = 2;
+    }
+    else if (code < 0x10000)
+    {
+        utf8[0] = (code >> 12) | 0xE0;
+        utf8[1] = ((code >> 6) & 0x3F) | 0x80;
+        utf8[2] = (code & 0x3F) | 0x80;
+        n = 3;
+    }
+    else
+    {
+        utf8[0] = (code >> 18) | 0xF0;
+        utf8[1] = ((code >> 12) & 0x3F) | 0x80;
+        utf8[2] = ((code >> 6) & 0x3F) | 0x80;
+        utf8[3] = (code & 0x3F) | 0x80;
+        n = 4;
+    }
+    return json_parser_append(p, utf8, n);
+}
+
+static int json_parser_flush_surrogate(json_parser *p)
+{
+    unsigned int code = p->surrogate;
+
+    if (code == 0) return SUCCESS;
+
+    /* A lone high surrogate is kept as it is */
+    p->surrogate = 0;
+    return json_parser_put_utf8(p, code);
+}
+
+static int json_parse_file(json_parser *p, FILE* in, int container_only)
+{
+    char *chunk = (char*)json_malloc(PARSER_CHUNK_SIZE);
+    size_t size;
+    int first = 1;
+
+    if (!chunk) return ERROR;
+
+    while ((p->state != JSON_PS_DONE) && (p->state != JSON_PS_ERROR))
+    {
+        size = fread(chunk, 1, PARSER_CHUNK_SIZE, in);
+        if (size == 0) break;
+
+        if (first && container_only && (*chunk != '{') && (*chunk != '['))
+        {
+            p->state = JSON_PS_ERROR;
+            break;
+        }
+        first = 0;
+        json_parser_feed(p, chunk, size);
+    }
+    json_free(chunk);
+    return json_parser_finish(p);
+}
+
+/* DOM builder */
+static void json_builder_init(json_builder *b, KJSD_JSON_Arena *arena)
+{
+    memset(b, 0, sizeof(json_builder));
+    b->arena = arena;
+}
+
+static KJSD_JSON_Value* json_builder_finish(json_builder *b, int success)
+{
+    json_intern_release(&b->keys);
+    json_builder_discard(b);
+    json_free(b->scalars);
+    if (!success)
+    {
+        json_value_free(b->arena, b->root);
+        return NULL;
+    }
+    return b->root;
+}
+
+/* Discards a partial document. A heap document taken before keeps the
+   names it holds, but no longer shares them with the next one. */
+static void json_builder_reset(json_builder *b)
+{
+    json_value_free(b->arena, b->root);
+    json_intern_release(&b->keys);
+    json_builder_discard(b);
+    b->root = NULL;
+    b->depth = 0;
+}
+
+/* Drops the scalars staged for the containers left open */
+static void json_builder_discard(json_builder *b)
+{
+    while (b->scalar_count > 0)
+    {
+        KJSD_JSON_free(&b->scalars[--b->scalar_count].value);
+    }
+}
+
+/* Returns a new scalar to be passed to json_builder_add. A member or
+   item of a heap container is staged in the builder instead of being
+   allocated alone. */
+static KJSD_JSON_Value* json_builder_value(json_builder *b,
+                                           KJSD_JSON_Type type)
+{
+    KJSD_JSON_Value *value;
+
+    if (b->arena || (b->depth == 0)) return json_value_alloc(b->arena, type);
+
+    if (b->scalar_count >= b->scalar_capacity)
+    {
+        size_t new_capacity =
+            json_grow_capacity(b->scalar_capacity, 0, sizeof(json_scalar));
+        if ((new_capacity == 0) ||
+            (try_realloc(NULL, (void**)&b->scalars,
+                         b->scalar_capacity * sizeof(json_scalar),
+                         new_capacity * sizeof(json_scalar)) == ERROR))
+            return NULL;
+        b->scalar_capacity = new_capacity;
+    }
+
+    value = &b->scalars[b->scalar_count].value;
+    value->type = type;
+    value->is_integer = 0;
+    value->is_inline = 1;
+    return value;
+}
+
+/* Attaches a new value to the current container */
+static int json_builder_add(json_builder *b, KJSD_JSON_Value *value)
+{
+    KJSD_JSON_Value *parent;
+    KJSD_JSON_Value *slot;
+    int success;
+
+    if (!value) return ERROR;
+
+    if (b->depth == 0)
+    {
+        b->root = value;
+        return SUCCESS;
+    }
+
+    /* A staged scalar takes its slot when the container closes */
+    slot = value->is_inline ? NULL: value;
+    parent = b->stack[b->depth - 1];
+    if ((parent->type == KJSD_JSON_OBJECT) && b->insitu)
+    {
+        success = json_object_insert(parent->value.object,
+                                     b->name, b->key_length, slot);
+    }
+    else if (parent->type == KJSD_JSON_OBJECT)
+    {
+        success = json_object_add_key(parent->value.object,
+                                      b->name, b->key_length, slot);
+    }
+    else
+    {
+        success = json_array_add(parent->value.array, slot);
+    }
+    if (!success)
+    {
+        json_value_free(b->arena, value);
+    }
+    else if (value->is_inline)
+    {
+        b->scalars[b->scalar_count++].slot =
+            (parent->type == KJSD_JSON_OBJECT) ?
+            parent->value.object->count - 1: parent->value.array->count - 1;
+    }
+    return success;
+}
+
+/* Moves the scalars staged for a closing container into a block of
+   its own, so that they lie together in the order they were parsed */
+static int json_builder_inline(json_builder *b, KJSD_JSON_Value *value)
+{
+    size_t base = b->scalar_base[b->depth];
+    size_t n = b->scalar_count - base;
+    json_value_block *block;
+    json_value_block **blocks;
+    KJSD_JSON_Value **slots;
+    KJSD_JSON_Value *values;
+    size_t i;
+
+    if (n == 0) return SUCCESS;
+
+    block = (json_value_block*)json_malloc(
+        ARENA_ALIGN(sizeof(json_value_block)) + n * sizeof(KJSD_JSON_Value));
+    if (!block) return ERROR;
+
+    if (value->type == KJSD_JSON_OBJECT)
+    {
+        slots = value->value.object->values;
+        blocks = &value->value.object->blocks;
+    }
+    else
+    {
+        slots = value->value.array->items;
+        blocks = &value->value.array->blocks;
+    }
+
+    values = json_block_values(block);
+    for (i = 0; i < n; i++)
+    {
+        values[i] = b->scalars[base + i].value;
+        slots[b->scalars[base + i].slot] = &values[i];
+    }
+    block->next = *blocks;
+    *blocks = block;
+    b->scalar_count = base;
+    return SUCCESS;
+}
+
+/* Terminates a string lying in the in situ buffer. The closing quote
+   has already been scanned, so it can be overwritten. */
+static const char* json_builder_insitu(json_builder *b,
+                                       const char *string, size_t length)
+{
+    char *p = (char*)string;
+
+    if (!b->insitu ||
+        (p < b->insitu) || (p + length >= b->insitu_end)) return NULL;
+
+    p[length] = '\0';
+    return p;
+}
+
+static int json_builder_push(json_builder *b, KJSD_JSON_Value *value)
+{
+    if (!json_builder_add(b, value)) return ERROR;
+
+    b->scalar_base[b->depth] = b->scalar_count;
+    b->stack[b->depth++] = value;
+    return SUCCESS;
+}
+
+/* Trims a container after parsing is over */
+static int json_builder_pop(void *ctx)
+{
+    json_builder *b = (json_builder*)ctx;
+    KJSD_JSON_Value *value = b->stack[--b->depth];
+    size_t count;
+
+    if (json_builder_inline(b, value) == ERROR) return ERROR;
+    if (value->type == KJSD_JSON_OBJECT)
+    {
+        count = value->value.object->count;
+        return (count == 0) ||
+            json_object_resize(value->value.object, count);
+    }
+    count = value->value.array->count;
+    return (count == 0) || json_array_resize(value->value.array, count);
+}
+
+static int json_builder_null(void *ctx)
+{
+    json_builder *b = (json_builder*)ctx;
+    return json_builder_add(b, json_builder_value(b, KJSD_JSON_NULL));
+}
+
+static int json_builder_bool(void *ctx, int value)
+{
+    json_builder *b = (json_builder*)ctx;
+    KJSD_JSON_Value *new_value = json_builder_value(b, KJSD_JSON_BOOL);
+
+    if (!new_value) return ERROR;
+    new_value->value.bool = value;
+    return json_builder_add(b, new_value);
+}
+
+static int json_builder_number(void *ctx, double value)
+{
+    json_builder *b = (json_builder*)ctx;
+    KJSD_JSON_Value *new_value = json_builder_value(b, KJSD_JSON_NUMBER);
+
+    if (!new_value) return ERROR;
+    new_value->value.number = value;
+    return json_builder_add(b, new_value);
+}
+
+static int json_builder_string(void *ctx, const char *value, size_t length)
+{
+    json_builder *b = (json_builder*)ctx;
+    const char *new_string = json_builder_insitu(b, value, length);
+    KJSD_JSON_Value *new_value;
+
+    /* Strings with escapes are unescaped out of place */
+    if (!new_string) new_string = json_strndup(b->arena, value, length);
+    if (!new_string) return ERROR;
+
+    new_value = json_builder_value(b, KJSD_JSON_STRING);
+    if (!new_value)
+    {
+        json_dealloc(b->arena, new_string);
+        return ERROR;
+    }
+    new_value->value.string = new_string;
+    return json_builder_add(b, new_value);
+}
+
+static int json_builder_integer(void *ctx, int64_t value)
+{
+    json_builder *b = (json_builder*)ctx;
+    KJSD_JSON_Value *new_value = json_builder_value(b, KJSD_JSON_NUMBER);
+
+    if (!new_value) return ERROR;
+    new_value->is_integer = 1;
+    new_value->value.integer = value;
+    return json_builder_add(b, new_value);
+}
+
+static int json_builder_start_object(void *ctx)
+{
+    json_builder *b = (json_builder*)ctx;
+    return json_builder_push(b, json_value_init_object(b->arena));
+}
+
+static int json_builder_key(void *ctx, const char *name, size_t length)
+{
+    json_builder *b = (json_builder*)ctx;
+
+    /* Names are kept '\0' terminated, so a \u0000 in them is refused
+       as the binary reader does */
+    if (memchr(name, '\0', length) != NULL) return ERROR;
+
+    b->key_length = length;
+    /* Names in situ are not interned, for the table may outlive the
+       buffer. The others are kept in the table until their value
+       comes. */
+    b->name = json_builder_insitu(b, name, length);
+    if (!b->name)
+    {
+        b->name = json_intern_key(b->arena,
+                                  json_intern_table(b->arena, &b->keys),
+                                  name, length);
+    }
+    return (b->name != NULL) ? SUCCESS: ERROR;
+}
+
+static int json_builder_start_array(void *ctx)
+{
+    json_builder *b = (json_builder*)ctx;
+    return json_builder_push(b, json_value_init_array(b->arena));
+}
+
+static KJSD_JSON_Value* json_deserialize(KJSD_JSON_Arena *arena, FILE* in)
+{
+    json_builder builder;
+    json_parser parser;
+    int success;
+
+    if (!in) return NULL;
+
+    /* A seekable stream is read from the start, as it always was.
+       Pipes can not seek and are read from where they are. */
+    if (fseek(in, 0L, SEEK_SET) != 0) clearerr(in);
+
+    json_builder_init(&builder, arena);
+    json_parser_init(&parser, &json_builder_handler, &builder);
+    success = json_parse_file(&parser, in, 1);
+    json_parser_release(&parser);
+
+    return json_builder_finish(&builder, success);
+}
+
+static KJSD_JSON_Value* json_deserialize_string(KJSD_JSON_Arena *arena,
+                                                const char *string,
+                                                char *insitu)
+{
+    if (!string) return NULL;
+
+    return json_deserialize_buffer(arena, string, strlen(string), insitu);
+}
+
+static KJSD_JSON_Value* json_deserialize_buffer(KJSD_JSON_Arena *arena,
+                                                const char *data,
+                                                size_t length,
+                                                char *insitu)
+{
+    json_builder builder;
+    json_parser parser;
+    int success;
+
+    if ((length == 0) || (*data != '{' && *data != '[')) return NULL;
+
+    json_builder_init(&builder, arena);
+    if (insitu)
+    {
+        builder.insitu = insitu;
+        builder.insitu_end = insitu + length;
+    }
+    json_parser_init(&parser, &json_builder_handler, &builder);
+    json_parser_feed(&parser, data, length);
+    success = json_parser_finish(&parser);
+    json_parser_release(&parser);
+
+    return json_builder_finish(&builder, success);
+}
+
+/* Parses a file from a read-only mapping, so its pages stay shared
+   with the page cache. In situ parsing needs a writable private
+   mapping, and it lives as long as the arena, as does the mapping a
+   lazy DOM is built from. The terminators written in situ copy nearly
+   every page of a typical document. */
+static KJSD_JSON_Value* json_deserialize_file(KJSD_JSON_Arena *arena,
+                                              const char *path,
+                                              json_load_mode mode)
+{
+    KJSD_JSON_Value *value;
+#if defined(JSON_HAVE_MMAP)
+    struct stat st;
+    json_arena_map *map = NULL;
+    void *addr;
+    size_t size;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0) ||
+        ((unsigned long long)st.st_size > (size_t)-1))
+    {
+        close(fd);
+        return NULL;
+    }
+    size = (size_t)st.st_size;
+
+    addr = mmap(NULL, size,
+                (mode == JSON_LOAD_INSITU) ? (PROT_READ | PROT_WRITE):
+                PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return NULL;
+#if defined(MADV_SEQUENTIAL)
+    if (mode != JSON_LOAD_LAZY) madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+
+    if (mode != JSON_LOAD_COPY)
+    {
+        map = (json_arena_map*)json_alloc(arena, sizeof(json_arena_map));
+        if (!map)
+        {
+            munmap(addr, size);
+            return NULL;
+        }
+    }
+
+    if (mode == JSON_LOAD_LAZY)
+    {
+        value = json_deserialize_lazy(arena, (const char*)addr, size);
+    }
+    else
+    {
+        value = json_deserialize_buffer(
+            arena, (const char*)addr, size,
+            (mode == JSON_LOAD_INSITU) ? (char*)addr: NULL);
+    }
+    if (value && map)
+    {
+        map->addr = addr;
+        map->size = size;
+        map->next = arena->maps;
+        arena->maps = map;
+    }
+    else
+    {
+        munmap(addr, size);
+    }
+#else
+    FILE *in = fopen(path, "rb");
+
+    (void)mode;
+    if (!in) return NULL;
+
+    value = json_deserialize(arena, in);
+    fclose(in);
+#endif
+    return value;
+}
+
+/* Lazy DOM */
+/* Records the span of every container in one pass over the document.
+   Only quotes, backslashes and brackets are looked at, a block of them
+   at a time; everything else is checked when the container holding it
+   is built. */
+static json_lazy_span* json_lazy_index(KJSD_JSON_Arena *arena,
+                                       const char *data, size_t length)
+{
+    const char *block;
+    const char *end = data + length;
+    json_lazy_span *spans = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    size_t stack[MAX_NESTING + 1];
+    size_t depth = 0;
+    int in_string = 0;
+    int escaped = 0;
+
+    if ((length == 0) || (*data != '{' && *data != '[')) return NULL;
+
+    for (block = data; block < end; block += JSON_STRUCTURAL_BLOCK)
+    {
+        size_t n = ((size_t)(end - block) < JSON_STRUCTURAL_BLOCK) ?
+            (size_t)(end - block): JSON_STRUCTURAL_BLOCK;
+        unsigned int mask = json_structural_mask(block, n);
+
+        /* The block began with an escaped character */
+        if (escaped) mask &= ~1u;
+        escaped = 0;
+
+        for (; mask != 0; mask &= mask - 1)
+        {
+            unsigned int i = json_ctz(mask);
+            const char *cur = block + i;
+            size_t k;
+
+            if (in_string)
+            {
+                if (*cur == '"') in_string = 0;
+                else if (*cur == '\\')
+                {
+                    if (i + 1 < n) mask &= ~(1u << (i + 1));
+                    else escaped = 1;
+                }
+                continue;
+            }
+
+            switch (*cur)
+            {
+            case '"':
+                in_string = 1;
+                break;
+            case '{':
+            case '[':
+                if (depth > MAX_NESTING) return NULL;
+                if (count >= capacity)
+                {
+                    size_t new_capacity =
+                        json_grow_capacity(capacity, 0,
+                                           sizeof(json_lazy_span));
+                    if ((new_capacity == 0) ||
+                        (try_realloc(arena, (void**)&spans,
+                                     capacity * sizeof(json_lazy_span),
+                                     new_capacity * sizeof(json_lazy_span))
+                         == ERROR)) return NULL;
+                    capacity = new_capacity;
+                }
+                spans[count].begin = cur;
+                stack[depth++] = count++;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0) return NULL;
+                k = stack[--depth];
+                if ((*spans[k].begin == '{') != (*cur == '}')) return NULL;
+                spans[k].end = cur;
+                spans[k].next = count;
+                /* What follows the root is ignored, as the other
+                   parsers do */
+                if (depth == 0) return spans;
+                break;
+            default:
+                /* A backslash outside strings fails when it is built */
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static KJSD_JSON_Value* json_lazy_value(KJSD_JSON_Arena *arena,
+                                        const json_lazy_span *spans,
+                                        size_t index)
+{
+    json_lazy *lazy = (json_lazy*)json_alloc(arena, sizeof(json_lazy));
+    KJSD_JSON_Value *value;
+
+    if (!lazy) return NULL;
+    lazy->spans = spans;
+    lazy->index = index;
+    lazy->base = NULL;
+
+    if (*spans[index].begin == '{')
+    {
+        value = json_value_init_object(arena);
+        if (value) value->value.object->lazy = lazy;
+    }
+    else
+    {
+        value = json_value_init_array(arena);
+        if (value) value->value.array->lazy = lazy;
+    }
+    return value;
+}
+
+/* Feeds the container to the tokenizer with each nested container
+   replaced by a placeholder, so the nested text is skipped without
+   being looked at. */
+static KJSD_JSON_Value* json_lazy_build(KJSD_JSON_Arena *arena,
+                                        const json_lazy *lazy)
+{
+    const json_lazy_span *spans = lazy->spans;
+    const json_lazy_span *span = &spans[lazy->index];
+    const char *cur = span->begin;
+    size_t child = lazy->index + 1;
+    json_lazy_builder l;
+    json_parser parser;
+    int success;
+
+    json_builder_init(&l.builder, arena);
+    l.spans = spans;
+    l.child = 0;
+    json_parser_init(&parser, &json_lazy_handler, &l);
+
+    for (; child < span->next; child = spans[child].next)
+    {
+        json_parser_feed(&parser, cur, spans[child].begin - cur);
+        l.child = child;
+        json_parser_feed(&parser, "null", 4);
+        cur = spans[child].end + 1;
+    }
+    json_parser_feed(&parser, cur, span->end + 1 - cur);
+    success = json_parser_finish(&parser) && (l.child == 0);
+    json_parser_release(&parser);
+
+    return json_builder_finish(&l.builder, success);
+}
+
+/* The members are built into a new container and moved over, so
+   pointers already handed out to this one stay valid */
+static int json_lazy_load_object(KJSD_JSON_Object *object)
+{
+    KJSD_JSON_Value *value;
+
+    if (object->lazy->base) return json_share_load_object(object);
+
+    value = json_lazy_build(object->arena, object->lazy);
+    if (!value || (value->type != KJSD_JSON_OBJECT)) return ERROR;
+
+    *object = *value->value.object;
+    return SUCCESS;
+}
+
+static int json_lazy_load_array(KJSD_JSON_Array *array)
+{
+    KJSD_JSON_Value *value;
+
+    if (array->lazy->base) return json_share_load_array(array);
+
+    value = json_lazy_build(array->arena, array->lazy);
+    if (!value || (value->type != KJSD_JSON_ARRAY)) return ERROR;
+
+    *array = *value->value.array;
+    return SUCCESS;
+}
+
+static int json_lazy_null(void *ctx)
+{
+    json_lazy_builder *l = (json_lazy_builder*)ctx;
+    KJSD_JSON_Value *value;
+
+    if (l->child == 0) return json_builder_null(ctx);
+
+    value = json_lazy_value(l->builder.arena, l->spans, l->child);
+    l->child = 0;
+    return json_builder_add(&l->builder, value);
+}
+
+static KJSD_JSON_Value* json_deserialize_lazy(KJSD_JSON_Arena *arena,
+                                              const char *data,
+                                              size_t length)
+{
+    json_lazy_span *spans = json_lazy_index(arena, data, length);
+
+    if (!spans) return NULL;
+
+    return json_lazy_value(arena, spans, 0);
+}
+
+/* Copy */
+
+/* An untouched shared copy reads the same as its base */
+static const KJSD_JSON_Object* json_object_source(
+    const KJSD_JSON_Object *object)
+{
+    return (object->lazy && object->lazy->base) ?
+        (const KJSD_JSON_Object*)object->lazy->base: object;
+}
+
+static const KJSD_JSON_Array* json_array_source(
+    const KJSD_JSON_Array *array)
+{
+    return (array->lazy && array->lazy->base) ?
+        (const KJSD_JSON_Array*)array->lazy->base: array;
+}
+
+/* Adds up the block json_clone carves an arena copy of the contents of
+   value from */
+static int json_clone_size(const KJSD_JSON_Value *value,
+                           size_t *size, size_t *strings)
+{
+    const KJSD_JSON_Object *object;
+    const KJSD_JSON_Array *array;
+    size_t i;
+
+    switch (value->type)
+    {
+    case KJSD_JSON_OBJECT:
+        object = json_object_source(value->value.object);
+        if (!json_object_load(object)) return ERROR;
+
+        *size += ARENA_ALIGN(sizeof(KJSD_JSON_Object));
+        if (object->count > 0)
+        {
+            *size += ARENA_ALIGN(object->count * sizeof(char*)) +
+                ARENA_ALIGN(object->count * sizeof(KJSD_JSON_Value*)) +
+                ARENA_ALIGN(object->count * sizeof(KJSD_JSON_Value));
+            if (object->index)
+            {
+                *size += ARENA_ALIGN(object->index_size * sizeof(size_t));
+            }
+        }
+        for (i = 0; i < object->count; i++)
+        {
+            if (json_clone_size(object->values[i], size, strings) == ERROR)
+                return ERROR;
+        }
+        break;
+    case KJSD_JSON_ARRAY:
+        array = json_array_source(value->value.array);
+        if (!json_array_load(array)) return ERROR;
+
+        *size += ARENA_ALIGN(sizeof(KJSD_JSON_Array));
+        if (array->count > 0)
+        {
+            *size += ARENA_ALIGN(array->count * sizeof(KJSD_JSON_Value*)) +
+                ARENA_ALIGN(array->count * sizeof(KJSD_JSON_Value));
+        }
+        for (i = 0; i < array->count; i++)
+        {
+            if (json_clone_size(array->items[i], size, strings) == ERROR)
+                return ERROR;
+        }
+        break;
+    case KJSD_JSON_STRING:
+        if (value->value.string) *strings += strlen(value->value.string) + 1;
+        break;
+    default:
+        break;
+    }
+    return SUCCESS;
+}
+
+static void* json_cloner_alloc(json_cloner *c, size_t size)
+{
+    void *ptr;
+
+    if (!c->arena) return json_malloc(size);
+
+    ptr = c->next;
+    c->next += ARENA_ALIGN(size);
+    return ptr;
+}
+
+/* Returns room for n members or items. A heap block is linked to the
+   container, which frees it after their contents. */
+static KJSD_JSON_Value* json_cloner_values(json_cloner *c, size_t n,
+                                           json_value_block **blocks)
+{
+    json_value_block *block;
+    KJSD_JSON_Value *values;
+    size_t i;
+
+    if (c->arena)
+    {
+        values = (KJSD_JSON_Value*)json_cloner_alloc(
+            c, n * sizeof(KJSD_JSON_Value));
+    }
+    else
+    {
+        block = (json_value_block*)json_malloc(
+            ARENA_ALIGN(sizeof(json_value_block)) +
+            n * sizeof(KJSD_JSON_Value));
+        if (!block) return NULL;
+
+        block->next = *blocks;
+        *blocks = block;
+        values = json_block_values(block);
+    }
+    for (i = 0; i < n; i++)
+    {
+        values[i].is_inline = (c->arena == NULL);
+    }
+    return values;
+}
+
+/* Returns the interned name of a new member */
+static const char* json_cloner_key(json_cloner *c, const char *name)
+{
+    size_t n = strlen(name);
+    const char *key;
+
+    if (c->arena) return json_intern_key(c->arena, &c->arena->keys, name, n);
+
+    key = json_intern_key(NULL, &c->keys, name, n);
+    if (key) json_key_retain(NULL, key);
+    return key;
+}
+
+static char* json_cloner_string(json_cloner *c, const char *string)
+{
+    size_t n = strlen(string);
+    char *copy;
+
+    if (!c->arena) return json_strndup(NULL, string, n);
+
+    copy = c->strings;
+    memcpy(copy, string, n + 1);
+    c->strings += n + 1;
+    return copy;
+}
+
+/* value is left a valid one on failure, so that a partial heap copy
+   can be freed */
+static int json_clone_into(json_cloner *c, KJSD_JSON_Value *value,
+                           const KJSD_JSON_Value *source)
+{
+    KJSD_JSON_Object *object;
+    KJSD_JSON_Array *array;
+    char *string = NULL;
+
+    value->type = KJSD_JSON_NULL;
+    value->is_integer = source->is_integer;
+
+    switch (source->type)
+    {
+    case KJSD_JSON_OBJECT:
+        object = (KJSD_JSON_Object*)json_cloner_alloc(
+            c, sizeof(KJSD_JSON_Object));
+        if (!object) return ERROR;
+
+        memset(object, 0, sizeof(KJSD_JSON_Object));
+        object->arena = c->arena;
+        value->type = KJSD_JSON_OBJECT;
+        value->value.object = object;
+        return json_clone_object(c, object, source->value.object);
+    case KJSD_JSON_ARRAY:
+        array = (KJSD_JSON_Array*)json_cloner_alloc(
+            c, sizeof(KJSD_JSON_Array));
+        if (!array) return ERROR;
+
+        memset(array, 0, sizeof(KJSD_JSON_Array));
+        array->arena = c->arena;
+        value->type = KJSD_JSON_ARRAY;
+        value->value.array = array;
+        return json_clone_array(c, array, source->value.array);
+    case KJSD_JSON_STRING:
+        if (source->value.string)
+        {
+            string = json_cloner_string(c, source->value.string);
+            if (!string) return ERROR;
+        }
+        value->value.string = string;
+        break;
+    default:
+        value->value = source->value;
+        break;
+    }
+    value->type = source->type;
+    return SUCCESS;
+}
+
+static int json_clone_object(json_cloner *c, KJSD_JSON_Object *object,
+                             const KJSD_JSON_Object *source)
+{
+    KJSD_JSON_Value *values;
+    size_t n, i;
+
+    source = json_object_source(source);
+    if (!json_object_load(source)) return ERROR;
+
+    n = source->count;
+    if (n == 0) return SUCCESS;
+
+    object->names = (const char**)json_cloner_alloc(c, n * sizeof(char*));
+    object->values = (KJSD_JSON_Value**)json_cloner_alloc(
+        c, n * sizeof(KJSD_JSON_Value*));
+    if (!object->names || !object->values) return ERROR;
+    object->capacity = n;
+
+    values = json_cloner_values(c, n, &object->blocks);
+    if (!values) return ERROR;
+
+    /* The names hash the same, so the index holds as it is */
+    if (source->index)
+    {
+        object->index = (size_t*)json_cloner_alloc(
+            c, source->index_size * sizeof(size_t));
+        if (!object->index) return ERROR;
+
+        memcpy(object->index, source->index,
+               source->index_size * sizeof(size_t));
+        object->index_size = source->index_size;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        const char *name = json_cloner_key(c, source->names[i]);
+        if (!name) return ERROR;
+
+        object->names[i] = name;
+        object->values[i] = &values[i];
+        object->count++;
+        if (json_clone_into(c, &values[i], source->values[i]) == ERROR)
+            return ERROR;
+    }
+    return SUCCESS;
+}
+
+static int json_clone_array(json_cloner *c, KJSD_JSON_Array *array,
+                            const KJSD_JSON_Array *source)
+{
+    KJSD_JSON_Value *values;
+    size_t n, i;
+
+    source = json_array_source(source);
+    if (!json_array_load(source)) return ERROR;
+
+    n = source->count;
+    if (n == 0) return SUCCESS;
+
+    array->items = (KJSD_JSON_Value**)json_cloner_alloc(
+        c, n * sizeof(KJSD_JSON_Value*));
+    if (!array->items) return ERROR;
+    array->capacity = n;
+
+    values = json_cloner_values(c, n, &array->blocks);
+    if (!values) return ERROR;
+
+    for (i = 0; i < n; i++)
+    {
+        array->items[i] = &values[i];
+        array->count++;
+        if (json_clone_into(c, &values[i], source->items[i]) == ERROR)
+            return ERROR;
+    }
+    return SUCCESS;
+}
+
+/* size is the room wanted in the arena block besides the copy of
+   value */
+static int json_cloner_init(json_cloner *c, KJSD_JSON_Arena *arena,
+                            const KJSD_JSON_Value *value, size_t size)
+{
+    size_t strings = 0;
+
+    memset(c, 0, sizeof(json_cloner));
+    c->arena = arena;
+    if (!arena) return SUCCESS;
+
+    /* Only the names new to the arena are allocated apart */
+    if (json_clone_size(value, &size, &strings) == ERROR) return ERROR;
+
+    c->next = (char*)json_alloc(arena, size + strings);
+    if (!c->next) return ERROR;
+    c->strings = c->next + size;
+    return SUCCESS;
+}
+
+static KJSD_JSON_Value* json_clone(KJSD_JSON_Arena *arena,
+                                   const KJSD_JSON_Value *value)
+{
+    KJSD_JSON_Value *copy;
+    json_cloner c;
+    int success;
+
+    if (json_cloner_init(&c, arena, value,
+                         ARENA_ALIGN(sizeof(KJSD_JSON_Value))) == ERROR)
+        return NULL;
+
+    copy = (KJSD_JSON_Value*)json_cloner_alloc(&c, sizeof(KJSD_JSON_Value));
+    if (!copy) return NULL;
+
+    copy->is_inline = 0;
+    success = json_clone_into(&c, copy, value);
+    json_intern_release(&c.keys);
+    if (!success)
+    {
+        json_value_free(arena, copy);
+        return NULL;
+    }
+    return copy;
+}
+
+/* Makes the emptied value a copy of source, allocated as the members
+   of a container in arena are */
+static int json_copy_value(KJSD_JSON_Arena *arena, KJSD_JSON_Value *value,
+                           const KJSD_JSON_Value *source)
+{
+    json_cloner c;
+    int success;
+
+    if (json_cloner_init(&c, arena, source, 0) == ERROR) return ERROR;
+
+    success = json_clone_into(&c, value, source);
+    json_intern_release(&c.keys);
+    return success;
+}
+
+/* Makes value a copy of base whose containers copy the members of their
+   base when they are first used. Names and strings stay those of
+   base. */
+static int json_share_value(KJSD_JSON_Arena *arena, KJSD_JSON_Value *value,
+                            const KJSD_JSON_Value *base)
+{
+    *value = *base;
+    value->is_inline = 0;
+
+    if (base->type == KJSD_JSON_OBJECT)
+    {
+        value->value.object = json_share_object(arena, base->value.object);
+        if (!value->value.object) return ERROR;
+    }
+    else if (base->type == KJSD_JSON_ARRAY)
+    {
+        value->value.array = json_share_array(arena, base->value.array);
+        if (!value->value.array) return ERROR;
+    }
+    return SUCCESS;
+}
+
+static KJSD_JSON_Object* json_share_object(KJSD_JSON_Arena *arena,
+                                           const KJSD_JSON_Object *base)
+{
+    KJSD_JSON_Object *object = json_object_init(arena);
+    json_lazy *lazy = (json_lazy*)json_alloc(arena, sizeof(json_lazy));
+
+    if (!object || !lazy) return NULL;
+
+    lazy->spans = NULL;
+    lazy->index = 0;
+    lazy->base = json_object_source(base);
+    object->lazy = lazy;
+    return object;
+}
+
+static KJSD_JSON_Array* json_share_array(KJSD_JSON_Arena *arena,
+                                         const KJSD_JSON_Array *base)
+{
+    KJSD_JSON_Array *array = json_array_init(arena);
+    json_lazy *lazy = (json_lazy*)json_alloc(arena, sizeof(json_lazy));
+
+    if (!array || !lazy) return NULL;
+
+    lazy->spans = NULL;
+    lazy->index = 0;
+    lazy->base = json_array_source(base);
+    array->lazy = lazy;
+    return array;
+}
+
+/* Copies one level of the base, leaving the nested containers shared */
+static int json_share_load_object(KJSD_JSON_Object *object)
+{
+    const KJSD_JSON_Object *base =
+        (const KJSD_JSON_Object*)object->lazy->base;
+    KJSD_JSON_Arena *arena = object->arena;
+    KJSD_JSON_Value *values;
+    size_t n, i;
+
+    if (!json_object_load(base)) return ERROR;
+
+    n = base->count;
+    if (n > 0)
+    {
+        object->names = (const char**)json_alloc(arena, n * sizeof(char*));
+        object->values = (KJSD_JSON_Value**)json_alloc(
+            arena, n * sizeof(KJSD_JSON_Value*));
+        values = (KJSD_JSON_Value*)json_alloc(
+            arena, n * sizeof(KJSD_JSON_Value));
+        if (!object->names || !object->values || !values) return ERROR;
+
+        if (base->index)
+        {
+            object->index = (size_t*)json_alloc(
+                arena, base->index_size * sizeof(size_t));
+            if (!object->index) return ERROR;
+
+            memcpy(object->index, base->index,
+                   base->index_size * sizeof(size_t));
+            object->index_size = base->index_size;
+        }
+        for (i = 0; i < n; i++)
+        {
+            if (json_share_value(arena, &values[i], base->values[i])
+                == ERROR) return ERROR;
+            object->values[i] = &values[i];
+        }
+        memcpy(object->names, base->names, n * sizeof(char*));
+    }
+    object->count = n;
+    object->capacity = n;
+    object->lazy = NULL;
+    return SUCCESS;
+}
+
+static int json_share_load_array(KJSD_JSON_Array *array)
+{
+    const KJSD_JSON_Array *base = (const KJSD_JSON_Array*)array->lazy->base;
+    KJSD_JSON_Arena *arena = array->arena;
+    KJSD_JSON_Value *values;
+    size_t n, i;
+
+    if (!json_array_load(base)) return ERROR;
+
+    n = base->count;
+    if (n > 0)
+    {
+        array->items = (KJSD_JSON_Value**)json_alloc(
+            arena, n * sizeof(KJSD_JSON_Value*));
+        values = (KJSD_JSON_Value*)json_alloc(
+            arena, n * sizeof(KJSD_JSON_Value));
+        if (!array->items || !values) return ERROR;
+
+        for (i = 0; i < n; i++)
+        {
+            if (json_share_value(arena, &values[i], base->items[i])
+                == ERROR) return ERROR;
+            array->items[i] = &values[i];
+        }
+    }
+    array->count = n;
+    array->capacity = n;
+    array->lazy = NULL;
+    return SUCCESS;
+}
+
+/* Patch */
+
+static KJSD_JSON_Arena* json_value_arena(const KJSD_JSON_Value *value)
+{
+    switch (value->type)
+    {
+    case KJSD_JSON_OBJECT:
+        return value->value.object->arena;
+    case KJSD_JSON_ARRAY:
+        return value->value.array->arena;
+    default:
+        return NULL;
+    }
+}
+
+static int json_value_equals(const KJSD_JSON_Value *a,
+                             const KJSD_JSON_Value *b)
+{
+    if (a == b) return 1;
+    if (a->type != b->type) return 0;
+
+    switch (a->type)
+    {
+    case KJSD_JSON_OBJECT:
+        return json_object_equals(a->value.object, b->value.object);
+    case KJSD_JSON_ARRAY:
+        return json_array_equals(a->value.array, b->value.array);
+    case KJSD_JSON_STRING:
+        if (!a->value.string || !b->value.string)
+            return a->value.string == b->value.string;
+        return strcmp(a->value.string, b->value.string) == 0;
+    case KJSD_JSON_NUMBER:
+        if (a->is_integer && b->is_integer)
+            return a->value.integer == b->value.integer;
+        return KJSD_JSON_valueGetNumber(a) == KJSD_JSON_valueGetNumber(b);
+    case KJSD_JSON_BOOL:
+        return !a->value.bool == !b->value.bool;
+    default:
+        return 1;
+    }
+}
+
+/* Members are matched by name through the index of b */
+static int json_object_equals(const KJSD_JSON_Object *a,
+                              const KJSD_JSON_Object *b)
+{
+    size_t i, j;
+
+    a = json_object_source(a);
+    b = json_object_source(b);
+    if (a == b) return 1;
+    if (!json_object_load(a) || !json_object_load(b) ||
+        (a->count != b->count)) return 0;
+
+    for (i = 0; i < a->count; i++)
+    {
+        j = json_object_nfind(b, a->names[i], strlen(a->names[i]));
+        if ((j == NOT_FOUND) ||
+            !json_value_equals(a->values[i], b->values[j])) return 0;
+    }
+    return 1;
+}
+
+static int json_array_equals(const KJSD_JSON_Array *a,
+                             const KJSD_JSON_Array *b)
+{
+    size_t i;
+
+    a = json_array_source(a);
+    b = json_array_source(b);
+    if (a == b) return 1;
+    if (!json_array_load(a) || !json_array_load(b) ||
+        (a->count != b->count)) return 0;
+
+    for (i = 0; i < a->count; i++)
+    {
+        if (!json_value_equals(a->items[i], b->items[i])) return 0;
+    }
+    return 1;
+}
+
+/* Decodes the reference token following the '/' at *cur into buf */
+static int json_pointer_token(const char **cur, char *buf, size_t *n)
+{
+    const char *p = *cur + 1;
+    size_t i = 0;
+
+    for (; (*p != '\0') && (*p != '/'); p++)
+    {
+        if (*p == '~')
+        {
+            p++;
+            if (*p == '0') buf[i++] = '~';
+            else if (*p == '1') buf[i++] = '/';
+            else return ERROR;
+        }
+        else
+        {
+            buf[i++] = *p;
+        }
+    }
+    buf[i] = '\0';
+    *n = i;
+    *cur = p;
+    return SUCCESS;
+}
+
+static int json_pointer_index(const char *token, size_t n, size_t *index)
+{
+    size_t i, value = 0;
+
+    /* No sign and no leading zero */
+    if ((n == 0) || ((n > 1) && (token[0] == '0'))) return ERROR;
+
+    for (i = 0; i < n; i++)
+    {
+        if (!is_digit(token[i]) || (value > ((size_t)-1 - 9) / 10))
+            return ERROR;
+        value = value * 10 + (token[i] - '0');
+    }
+    *index = value;
+    return SUCCESS;
+}
+
+static KJSD_JSON_Value* json_pointer_child(const KJSD_JSON_Value *value,
+                                           const char *token, size_t n)
+{
+    size_t index;
+
+    if (value->type == KJSD_JSON_OBJECT)
+        return json_object_nget_value(value->value.object, token, n);
+
+    if ((value->type != KJSD_JSON_ARRAY) ||
+        (json_pointer_index(token, n, &index) == ERROR)) return NULL;
+    return KJSD_JSON_arrayGetValue(value->value.array, index);
+}
+
+/* Returns the container holding what pointer refers to, with the last
+   token decoded into buf. buf must be as long as pointer. */
+static KJSD_JSON_Value* json_pointer_parent(KJSD_JSON_Value *root,
+                                            const char *pointer,
+                                            char *buf, size_t *n)
+{
+    KJSD_JSON_Value *value = root;
+    const char *cur = pointer;
+
+    if (*cur != '/') return NULL;
+
+    while (json_pointer_token(&cur, buf, n) == SUCCESS)
+    {
+        if (*cur == '\0')
+        {
+            return ((value->type == KJSD_JSON_OBJECT) ||
+                    (value->type == KJSD_JSON_ARRAY)) ? value: NULL;
+        }
+        value = json_pointer_child(value, buf, *n);
+        if (!value) return NULL;
+    }
+    return NULL;
+}
+
+static KJSD_JSON_Value* json_pointer_get(KJSD_JSON_Value *root,
+                                         const char *pointer, char *buf)
+{
+    KJSD_JSON_Value *parent;
+    size_t n;
+
+    if (*pointer == '\0') return root;
+
+    parent = json_pointer_parent(root, pointer, buf, &n);
+    return parent ? json_pointer_child(parent, buf, n): NULL;
+}
+
+/* Returns the emptied value pointer refers to, added first unless
+   replace is set, and the arena its contents go to */
+static KJSD_JSON_Value* json_patch_slot(KJSD_JSON_Value *root,
+                                        const char *pointer, char *buf,
+                                        int replace,
+                                        KJSD_JSON_Arena **arena)
+{
+    KJSD_JSON_Value *parent;
+    KJSD_JSON_Object *object;
+    KJSD_JSON_Array *array;
+    size_t n, index;
+
+    if (*pointer == '\0')
+    {
+        *arena = json_value_arena(root);
+        json_value_reuse(*arena, root, KJSD_JSON_NULL);
+        return root;
+    }
+
+    parent = json_pointer_parent(root, pointer, buf, &n);
+    if (!parent) return NULL;
+
+    if (parent->type == KJSD_JSON_OBJECT)
+    {
+        object = parent->value.object;
+        if (replace && (json_object_nfind(object, buf, n) == NOT_FOUND))
+            return NULL;
+
+        *arena = object->arena;
+        return json_object_set(object, buf, KJSD_JSON_NULL);
+    }
+
+    array = parent->value.array;
+    *arena = array->arena;
+    if (!replace && (n == 1) && (buf[0] == '-'))
+        return json_array_insert(array, KJSD_JSON_arrayGetCount(array),
+                                 KJSD_JSON_NULL);
+    if (json_pointer_index(buf, n, &index) == ERROR) return NULL;
+
+    return replace ? json_array_set(array, index, KJSD_JSON_NULL):
+        json_array_insert(array, index, KJSD_JSON_NULL);
+}
+
+static int json_patch_put(KJSD_JSON_Value *root, const char *path,
+                          const KJSD_JSON_Value *value, char *buf,
+                          int replace)
+{
+    KJSD_JSON_Arena *arena;
+    KJSD_JSON_Value *slot;
+
+    if (!value) return ERROR;
+
+    slot = json_patch_slot(root, path, buf, replace, &arena);
+    return slot ? json_copy_value(arena, slot, value): ERROR;
+}
+
+static int json_patch_remove(KJSD_JSON_Value *parent,
+                             const char *token, size_t n)
+{
+    size_t index;
+
+    if (parent->type == KJSD_JSON_OBJECT)
+        return KJSD_JSON_objectRemove(parent->value.object, token);
+
+    return (json_pointer_index(token, n, &index) == SUCCESS) &&
+        KJSD_JSON_arrayRemove(parent->value.array, index);
+}
+
+/* Gives the contents of value to slot */
+static void json_patch_adopt(KJSD_JSON_Value *slot,
+                             const KJSD_JSON_Value *value)
+{
+    slot->type = value->type;
+    slot->is_integer = value->is_integer;
+    slot->value = value->value;
+}
+
+/* The value is taken out of its place, so a container is moved
+   without being copied */
+static int json_patch_move(KJSD_JSON_Value *root, const char *from,
+                           const char *path, char *buf)
+{
+    size_t n = strlen(from);
+    KJSD_JSON_Value *parent;
+    KJSD_JSON_Value *value;
+    KJSD_JSON_Value *slot;
+    KJSD_JSON_Value moved;
+    KJSD_JSON_Arena *arena;
+
+    if (strcmp(from, path) == 0)
+        return json_pointer_get(root, from, buf) != NULL;
+
+    /* Not into one of its own members */
+    if ((strncmp(path, from, n) == 0) && (path[n] == '/')) return ERROR;
+
+    parent = json_pointer_parent(root, from, buf, &n);
+    if (!parent) return ERROR;
+    value = json_pointer_child(parent, buf, n);
+    if (!value) return ERROR;
+
+    moved = *value;
+    value->type = KJSD_JSON_NULL;
+    arena = json_value_arena(parent);
+    if (json_patch_remove(parent, buf, n) == ERROR)
+    {
+        json_patch_adopt(value, &moved);
+        return ERROR;
+    }
+
+    slot = json_patch_slot(root, path, buf, 0, &arena);
+    if (!slot)
+    {
+        json_value_reuse(arena, &moved, KJSD_JSON_NULL);
+        return ERROR;
+    }
+    json_patch_adopt(slot, &moved);
+    return SUCCESS;
+}
+
+static int json_patch_copy(KJSD_JSON_Value *root, const char *from,
+                           const char *path, char *buf)
+{
+    KJSD_JSON_Value *source = json_pointer_get(root, from, buf);
+    KJSD_JSON_Value *parent = root;
+    KJSD_JSON_Value *copy;
+    KJSD_JSON_Value *slot;
+    KJSD_JSON_Arena *arena;
+    size_t n;
+
+    if (!source) return ERROR;
+    if (*path != '\0')
+    {
+        parent = json_pointer_parent(root, path, buf, &n);
+        if (!parent) return ERROR;
+    }
+
+    /* Copied first, as the target may hold the source */
+    arena = json_value_arena(parent);
+    copy = json_clone(arena, source);
+    if (!copy) return ERROR;
+
+    slot = json_patch_slot(root, path, buf, 0, &arena);
+    if (!slot)
+    {
+        json_value_free(arena, copy);
+        return ERROR;
+    }
+    json_patch_adopt(slot, copy);
+    json_dealloc(arena, copy);
+    return SUCCESS;
+}
+
+static int json_patch_op(KJSD_JSON_Value *root, const KJSD_JSON_Object *op)
+{
+    const char *name = KJSD_JSON_objectGetString(op, "op");
+    const char *path = KJSD_JSON_objectGetString(op, "path");
+    const char *from = KJSD_JSON_objectGetString(op, "from");
+    const KJSD_JSON_Value *value = KJSD_JSON_objectGetValue(op, "value");
+    KJSD_JSON_Value *target;
+    KJSD_JSON_Value *parent;
+    size_t n;
+    char *buf;
+    int success = ERROR;
+
+    if (!name || !path) return ERROR;
+
+    buf = (char*)json_malloc(strlen(path) + (from ? strlen(from): 0) + 1);
+    if (!buf) return ERROR;
+
+    if (strcmp(name, "add") == 0)
+    {
+        success = json_patch_put(root, path, value, buf, 0);
+    }
+    else if (strcmp(name, "remove") == 0)
+    {
+        parent = json_pointer_parent(root, path, buf, &n);
+        success = parent && json_patch_remove(parent, buf, n);
+    }
+    else if (strcmp(name, "replace") == 0)
+    {
+        success = json_patch_put(root, path, value, buf, 1);
+    }
+    else if (strcmp(name, "move") == 0)
+    {
+        success = from && json_patch_move(root, from, path, buf);
+    }
+    else if (strcmp(name, "copy") == 0)
+    {
+        success = from && json_patch_copy(root, from, path, buf);
+    }
+    else if (strcmp(name, "test") == 0)
+    {
+        target = json_pointer_get(root, path, buf);
+        success = value && target && json_value_equals(target, value);
+    }
+    json_free(buf);
+    return success;
+}
+
+static int json_merge_patch(KJSD_JSON_Arena *arena, KJSD_JSON_Value *target,
+                            const KJSD_JSON_Value *patch)
+{
+    const KJSD_JSON_Object *members;
+    KJSD_JSON_Object *object;
+    KJSD_JSON_Value *value;
+    size_t i;
+
+    if (patch->type != KJSD_JSON_OBJECT)
+    {
+        json_value_reuse(arena, target, KJSD_JSON_NULL);
+        return json_copy_value(arena, target, patch);
+    }
+
+    if (target->type != KJSD_JSON_OBJECT)
+    {
+        object = json_object_init(arena);
+        if (!object) return ERROR;
+
+        json_value_reuse(arena, target, KJSD_JSON_OBJECT);
+        target->value.object = object;
+    }
+    object = target->value.object;
+
+    members = json_object_source(patch->value.object);
+    if (!json_object_load(members)) return ERROR;
+
+    for (i = 0; i < members->count; i++)
+    {
+        const char *name = members->names[i];
+
+        if (members->values[i]->type == KJSD_JSON_NULL)
+        {
+            KJSD_JSON_objectRemove(object, name);
+            continue;
+        }
+        value = json_object_nget_value(object, name, strlen(name));
+        if (!value) value = json_object_set(object, name, KJSD_JSON_NULL);
+        if (!value ||
+            (json_merge_patch(object->arena, value, members->values[i])
+             == ERROR)) return ERROR;
+    }
+    return SUCCESS;
+}
+
+static int json_differ_push(json_differ *d, const char *token, size_t n)
+{
+    size_t need = d->length + 2 * n + 2;
+    size_t i;
+
+    if (need > d->capacity)
+    {
+        size_t new_capacity = MAX(need, d->capacity * 2);
+
+        if (try_realloc(NULL, (void**)&d->path, d->capacity, new_capacity)
+            == ERROR) return ERROR;
+        d->capacity = new_capacity;
+    }
+
+    d->path[d->length++] = '/';
+    for (i = 0; i < n; i++)
+    {
+        if (token[i] == '~')
+        {
+            d->path[d->length++] = '~';
+            d->path[d->length++] = '0';
+        }
+        else if (token[i] == '/')
+        {
+            d->path[d->length++] = '~';
+            d->path[d->length++] = '1';
+        }
+        else
+        {
+            d->path[d->length++] = token[i];
+        }
+    }
+    d->path[d->length] = '\0';
+    return SUCCESS;
+}
+
+static int json_differ_push_index(json_differ *d, size_t index)
+{
+    char buf[NUMBER_BUF_SIZE];
+
+    return json_differ_push(d, buf, json_format_integer((int64_t)index, buf));
+}
+
+static void json_differ_pop(json_differ *d, size_t length)
+{
+    d->length = length;
+    if (d->path) d->path[length] = '\0';
+}
+
+static int json_differ_op(json_differ *d, const char *op,
+                          const KJSD_JSON_Value *value)
+{
+    KJSD_JSON_Object *object = KJSD_JSON_arrayAddObject(d->ops);
+    KJSD_JSON_Value *slot;
+
+    if (!object || !KJSD_JSON_objectAddString(object, "op", op) ||
+        !KJSD_JSON_objectAddString(object, "path",
+                                   (d->length > 0) ? d->path: ""))
+        return ERROR;
+    if (!value) return SUCCESS;
+
+    slot = json_object_set(object, "value", KJSD_JSON_NULL);
+    return slot ? json_copy_value(NULL, slot, value): ERROR;
+}
+
+static int json_diff_value(json_differ *d, const KJSD_JSON_Value *from,
+                           const KJSD_JSON_Value *to)
+{
+    if ((from->type == KJSD_JSON_OBJECT) && (to->type == KJSD_JSON_OBJECT))
+        return json_diff_object(d, from->value.object, to->value.object);
+    if ((from->type == KJSD_JSON_ARRAY) && (to->type == KJSD_JSON_ARRAY))
+        return json_diff_array(d, from->value.array, to->value.array);
+
+    return json_value_equals(from, to) ? SUCCESS:
+        json_differ_op(d, "replace", to);
+}
+
+/* Members are matched by name through the indexes, and containers
+   shared by both sides are skipped */
+static int json_diff_object(json_differ *d, const KJSD_JSON_Object *a,
+                            const KJSD_JSON_Object *b)
+{
+    size_t length = d->length;
+    size_t i, j, n;
+    int success;
+
+    a = json_object_source(a);
+    b = json_object_source(b);
+    if (a == b) return SUCCESS;
+    if (!json_object_load(a) || !json_object_load(b)) return ERROR;
+
+    for (i = 0; i < a->count; i++)
+    {
+        n = strlen(a->names[i]);
+        if (json_object_nfind(b, a->names[i], n) != NOT_FOUND) continue;
+
+        success = json_differ_push(d, a->names[i], n) &&
+            json_differ_op(d, "remove", NULL);
+        json_differ_pop(d, length);
+        if (!success) return ERROR;
+    }
+    for (i = 0; i < b->count; i++)
+    {
+        n = strlen(b->names[i]);
+        j = json_object_nfind(a, b->names[i], n);
+
+        success = json_differ_push(d, b->names[i], n) &&
+            ((j == NOT_FOUND) ? json_differ_op(d, "add", b->values[i]):
+             json_diff_value(d, a->values[j], b->values[i]));
+        json_differ_pop(d, length);
+        if (!success) return ERROR;
+    }
+    return SUCCESS;
+}
+
+/* Items are compared by position once the common head and tail are
+   left out. The rest of the longer side is removed or added. */
+static int json_diff_array(json_differ *d, const KJSD_JSON_Array *a,
+                           const KJSD_JSON_Array *b)
+{
+    size_t length = d->length;
+    size_t head = 0, tail = 0;
+    size_t i, n, m, common;
+    int success = SUCCESS;
+
+    a = json_array_source(a);
+    b = json_array_source(b);
+    if (a == b) return SUCCESS;
+    if (!json_array_load(a) || !json_array_load(b)) return ERROR;
+
+    n = a->count;
+    m = b->count;
+    while ((head < n) && (head < m) &&
+           json_value_equals(a->items[head], b->items[head])) head++;
+    while ((tail < n - head) && (tail < m - head) &&
+           json_value_equals(a->items[n - 1 - tail],
+                             b->items[m - 1 - tail])) tail++;
+    common = head + ((n < m) ? n - head - tail: m - head - tail);
+
+    for (i = head; success && (i < common); i++)
+    {
+        success = json_differ_push_index(d, i) &&
+            json_diff_value(d, a->items[i], b->items[i]);
+        json_differ_pop(d, length);
+    }
+    /* From the end, so that the indexes hold */
+    for (i = n - tail; success && (i > common); i--)
+    {
+        success = json_differ_push_index(d, i - 1) &&
+            json_differ_op(d, "remove", NULL);
+        json_differ_pop(d, length);
+    }
+    for (i = common; success && (i < m - tail); i++)
+    {
+        success = json_differ_push_index(d, i) &&
+            json_differ_op(d, "add", b->items[i]);
+        json_differ_pop(d, length);
+    }
+    return success;
+}
+
+/* patch is an emptied value. A member set to null in to cannot be told
+   from a removed one. */
+static int json_merge_diff(KJSD_JSON_Value *patch,
+                           const KJSD_JSON_Value *from,
+                           const KJSD_JSON_Value *to)
+{
+    const KJSD_JSON_Object *a;
+    const KJSD_JSON_Object *b;
+    KJSD_JSON_Object *object;
+    KJSD_JSON_Value *slot;
+    size_t i, j;
+
+    if ((from->type != KJSD_JSON_OBJECT) || (to->type != KJSD_JSON_OBJECT))
+        return json_copy_value(NULL, patch, to);
+
+    object = json_object_init(NULL);
+    if (!object) return ERROR;
+    patch->type = KJSD_JSON_OBJECT;
+    patch->value.object = object;
+
+    a = json_object_source(from->value.object);
+    b = json_object_source(to->value.object);
+    if (a == b) return SUCCESS;
+    if (!json_object_load(a) || !json_object_load(b)) return ERROR;
+
+    for (i = 0; i < a->count; i++)
+    {
+        if ((json_object_nfind(b, a->names[i], strlen(a->names[i]))
+             == NOT_FOUND) &&
+            !json_object_set(object, a->names[i], KJSD_JSON_NULL))
+            return ERROR;
+    }
+    for (i = 0; i < b->count; i++)
+    {
+        j = json_object_nfind(a, b->names[i], strlen(b->names[i]));
+        if ((j != NOT_FOUND) &&
+            json_value_equals(a->values[j], b->values[i])) continue;
+
+        slot = json_object_set(object, b->names[i], KJSD_JSON_NULL);
+        if (!slot) return ERROR;
+        if (((j == NOT_FOUND) ?
+             json_copy_value(NULL, slot, b->values[i]):
+             json_merge_diff(slot, a->values[j], b->values[i])) == ERROR)
+            return ERROR;
+    }
+    return SUCCESS;
+}
+
+/* Binding */
+static void json_bind_init(json_binder *b, const KJSD_JSON_Field *fields,
+                           void *out)
+{
+    memset(b, 0, sizeof(json_binder));
+    json_parser_init(&b->parser, &json_bind_handler, b);
+    b->fields = fields;
+    b->out = out;
+}
+
+/* Returns the field of the current value if it has the type */
+static const KJSD_JSON_Field* json_bind_take(json_binder *b,
+                                             KJSD_JSON_FieldType type)
+{
+    const KJSD_JSON_Field *field = b->field;
+
+    b->field = NULL;
+    return (field && (field->type == type)) ? field: NULL;
+}
+
+static int json_bind_store_integer(void *ptr, size_t size, int64_t value)
+{
+    switch (size)
+    {
+    case sizeof(int8_t):
+        if ((value < INT8_MIN) || (value > INT8_MAX)) return ERROR;
+        *(int8_t*)ptr = (int8_t)value;
+        return SUCCESS;
+    case sizeof(int16_t):
+        if ((value < INT16_MIN) || (value > INT16_MAX)) return ERROR;
+        *(int16_t*)ptr = (int16_t)value;
+        return SUCCESS;
+    case sizeof(int32_t):
+        if ((value < INT32_MIN) || (value > INT32_MAX)) return ERROR;
+        *(int32_t*)ptr = (int32_t)value;
+        return SUCCESS;
+    case sizeof(int64_t):
+        *(int64_t*)ptr = value;
+        return SUCCESS;
+    default:
+        return ERROR;
+    }
+}
+
+static int json_bind_null(void *ctx)
+{
+    json_binder *b = (json_binder*)ctx;
+
+    /* The member keeps its value */
+    b->field = NULL;
+    return b->depth > 0;
+}
+
+static int json_bind_bool(void *ctx, int value)
+{
+    json_binder *b = (json_binder*)ctx;
+    const KJSD_JSON_Field *field = json_bind_take(b, KJSD_JSON_FIELD_BOOL);
+
+    return field &&
+        json_bind_store_integer(b->stack[b->depth - 1].base + field->offset,
+                                field->size, value);
+}
+
+static int json_bind_number(void *ctx, double value)
+{
+    json_binder *b = (json_binder*)ctx;
+    const KJSD_JSON_Field *field = json_bind_take(b, KJSD_JSON_FIELD_NUMBER);
+    char *ptr;
+
+    if (!field) return ERROR;
+
+    ptr = b->stack[b->depth - 1].base + field->offset;
+    if (field->size == sizeof(double)) *(double*)ptr = value;
+    else if (field->size == sizeof(float)) *(float*)ptr = (float)value;
+    else return ERROR;
+    return SUCCESS;
+}
+
+static int json_bind_integer(void *ctx, int64_t value)
+{
+    json_binder *b = (json_binder*)ctx;
+    const KJSD_JSON_Field *field = b->field;
+
+    if (field && (field->type == KJSD_JSON_FIELD_NUMBER))
+    {
+        return json_bind_number(ctx, (double)value);
+    }
+
+    field = json_bind_take(b, KJSD_JSON_FIELD_INTEGER);
+    return field &&
+        json_bind_store_integer(b->stack[b->depth - 1].base + field->offset,
+                                field->size, value);
+}
+
+static int json_bind_string(void *ctx, const char *value, size_t length)
+{
+    json_binder *b = (json_binder*)ctx;
+    const KJSD_JSON_Field *field = json_bind_take(b, KJSD_JSON_FIELD_STRING);
+    char *ptr;
+
+    /* The terminator must fit too */
+    if (!field || (length >= field->size)) return ERROR;
+
+    ptr = b->stack[b->depth - 1].base + field->offset;
+    memcpy(ptr, value, length);
+    ptr[length] = '\0';
+    return SUCCESS;
+}
+
+static int json_bind_start_object(void *ctx)
+{
+    json_binder *b = (json_binder*)ctx;
+    json_bind_frame *frame = &b->stack[b->depth];
+    const KJSD_JSON_Field *field;
+
+    if (b->depth == 0)
+    {
+        frame->fields = b->fields;
+        frame->base = (char*)b->out;
+    }
+    else
+    {
+        field = json_bind_take(b, KJSD_JSON_FIELD_OBJECT);
+        if (!field || !field->fields) return ERROR;
+        frame->fields = field->fields;
+        frame->base = b->stack[b->depth - 1].base + field->offset;
+    }
+    frame->next = frame->fields;
+    b->depth++;
+    return SUCCESS;
+}
+
+static int json_bind_key(void *ctx, const char *name, size_t length)
+{
+    json_binder *b = (json_binder*)ctx;
+    json_bind_frame *frame = &b->stack[b->depth - 1];
+    const KJSD_JSON_Field *field;
+
+    for (field = frame->next; field->name; field++)
+    {
+        if (json_name_equals(field->name, name, length)) goto found;
+    }
+    for (field = frame->fields; field != frame->next; field++)
+    {
+        if (json_name_equals(field->name, name, length)) goto found;
+    }
+
+    b->parser.skip_value = 1;
+    return SUCCESS;
+
+found:
+    b->field = field;
+    frame->next = field + 1;
+    return SUCCESS;
+}
+
+static int json_bind_end_object(void *ctx)
+{
+    ((json_binder*)ctx)->depth--;
+    return SUCCESS;
+}
+
+static int json_bind_start_array(void *ctx)
+{
+    /* Arrays are bound to nothing */
+    (void)ctx;
+    return ERROR;
+}
+
+/* NDJSON */
+static int json_lines_run(const char *data, size_t size, size_t threads,
+                          KJSD_JSON_RecordFunc func, void *ctx)
+{
+    json_lines lines;
+    json_lines_slot *slot;
+    size_t index = 0;
+    size_t i;
+    int success = SUCCESS;
+#if defined(JSON_HAVE_THREADS)
+    pthread_t workers[LINES_MAX_THREADS];
+    size_t started = 0;
+    size_t batch;
+    int ready;
+
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (size_t)online: 1;
+    }
+    if (threads > LINES_MAX_THREADS) threads = LINES_MAX_THREADS;
+#else
+    threads = 1;
+#endif
+
+    memset(&lines, 0, sizeof(json_lines));
+    lines.cur = data;
+    lines.end = data + size;
+    /* Two batches per worker keep workers busy while func runs */
+    lines.slot_count = (threads > 1) ? threads * 2: 1;
+    lines.slots = (json_lines_slot*)
+        json_malloc(lines.slot_count * sizeof(json_lines_slot));
+    if (!lines.slots) return ERROR;
+    memset(lines.slots, 0, lines.slot_count * sizeof(json_lines_slot));
+    for (i = 0; i < lines.slot_count; i++)
+    {
+        lines.slots[i].arena = KJSD_JSON_arenaCreate(LINES_BATCH_SIZE * 4);
+        if (!lines.slots[i].arena) success = ERROR;
+    }
+
+    if ((success == SUCCESS) && (threads == 1))
+    {
+        slot = &lines.slots[0];
+        while ((success == SUCCESS) && (lines.cur < lines.end))
+        {
+            json_lines_claim(&lines, slot);
+            json_lines_parse(slot);
+            success = json_lines_deliver(slot, &index, func, ctx);
+        }
+    }
+#if defined(JSON_HAVE_THREADS)
+    else if (success == SUCCESS)
+    {
+        pthread_mutex_init(&lines.mutex, NULL);
+        pthread_cond_init(&lines.cond, NULL);
+        for (; started < threads; started++)
+        {
+            if (pthread_create(&workers[started], NULL,
+                               json_lines_worker, &lines) != 0) break;
+        }
+        if (started == 0) success = ERROR;
+
+        for (batch = 0; success == SUCCESS; batch++)
+        {
+            slot = &lines.slots[batch % lines.slot_count];
+            pthread_mutex_lock(&lines.mutex);
+            for (;;)
+            {
+                ready = (slot->state == JSON_LINES_READY) &&
+                    (slot->batch == batch);
+                /* Every batch has been handed over */
+                if (ready || ((lines.cur == lines.end) &&
+                              (batch >= lines.next_batch))) break;
+                pthread_cond_wait(&lines.cond, &lines.mutex);
+            }
+            pthread_mutex_unlock(&lines.mutex);
+            if (!ready) break;
+
+            success = json_lines_deliver(slot, &index, func, ctx);
+
+            pthread_mutex_lock(&lines.mutex);
+            slot->state = JSON_LINES_FREE;
+            if (success == ERROR) lines.stop = 1;
+            pthread_cond_broadcast(&lines.cond);
+            pthread_mutex_unlock(&lines.mutex);
+        }
+
+        pthread_mutex_lock(&lines.mutex);
+        lines.stop = 1;
+        pthread_cond_broadcast(&lines.cond);
+        pthread_mutex_unlock(&lines.mutex);
+        for (i = 0; i < started; i++) pthread_join(workers[i], NULL);
+        pthread_cond_destroy(&lines.cond);
+        pthread_mutex_destroy(&lines.mutex);
+    }
+#endif
+
+    for (i = 0; i < lines.slot_count; i++)
+    {
+        KJSD_JSON_arenaDestroy(lines.slots[i].arena);
+        json_free(lines.slots[i].values);
+    }
+    json_free(lines.slots);
+    return success;
+}
+
+/* Returns the end of a batch starting at cur, just after a newline */
+static const char* json_lines_split(const char *cur, const char *end)
+{
+    const char *newline;
+
+    if ((size_t)(end - cur) <= LINES_BATCH_SIZE) return end;
+
+    newline = (const char*)memchr(cur + LINES_BATCH_SIZE, '\n',
+                                  end - cur - LINES_BATCH_SIZE);
+    return newline ? newline + 1: end;
+}
+
+static void json_lines_claim(json_lines *lines, json_lines_slot *slot)
+{
+    slot->state = JSON_LINES_BUSY;
+    slot->batch = lines->next_batch++;
+    slot->begin = lines->cur;
+    slot->end = json_lines_split(lines->cur, lines->end);
+    lines->cur = slot->end;
+}
+
+/* Parses a record per line into the arena of the slot. Blank lines
+   are not records. */
+static void json_lines_parse(json_lines_slot *slot)
+{
+    json_builder builder;
+    json_parser parser;
+    const char *cur, *line, *newline;
+    KJSD_JSON_Value *value;
+    size_t consumed;
+
+    slot->count = 0;
+    slot->error = 0;
+    json_builder_init(&builder, slot->arena);
+    json_parser_init(&parser, &json_builder_handler, &builder);
+
+    for (cur = slot->begin; cur < slot->end; cur = newline + 1)
+    {
+        newline = (const char*)memchr(cur, '\n', slot->end - cur);
+        if (!newline) newline = slot->end;
+
+        line = json_skip_spaces(cur, newline);
+        if (line == newline) continue;
+
+        value = NULL;
+        if ((*line == '{') || (*line == '['))
+        {
+            consumed = json_parser_feed(&parser, line, newline - line);
+            /* Nothing but spaces may follow the record */
+            if (json_parser_finish(&parser) &&
+                (json_skip_spaces(line + consumed, newline) == newline))
+            {
+                value = builder.root;
+                builder.root = NULL;
+            }
+        }
+        json_builder_reset(&builder);
+        json_parser_reset(&parser);
+
+        if (slot->count >= slot->capacity)
+        {
+            size_t new_capacity =
+                json_grow_capacity(slot->capacity, 0,
+                                   sizeof(KJSD_JSON_Value*));
+            if ((new_capacity == 0) ||
+                (try_realloc(NULL, (void**)&slot->values,
+                             slot->capacity * sizeof(KJSD_JSON_Value*),
+                             new_capacity * sizeof(KJSD_JSON_Value*))
+                 == ERROR))
+            {
+                slot->error = 1;
+                break;
+            }
+            slot->capacity = new_capacity;
+        }
+        slot->values[slot->count++] = value;
+    }
+
+    json_parser_release(&parser);
+}
+
+/* Hands the records of a slot to func and recycles its arena */
+static int json_lines_deliver(json_lines_slot *slot, size_t *index,
+                              KJSD_JSON_RecordFunc func, void *ctx)
+{
+    size_t i;
+    int success = !slot->error;
+
+    for (i = 0; (i < slot->count) && success; i++)
+    {
+        success = func(ctx, (*index)++, slot->values[i]);
+    }
+    KJSD_JSON_arenaReset(slot->arena);
+    return success ? SUCCESS: ERROR;
+}
+
+#if defined(JSON_HAVE_THREADS)
+static void* json_lines_worker(void *arg)
+{
+    json_lines *lines = (json_lines*)arg;
+    json_lines_slot *slot;
+
+    pthread_mutex_lock(&lines->mutex);
+    while (!lines->stop && (lines->cur < lines->end))
+    {
+        /* The slot of the next batch is freed once func has seen it */
+        slot = &lines->slots[lines->next_batch % lines->slot_count];
+        if (slot->state != JSON_LINES_FREE)
+        {
+            pthread_cond_wait(&lines->cond, &lines->mutex);
+            continue;
+        }
+        json_lines_claim(lines, slot);
+        pthread_mutex_unlock(&lines->mutex);
+
+        json_lines_parse(slot);
+
+        pthread_mutex_lock(&lines->mutex);
+        slot->state = JSON_LINES_READY;
+        pthread_cond_broadcast(&lines->cond);
+    }
+    pthread_mutex_unlock(&lines->mutex);
+    return NULL;
+}
+#endif
+
+/* Parallel array */
+/* Slices are parsed on their own threads and their items are moved
+   into the array of the first slice. Whenever that does not give a
+   plain result, the document is parsed sequentially instead, so the
+   outcome is always that of a sequential parse. */
+static KJSD_JSON_Value* json_deserialize_parallel(const char *data,
+                                                  size_t length,
+                                                  size_t threads)
+{
+#if defined(JSON_HAVE_THREADS)
+    json_array_slice slices[LINES_MAX_THREADS];
+    pthread_t workers[LINES_MAX_THREADS];
+    KJSD_JSON_Array *array, *other;
+    size_t count, total, started, i;
+    int success = SUCCESS;
+
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (size_t)online: 1;
+    }
+    if (threads > LINES_MAX_THREADS) threads = LINES_MAX_THREADS;
+    if (threads > length / ARRAY_SLICE_MIN_SIZE)
+        threads = length / ARRAY_SLICE_MIN_SIZE;
+
+    count = ((threads > 1) && (*data == '[')) ?
+        json_array_split(data, length, slices, threads): 0;
+    if (count < 2) return json_deserialize_buffer(NULL, data, length, NULL);
+
+    for (started = 1; started < count; started++)
+    {
+        if (pthread_create(&workers[started], NULL,
+                           json_array_slice_parse, &slices[started]) != 0)
+            break;
+    }
+    /* Slices without a thread are parsed here */
+    for (i = started; i < count; i++) json_array_slice_parse(&slices[i]);
+    json_array_slice_parse(&slices[0]);
+    for (i = 1; i < started; i++) pthread_join(workers[i], NULL);
+
+    /* "[1,]" must not pass as "[1]" and "[]" */
+    total = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (!slices[i].value ||
+            (slices[i].value->value.array->count == 0)) success = ERROR;
+        else total += slices[i].value->value.array->count;
+    }
+
+    array = slices[0].value ? slices[0].value->value.array: NULL;
+    if (success && (json_array_resize(array, total) == ERROR))
+        success = ERROR;
+    for (i = 1; i < count; i++)
+    {
+        if (!slices[i].value) continue;
+        other = slices[i].value->value.array;
+        if (success)
+        {
+            json_value_block **tail = &array->blocks;
+
+            memcpy(array->items + array->count, other->items,
+                   other->count * sizeof(KJSD_JSON_Value*));
+            array->count += other->count;
+            other->count = 0;
+            /* The items may lie in blocks of the slice */
+            while (*tail) tail = &(*tail)->next;
+            *tail = other->blocks;
+            other->blocks = NULL;
+        }
+        KJSD_JSON_free(slices[i].value);
+    }
+    if (success) return slices[0].value;
+
+    KJSD_JSON_free(slices[0].value);
+#else
+    (void)threads;
+#endif
+    return json_deserialize_buffer(NULL, data, length, NULL);
+}
+
+#if defined(JSON_HAVE_THREADS)
+/* Cuts the elements of the root array into up to count slices of
+   about the same size at top-level commas. Returns the number of
+   slices, or zero when the root array is not closed. */
+static size_t json_array_split(const char *data, size_t length,
+                               json_array_slice *slices, size_t count)
+{
+    const char *block;
+    const char *end = data + length;
+    const char *target = data + length / count;
+    size_t k = 1;
+    size_t depth = 0;
+    int in_string = 0;
+    int escaped = 0;
+
+    slices[0].begin = data + 1;
+    for (block = data; block < end; block += JSON_STRUCTURAL_BLOCK)
+    {
+        size_t n = ((size_t)(end - block) < JSON_STRUCTURAL_BLOCK) ?
+            (size_t)(end - block): JSON_STRUCTURAL_BLOCK;
+        unsigned int mask = json_structural_mask(block, n);
+
+        /* Commas only matter once the next cut is due */
+        if ((k < count) && (block + n > target))
+            mask |= json_comma_mask(block, n);
+        if (escaped) mask &= ~1u;
+        escaped = 0;
+
+        for (; mask != 0; mask &= mask - 1)
+        {
+            unsigned int i = json_ctz(mask);
+            const char *cur = block + i;
+
+            if (in_string)
+            {
+                if (*cur == '"') in_string = 0;
+                else if (*cur == '\\')
+                {
+                    if (i + 1 < n) mask &= ~(1u << (i + 1));
+                    else escaped = 1;
+                }
+                continue;
+            }
+
+            switch (*cur)
+            {
+            case '"':
+                in_string = 1;
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0)
+                {
+                    slices[k - 1].end = cur;
+                    return k;
+                }
+                break;
+            case ',':
+                if ((depth == 1) && (cur >= target) && (k < count))
+                {
+                    slices[k - 1].end = cur;
+                    slices[k].begin = cur + 1;
+                    k++;
+                    target = data + length / count * k;
+                }
+                break;
+            default:
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+static void* json_array_slice_parse(void *arg)
+{
+    json_array_slice *slice = (json_array_slice*)arg;
+    size_t length = slice->end - slice->begin;
+    json_builder builder;
+    json_parser parser;
+    int success;
+
+    json_builder_init(&builder, NULL);
+    json_parser_init(&parser, &json_builder_handler, &builder);
+    success = (json_parser_feed(&parser, "[", 1) == 1) &&
+        (json_parser_feed(&parser, slice->begin, length) == length) &&
+        (json_parser_feed(&parser, "]", 1) == 1) &&
+        json_parser_finish(&parser);
+    json_parser_release(&parser);
+
+    slice->value = json_builder_finish(&builder, success);
+    return NULL;
+}
+#endif
+
+/* Parser API */
+KJSD_JSON_Value* KJSD_JSON_deserialize(FILE* in)
+{
+    return json_deserialize(NULL, in);
+}
+
+KJSD_JSON_Value* KJSD_JSON_deserializeS(const char *string)
+{
+    return json_deserialize_string(NULL, string, NULL);
+}
+
+KJSD_JSON_Value* KJSD_JSON_deserializeSParallel(const char *string,
+                                                size_t threads)
+{
+    if (string == NULL) return NULL;
+
+    return json_deserialize_parallel(string, strlen(string), threads);
+}
+
+int KJSD_JSON_parse(FILE* in, const KJSD_JSON_Handler *handler, void *ctx)
+{
+    json_parser parser;
+    int success;
+
+    if ((in == NULL) || (handler == NULL)) return ERROR;
+
+    json_parser_init(&parser, handler, ctx);
+    success = json_parse_file(&parser, in, 0);
+    json_parser_release(&parser);
+    return success;
+}
+
+int KJSD_JSON_parseS(const char *in,
+                     const KJSD_JSON_Handler *handler, void *ctx)
+{
+    json_parser parser;
+    int success;
+
+    if ((in == NULL) || (handler == NULL)) return ERROR;
+
+    json_parser_init(&parser, handler, ctx);
+    json_parser_feed(&parser, in, strlen(in));
+    success = json_parser_finish(&parser);
+    json_parser_release(&parser);
+    return success;
+}
+
+int KJSD_JSON_bind(FILE* in, const KJSD_JSON_Field *fields, void *out)
+{
+    json_binder binder;
+    int success;
+
+    if ((in == NULL) || (fields == NULL) || (out == NULL)) return ERROR;
+
+    json_bind_init(&binder, fields, out);
+    success = json_parse_file(&binder.parser, in, 0);
+    json_parser_release(&binder.parser);
+    return success;
+}
+
+int KJSD_JSON_bindS(const char *in, const KJSD_JSON_Field *fields,
+                    void *out)
+{
+    json_binder binder;
+    int success;
+
+    if ((in == NULL) || (fields == NULL) || (out == NULL)) return ERROR;
+
+    json_bind_init(&binder, fields, out);
+    json_parser_feed(&binder.parser, in, strlen(in));
+    success = json_parser_finish(&binder.parser);
+    json_parser_release(&binder.parser);
+    return success;
+}
+
+int KJSD_JSON_deserializeLines(const char *data, size_t size,
+                               size_t threads,
+                               KJSD_JSON_RecordFunc func, void *ctx)
+{
+    if ((data == NULL) || (func == NULL)) return ERROR;
+
+    return json_lines_run(data, size, threads, func, ctx);
+}
+
+int KJSD_JSON_deserializeLinesFile(const char *path, size_t threads,
+                                   KJSD_JSON_RecordFunc func, void *ctx)
+{
+    int success;
+#if defined(JSON_HAVE_MMAP)
+    struct stat st;
+    void *addr;
+    size_t size;
+    int fd;
+
+    if ((path == NULL) || (func == NULL)) return ERROR;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return ERROR;
+    if ((fstat(fd, &st) != 0) ||
+        ((unsigned long long)st.st_size > (size_t)-1))
+    {
+        close(fd);
+        return ERROR;
+    }
+    size = (size_t)st.st_size;
+    if (size == 0)
+    {
+        close(fd);
+        return SUCCESS;
+    }
+
+    addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return ERROR;
+#if defined(MADV_SEQUENTIAL)
+    madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+
+    success = json_lines_run((const char*)addr, size, threads, func, ctx);
+    munmap(addr, size);
+#else
+    FILE *in;
+    char *data = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+    size_t n;
+
+    if ((path == NULL) || (func == NULL)) return ERROR;
+
+    in = fopen(path, "rb");
+    if (!in) return ERROR;
+    for (;;)
+    {
+        if (size == capacity)
+        {
+            if (try_realloc(NULL, (void**)&data, capacity,
+                            capacity + PARSER_CHUNK_SIZE) == ERROR)
+            {
+                json_free(data);
+                fclose(in);
+                return ERROR;
+            }
+            capacity += PARSER_CHUNK_SIZE;
+        }
+        n = fread(data + size, 1, capacity - size, in);
+        if (n == 0) break;
+        size += n;
+    }
+    fclose(in);
+
+    success = json_lines_run(data, size, threads, func, ctx);
+    json_free(data);
+#endif
+    return success;
+}
+
+KJSD_JSON_Value* KJSD_JSON_deserializeBinary(const void *data, size_t size)
+{
+    if (data == NULL) return NULL;
+
+    return json_deserialize_binary(NULL, data, size);
+}
+
+KJSD_JSON_Value* KJSD_JSON_deserializeFile(const char *path)
+{
+    if (path == NULL) return NULL;
+
+    return json_deserialize_file(NULL, path, JSON_LOAD_COPY);
+}
+
+/* Incremental parser API */
+KJSD_JSON_Parser* KJSD_JSON_parserCreate(KJSD_JSON_Arena *arena)
+{
+    KJSD_JSON_Parser *parser =
+        (KJSD_JSON_Parser*)json_malloc(sizeof(KJSD_JSON_Parser));
+    if (!parser) return NULL;
+
+    json_builder_init(&parser->builder, arena);
+    json_parser_init(&parser->parser, &json_builder_handler,
+                     &parser->builder);
+    return parser;
+}
+
+KJSD_JSON_Parser* KJSD_JSON_parserCreateEvent(
+    const KJSD_JSON_Handler *handler, void *ctx)
+{
+    KJSD_JSON_Parser *parser;
+
+    if (handler == NULL) return NULL;
+
+    parser = (KJSD_JSON_Parser*)json_malloc(sizeof(KJSD_JSON_Parser));
+    if (!parser) return NULL;
+
+    json_builder_init(&parser->builder, NULL);
+    json_parser_init(&parser->parser, handler, ctx);
+    return parser;
+}
+
+KJSD_JSON_ParseStatus KJSD_JSON_parserFeed(KJSD_JSON_Parser *parser,
+                                           const char *data, size_t size,
+                                           size_t *consumed)
+{
+    size_t n = 0;
+
+    if ((parser == NULL) || ((data == NULL) && (size > 0)))
+        return KJSD_JSON_PARSE_ERROR;
+
+    if (size > 0) n = json_parser_feed(&parser->parser, data, size);
+    if (consumed) *consumed = n;
+    return KJSD_JSON_parserGetStatus(parser);
+}
+
+KJSD_JSON_ParseStatus KJSD_JSON_parserFinish(KJSD_JSON_Parser *parser)
+{
+    if (parser == NULL) return KJSD_JSON_PARSE_ERROR;
+
+    if (!json_parser_finish(&parser->parser))
+        parser->parser.state = JSON_PS_ERROR;
+    return KJSD_JSON_parserGetStatus(parser);
+}
+
+KJSD_JSON_ParseStatus KJSD_JSON_parserGetStatus(
+    const KJSD_JSON_Parser *parser)
+{
+    if (parser == NULL) return KJSD_JSON_PARSE_ERROR;
+
+    switch (parser->parser.state)
+    {
+    case JSON_PS_DONE:
+        return KJSD_JSON_PARSE_DONE;
+    case JSON_PS_ERROR:
+        return KJSD_JSON_PARSE_ERROR;
+    default:
+        return KJSD_JSON_PARSE_CONTINUE;
+    }
+}
+
+KJSD_JSON_Value* KJSD_JSON_parserTakeRoot(KJSD_JSON_Parser *parser)
+{
+    KJSD_JSON_Value *root;
+
+    if ((parser == NULL) || (parser->parser.state != JSON_PS_DONE))
+        return NULL;
+
+    root = parser->builder.root;
+    parser->builder.root = NULL;
+    KJSD_JSON_parserReset(parser);
+    return root;
+}
+
+void KJSD_JSON_parserReset(KJSD_JSON_Parser *parser)
+{
+    if (parser == NULL) return;
+
+    json_builder_reset(&parser->builder);
+    json_parser_reset(&parser->parser);
+}
+
+void KJSD_JSON_parserDestroy(KJSD_JSON_Parser *parser)
+{
+    if (parser == NULL) return;
+
+    json_builder_reset(&parser->builder);
+    json_builder_finish(&parser->builder, 1);
+    json_parser_release(&parser->parser);
+    json_free(parser);
+}
+
+/* Arena API */
+KJSD_JSON_Arena* KJSD_JSON_arenaCreate(size_t chunk_size)
+{
+    return KJSD_JSON_arenaCreateWithAllocator(chunk_size, NULL);
+}
+
+KJSD_JSON_Arena* KJSD_JSON_arenaCreateWithAllocator(
+    size_t chunk_size, const KJSD_JSON_Allocator *allocator)
+{
+    KJSD_JSON_Arena *arena;
+
+    if (allocator == NULL) allocator = &json_allocator;
+    if ((allocator->alloc == NULL) || (allocator->resize == NULL) ||
+        (allocator->release == NULL)) return NULL;
+
+    arena = (KJSD_JSON_Arena*)allocator->alloc(allocator->ctx,
+                                               sizeof(KJSD_JSON_Arena));
+    if (!arena) return NULL;
+
+    arena->allocator = *allocator;
+    arena->chunks = NULL;
+    arena->chunk_size = (chunk_size > 0) ? chunk_size: ARENA_CHUNK_SIZE;
+    arena->last = NULL;
+    arena->maps = NULL;
+    memset(&arena->keys, 0, sizeof(json_intern));
+    return arena;
+}
+
+void KJSD_JSON_arenaReset(KJSD_JSON_Arena *arena)
+{
+    if ((arena == NULL) || (arena->chunks == NULL)) return;
+
+    json_arena_unmap(arena);
+    /* Keep the latest chunk to be reused */
+    json_arena_chunk_free(arena, arena->chunks->next);
+    arena->chunks->next = NULL;
+    arena->chunks->used = 0;
+    arena->last = NULL;
+    memset(&arena->keys, 0, sizeof(json_intern));
+}
+
+void KJSD_JSON_arenaDestroy(KJSD_JSON_Arena *arena)
+{
+    KJSD_JSON_Allocator allocator;
+
+    if (arena == NULL) return;
+
+    allocator = arena->allocator;
+    json_arena_unmap(arena);
+    json_arena_chunk_free(arena, arena->chunks);
+    allocator.release(allocator.ctx, arena);
+}
+
+/* Allocator API */
+int KJSD_JSON_setAllocator(const KJSD_JSON_Allocator *allocator)
+{
+    static const KJSD_JSON_Allocator libc_allocator = {
+        json_libc_alloc,
+        json_libc_resize,
+        json_libc_release,
+        NULL
+    };
+
+    if (allocator == NULL) allocator = &libc_allocator;
+    if ((allocator->alloc == NULL) || (allocator->resize == NULL) ||
+        (allocator->release == NULL)) return ERROR;
+
+    json_allocator = *allocator;
+    return SUCCESS;
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserialize(KJSD_JSON_Arena *arena,
+                                            FILE* in)
+{
+    if (arena == NULL) return NULL;
+
+    return json_deserialize(arena, in);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeS(KJSD_JSON_Arena *arena,
+                                             const char *in)
+{
+    if (arena == NULL) return NULL;
+
+    return json_deserialize_string(arena, in, NULL);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeInSitu(KJSD_JSON_Arena *arena,
+                                                  char *in)
+{
+    if (arena == NULL) return NULL;
+
+    return json_deserialize_string(arena, in, in);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeFile(KJSD_JSON_Arena *arena,
+                                                const char *path)
+{
+    if ((arena == NULL) || (path == NULL)) return NULL;
+
+    return json_deserialize_file(arena, path, JSON_LOAD_COPY);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeFileInSitu(
+    KJSD_JSON_Arena *arena, const char *path)
+{
+    if ((arena == NULL) || (path == NULL)) return NULL;
+
+    return json_deserialize_file(arena, path, JSON_LOAD_INSITU);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeLazy(KJSD_JSON_Arena *arena,
+                                                const char *in)
+{
+    if ((arena == NULL) || (in == NULL)) return NULL;
+
+    return json_deserialize_lazy(arena, in, strlen(in));
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeFileLazy(
+    KJSD_JSON_Arena *arena, const char *path)
+{
+    if ((arena == NULL) || (path == NULL)) return NULL;
+
+    return json_deserialize_file(arena, path, JSON_LOAD_LAZY);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaDeserializeBinary(KJSD_JSON_Arena *arena,
+                                                  const void *data,
+                                                  size_t size)
+{
+    if ((arena == NULL) || (data == NULL)) return NULL;
+
+    return json_deserialize_binary(arena, data, size);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaCreateRoot(KJSD_JSON_Arena *arena)
+{
+    if (arena == NULL) return NULL;
+
+    return json_value_init_object(arena);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaClone(KJSD_JSON_Arena *arena,
+                                      const KJSD_JSON_Value *value)
+{
+    if ((arena == NULL) || (value == NULL)) return NULL;
+
+    return json_clone(arena, value);
+}
+
+KJSD_JSON_Value* KJSD_JSON_arenaCloneShared(KJSD_JSON_Arena *arena,
+                                            const KJSD_JSON_Value *base)
+{
+    KJSD_JSON_Value *value;
+
+    if ((arena == NULL) || (base == NULL)) return NULL;
+
+    value = json_value_alloc(arena, base->type);
+    if (!value || (json_share_value(arena, value, base) == ERROR))
+        return NULL;
+    return value;
+}
+
+/* JSON Object API */
+KJSD_JSON_Value* KJSD_JSON_objectGetValue(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return json_object_nget_value(object, name, strlen(name));
+}
+
+const char* KJSD_JSON_objectGetString(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return KJSD_JSON_valueGetString(
+        KJSD_JSON_objectGetValue(object, name));
+}
+
+double KJSD_JSON_objectGetNumber(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return 0;
+
+    return KJSD_JSON_valueGetNumber(
+        KJSD_JSON_objectGetValue(object, name));
+}
+
+int64_t KJSD_JSON_objectGetInteger(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return 0;
+
+    return KJSD_JSON_valueGetInteger(
+        KJSD_JSON_objectGetValue(object, name));
+}
+
+KJSD_JSON_Object* KJSD_JSON_objectGetObject(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return KJSD_JSON_valueGetObject(
+        KJSD_JSON_objectGetValue(object, name));
+}
+
+KJSD_JSON_Array* KJSD_JSON_objectGetArray(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return KJSD_JSON_valueGetArray(
+        KJSD_JSON_objectGetValue(object, name));
+}
+
+int KJSD_JSON_objectGetBool(const KJSD_JSON_Object *object,
+                            const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return -1;
+
+    return KJSD_JSON_valueGetBool(
+        KJSD_JSON_objectGetValue(object, name));
+}
+
+KJSD_JSON_Value * KJSD_JSON_objectDotGetValue(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    const char *dot_position = strchr(name, '.');
+    if (!dot_position)
+    {
+        return KJSD_JSON_objectGetValue(object, name);
+    }
+
+    object = KJSD_JSON_valueGetObject(
+        json_object_nget_value(object, name, dot_position - name));
+    return KJSD_JSON_objectDotGetValue(object, dot_position + 1);
+}
+
+const char* KJSD_JSON_objectDotGetString(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return KJSD_JSON_valueGetString(
+        KJSD_JSON_objectDotGetValue(object, name));
+}
+
+double KJSD_JSON_objectDotGetNumber(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return 0;
+
+    return KJSD_JSON_valueGetNumber(
+        KJSD_JSON_objectDotGetValue(object, name));
+}
+
+int64_t KJSD_JSON_objectDotGetInteger(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return 0;
+
+    return KJSD_JSON_valueGetInteger(
+        KJSD_JSON_objectDotGetValue(object, name));
+}
+
+KJSD_JSON_Object* KJSD_JSON_objectDotGetObject(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return KJSD_JSON_valueGetObject(
+        KJSD_JSON_objectDotGetValue(object, name));
+}
+
+KJSD_JSON_Array* KJSD_JSON_objectDotGetArray(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return NULL;
+
+    return KJSD_JSON_valueGetArray(
+        KJSD_JSON_objectDotGetValue(object, name));
+}
+
+int KJSD_JSON_objectDotGetBool(
+    const KJSD_JSON_Object *object, const char *name)
+{
+    if ((object == NULL) || (name == NULL)) return -1;
+
+    return KJSD_JSON_valueGetBool(
+        KJSD_JSON_objectDotGetValue(object, name));
+}
+
+size_t KJSD_JSON_objectGetCount(const KJSD_JSON_Object *object)
+{
+    if ((object == NULL) || !json_object_load(object)) return 0;
+    return object->count;
+}
+
+const char* KJSD_JSON_objectGetName(
+    const KJSD_JSON_Object *object, size_t index)
+{
+    if (index >= KJSD_JSON_objectGetCount(object)) return NULL;
+    return object->names[index];
+}
+
+/* JSON Array API */
+KJSD_JSON_Value* KJSD_JSON_arrayGetValue(
+    const KJSD_JSON_Array *array, size_t index)
+{
+    if (index >= KJSD_JSON_arrayGetCount(array)) return NULL;
+    return array->items[index];
+}
+
+const char* KJSD_JSON_arrayGetString(
+    const KJSD_JSON_Array *array, size_t index)
+{
+    return KJSD_JSON_valueGetString(
+        KJSD_JSON_arrayGetValue(array, index));
+}
+
+double KJSD_JSON_arrayGetNumber(const KJSD_JSON_Array *array,
+                                size_t index)
+{
+    return KJSD_JSON_valueGetNumber(
+        KJSD_JSON_arrayGetValue(array, index));
+}
+
+int64_t KJSD_JSON_arrayGetInteger(const KJSD_JSON_Array *array,
+                                  size_t index)
+{
+    return KJSD_JSON_valueGetInteger(
+        KJSD_JSON_arrayGetValue(array, index));
+}
+
+KJSD_JSON_Object* KJSD_JSON_arrayGetObject(
+    const KJSD_JSON_Array *array, size_t index)
+{
+    return KJSD_JSON_valueGetObject(
+        KJSD_JSON_arrayGetValue(array, index));
+}
+
+KJSD_JSON_Array* KJSD_JSON_arrayGetArray(
+    const KJSD_JSON_Array *array, size_t index)
+{
+    return KJSD_JSON_valueGetArray(
+        KJSD_JSON_arrayGetValue(array, index));
+}
+
+int KJSD_JSON_arrayGetBool(const KJSD_JSON_Array *array,
+                           size_t index)
+{
+    return KJSD_JSON_valueGetBool(
+        KJSD_JSON_arrayGetValue(array, index));
+}
+
+size_t KJSD_JSON_arrayGetCount(const KJSD_JSON_Array *array)
+{
+    if ((array == NULL) || !json_array_load(array)) return 0;
+    return array->count;
+}
+
+/* Path */
+static KJSD_JSON_Value* json_path_step_into(json_path_step *step,
+                                            const KJSD_JSON_Value *value)
+{
+    const KJSD_JSON_Object *object;
+    const KJSD_JSON_Array *array;
+    size_t i;
+
+    if (step->type == JSON_PATH_ITEM)
+    {
+        if ((value->type != KJSD_JSON_ARRAY) ||
+            !json_array_load(value->value.array)) return NULL;
+        array = value->value.array;
+        return (step->index < array->count) ?
+            array->items[step->index]: NULL;
+    }
+
+    if ((value->type != KJSD_JSON_OBJECT) ||
+        !json_object_load(value->value.object)) return NULL;
+    object = value->value.object;
+
+    /* Documents of the same shape keep a member in the same slot */
+    i = step->index;
+    if ((i < object->count) &&
+        json_name_equals(object->names[i], step->name, step->length))
+    {
+        return object->values[i];
+    }
+
+    i = json_object_nfind(object, step->name, step->length);
+    if (i == NOT_FOUND) return NULL;
+    step->index = i;
+    return object->values[i];
+}
+
+/* Returns zero once func asks to stop */
+static int json_path_walk(KJSD_JSON_Path *path, size_t step,
+                          KJSD_JSON_Value *value,
+                          KJSD_JSON_PathFunc func, void *ctx,
+                          size_t *matches)
+{
+    size_t i;
+
+    for (; step < path->count; step++)
+    {
+        switch (path->steps[step].type)
+        {
+        case JSON_PATH_ANY_MEMBER:
+            if ((value->type != KJSD_JSON_OBJECT) ||
+                !json_object_load(value->value.object)) return 1;
+            for (i = 0; i < value->value.object->count; i++)
+            {
+                if (!json_path_walk(path, step + 1,
+                                    value->value.object->values[i],
+                                    func, ctx, matches)) return 0;
+            }
+            return 1;
+        case JSON_PATH_ANY_ITEM:
+            if ((value->type != KJSD_JSON_ARRAY) ||
+                !json_array_load(value->value.array)) return 1;
+            for (i = 0; i < value->value.array->count; i++)
+            {
+                if (!json_path_walk(path, step + 1,
+                                    value->value.array->items[i],
+                                    func, ctx, matches)) return 0;
+            }
+            return 1;
+        default:
+            value = json_path_step_into(&path->steps[step], value);
+            if (!value) return 1;
+            break;
+        }
+    }
+
+    (*matches)++;
+    return func(ctx, value);
+}
+
+static int json_path_first(void *ctx, KJSD_JSON_Value *value)
+{
+    *(KJSD_JSON_Value**)ctx = value;
+    return 0;
+}
+
+/* JSON Path API */
+KJSD_JSON_Path* KJSD_JSON_pathCompile(const char *path)
+{
+    KJSD_JSON_Path *compiled;
+    json_path_step *step;
+    const char *cur, *end;
+    char *names;
+    size_t max_steps = 1;
+    size_t length;
+
+    if (path == NULL) return NULL;
+
+    length = strlen(path);
+    for (cur = path; *cur; cur++)
+    {
+        if ((*cur == '.') || (*cur == '[')) max_steps++;
+    }
+
+    /* Steps and names live in the same block as the handle */
+    compiled = (KJSD_JSON_Path*)json_malloc(
+        ARENA_ALIGN(sizeof(KJSD_JSON_Path)) +
+        max_steps * sizeof(json_path_step) + length + 1);
+    if (!compiled) return NULL;
+    compiled->steps = (json_path_step*)
+        ((char*)compiled + ARENA_ALIGN(sizeof(KJSD_JSON_Path)));
+    compiled->count = 0;
+    compiled->has_wildcard = 0;
+    names = (char*)(compiled->steps + max_steps);
+
+    for (cur = path;; cur++)
+    {
+        end = cur + strcspn(cur, ".[");
+        if (end > cur)
+        {
+            step = &compiled->steps[compiled->count++];
+            step->name = NULL;
+            step->length = 0;
+            step->index = 0;
+            if ((end - cur == 1) && (*cur == '*'))
+            {
+                step->type = JSON_PATH_ANY_MEMBER;
+                compiled->has_wildcard = 1;
+            }
+            else
+            {
+                step->type = JSON_PATH_MEMBER;
+                step->length = end - cur;
+                step->name = names;
+                memcpy(names, cur, step->length);
+                names[step->length] = '\0';
+                names += step->length + 1;
+            }
+        }
+        /* Only an array root may start with an index */
+        else if ((compiled->count > 0) || (*end != '[')) goto error;
+
+        for (cur = end; *cur == '['; cur++)
+        {
+            step = &compiled->steps[compiled->count++];
+            step->name = NULL;
+            step->length = 0;
+            step->index = 0;
+            cur++;
+            if (*cur == '*')
+            {
+                step->type = JSON_PATH_ANY_ITEM;
+                compiled->has_wildcard = 1;
+                cur++;
+            }
+            else
+            {
+                step->type = JSON_PATH_ITEM;
+                if (!is_digit(*cur)) goto error;
+                for (; is_digit(*cur); cur++)
+                {
+                    if (step->index > (NOT_FOUND - 9) / 10) goto error;
+                    step->index = step->index * 10 + (*cur - '0');
+                }
+            }
+            if (*cur != ']') goto error;
+        }
+
+        if (*cur == '\0') return compiled;
+        if (*cur != '.') goto error;
+    }
+
+error:
+    json_free(compiled);
+    return NULL;
+}
+
+KJSD_JSON_Value* KJSD_JSON_pathGetValue(KJSD_JSON_Path *path,
+                                        const KJSD_JSON_Value *root)
+{
+    KJSD_JSON_Value *value = (KJSD_JSON_Value*)root;
+    size_t i;
+
+    if ((path == NULL) || (root == NULL)) return NULL;
+
+    if (path->has_wildcard)
+    {
+        value = NULL;
+        KJSD_JSON_pathForEach(path, root, json_path_first, &value);
+        return value;
+    }
+
+    for (i = 0; (i < path->count) && value; i++)
+    {
+        value = json_path_step_into(&path->steps[i], value);
+    }
+    return value;
+}
+
+size_t KJSD_JSON_pathForEach(KJSD_JSON_Path *path,
+                             const KJSD_JSON_Value *root,
+                             KJSD_JSON_PathFunc func, void *ctx)
+{
+    size_t matches = 0;
+
+    if ((path == NULL) || (root == NULL) || (func == NULL)) return 0;
+
+    json_path_walk(path, 0, (KJSD_JSON_Value*)root, func, ctx, &matches);
+    return matches;
+}
+
+void KJSD_JSON_pathDestroy(KJSD_JSON_Path *path)
+{
+    json_free(path);
+}
+
+/* JSON Value API */
+KJSD_JSON_Type KJSD_JSON_valueGetType(
+    const KJSD_JSON_Value *value)
+{
+    return value ? value->type : KJSD_JSON_ERROR;
+}
+
+KJSD_JSON_Object* KJSD_JSON_valueGetObject(
+    const KJSD_JSON_Value *value)
+{
+    return KJSD_JSON_valueGetType(value) == KJSD_JSON_OBJECT ?
+        value->value.object : NULL;
+}
+
+KJSD_JSON_Array* KJSD_JSON_valueGetArray(
+    const KJSD_JSON_Value *value)
+{
+    return KJSD_JSON_valueGetType(value) == KJSD_JSON_ARRAY ?
+        value->value.array : NULL;
+}
+
+const char* KJSD_JSON_valueGetString(
+    const KJSD_JSON_Value *value)
+{
+    return KJSD_JSON_valueGetType(value) == KJSD_JSON_STRING ?
+        value->value.string : NULL;
+}
+
+double KJSD_JSON_valueGetNumber(const KJSD_JSON_Value *value)
+{
+    if (KJSD_JSON_valueGetType(value) != KJSD_JSON_NUMBER) return 0;
+
+    return value->is_integer ?
+        (double)value->value.integer: value->value.number;
+}
+
+int64_t KJSD_JSON_valueGetInteger(const KJSD_JSON_Value *value)
+{
+    double number;
+
+    if (KJSD_JSON_valueGetType(value) != KJSD_JSON_NUMBER) return 0;
+    if (value->is_integer) return value->value.integer;
+
+    /* Truncated toward zero if representable */
+    number = value->value.number;
+    if ((number > -9223372036854775808.0) &&
+        (number < 9223372036854775808.0))
+    {
+        return (int64_t)number;
+    }
+    return 0;
+}
+
+int KJSD_JSON_valueIsInteger(const KJSD_JSON_Value *value)
+{
+    return (KJSD_JSON_valueGetType(value) == KJSD_JSON_NUMBER) &&
+        value->is_integer;
+}
+
+int KJSD_JSON_valueGetBool(const KJSD_JSON_Value *value)
+{
+    return KJSD_JSON_valueGetType(value) == KJSD_JSON_BOOL ?
+        value->value.bool : -1;
+}
+
+int KJSD_JSON_valueEquals(const KJSD_JSON_Value *a, const KJSD_JSON_Value *b)
+{
+    if ((a == NULL) || (b == NULL)) return 0;
+
+    return json_value_equals(a, b);
+}
+
+void KJSD_JSON_free(KJSD_JSON_Value *value)
+{
+    switch (KJSD_JSON_valueGetType(value))
+    {
+    case KJSD_JSON_OBJECT:
+        /* Arena-backed data is released by KJSD_JSON_arenaDestroy */
+        if (value->value.object->arena) return;
+        json_object_free(value->value.object);
+        break;
+    case KJSD_JSON_STRING:
+        if (value->value.string)
+        {
+            json_free(value->value.string);
+        }
+        break;
+    case KJSD_JSON_ARRAY:
+        if (value->value.array->arena) return;
+        json_array_free(value->value.array);
+        break;
+    default:
+        break;
+    }
+    /* An inline value goes with the block of its container */
+    if (value && !value->is_inline) json_free(value);
+}
+
+KJSD_JSON_Value* KJSD_JSON_createRoot(void)
+{
+    return json_value_init_object(NULL);
+}
+
+KJSD_JSON_Value* KJSD_JSON_clone(const KJSD_JSON_Value *value)
+{
+    if (value == NULL) return NULL;
+
+    return json_clone(NULL, value);
+}
+
+KJSD_JSON_Object* KJSD_JSON_objectAddObject(
+    KJSD_JSON_Object* base,
+    const char* name)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_value_init_object(base->arena);
+    if (json_object_add(base, name, strlen(name), new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return NULL;
+    }
+    return KJSD_JSON_valueGetObject(new_val);
+}
+
+KJSD_JSON_Array* KJSD_JSON_objectAddArray(
+    KJSD_JSON_Object* base, const char* name)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_value_init_array(base->arena);
+    if (json_object_add(base, name, strlen(name), new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        new_val = NULL;
+    }
+    return KJSD_JSON_valueGetArray(new_val);
+}
+
+int KJSD_JSON_objectAddString(KJSD_JSON_Object* base,
+                              const char* name,
+                              const char* value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+    const char *new_string = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    if (value != NULL)
+    {
+        new_string = json_strndup(base->arena, value, strlen(value));
+    }
+
+    new_val = json_value_init_string(base->arena, new_string);
+    if (json_object_add(base, name, strlen(name), new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectAddNumber(KJSD_JSON_Object* base,
+                              const char* name,
+                              double value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_value_init_number(base->arena, value);
+    if (json_object_add(base, name, strlen(name), new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectAddInteger(KJSD_JSON_Object* base,
+                               const char* name,
+                               int64_t value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_value_init_integer(base->arena, value);
+    if (json_object_add(base, name, strlen(name), new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectAddBool(KJSD_JSON_Object* base,
+                            const char* name, int value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_value_init_bool(base->arena, value);
+    if (json_object_add(base, name, strlen(name), new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+KJSD_JSON_Object* KJSD_JSON_arrayAddObject(
+    KJSD_JSON_Array* base)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if (base == NULL) return ERROR;
+
+    new_val = json_value_init_object(base->arena);
+    if (json_array_add(base, new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return NULL;
+    }
+    return KJSD_JSON_valueGetObject(new_val);
+}
+
+KJSD_JSON_Array* KJSD_JSON_arrayAddArray(
+    KJSD_JSON_Array* base)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if (base == NULL) return ERROR;
+
+    new_val = json_value_init_array(base->arena);
+    if (json_array_add(base, new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return NULL;
+    }
+    return KJSD_JSON_valueGetArray(new_val);
+}
+
+int KJSD_JSON_arrayAddString(KJSD_JSON_Array* base,
+                             const char* value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+    const char *new_string = NULL;
+
+    if (base == NULL) return ERROR;
+
+    if (value != NULL)
+    {
+        new_string = json_strndup(base->arena, value, strlen(value));
+    }
+
+    new_val = json_value_init_string(base->arena, new_string);
+    if (json_array_add(base, new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int KJSD_JSON_arrayAddNumber(KJSD_JSON_Array* base,
+                             double value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if (base == NULL) return ERROR;
+
+    new_val = json_value_init_number(base->arena, value);
+    if (json_array_add(base, new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int KJSD_JSON_arrayAddInteger(KJSD_JSON_Array* base,
+                              int64_t value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if (base == NULL) return ERROR;
+
+    new_val = json_value_init_integer(base->arena, value);
+    if (json_array_add(base, new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+int KJSD_JSON_arrayAddBool(KJSD_JSON_Array* base, int value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if (base == NULL) return ERROR;
+
+    new_val = json_value_init_bool(base->arena, value);
+    if (json_array_add(base, new_val) == ERROR)
+    {
+        json_value_free(base->arena, new_val);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+KJSD_JSON_Object* KJSD_JSON_objectSetObject(KJSD_JSON_Object* base,
+                                            const char* name)
+{
+    KJSD_JSON_Value* value = NULL;
+    KJSD_JSON_Object* new_obj = NULL;
+
+    if ((base == NULL) || (name == NULL)) return NULL;
+
+    /* Made first, so that a failure leaves the old value */
+    new_obj = json_object_init(base->arena);
+    if (!new_obj) return NULL;
+
+    value = json_object_set(base, name, KJSD_JSON_OBJECT);
+    if (!value)
+    {
+        if (!base->arena) json_object_free(new_obj);
+        return NULL;
+    }
+    value->value.object = new_obj;
+    return new_obj;
+}
+
+KJSD_JSON_Array* KJSD_JSON_objectSetArray(KJSD_JSON_Object* base,
+                                          const char* name)
+{
+    KJSD_JSON_Value* value = NULL;
+    KJSD_JSON_Array* new_array = NULL;
+
+    if ((base == NULL) || (name == NULL)) return NULL;
+
+    new_array = json_array_init(base->arena);
+    if (!new_array) return NULL;
+
+    value = json_object_set(base, name, KJSD_JSON_ARRAY);
+    if (!value)
+    {
+        if (!base->arena) json_array_free(new_array);
+        return NULL;
+    }
+    value->value.array = new_array;
+    return new_array;
+}
+
+int KJSD_JSON_objectSetString(KJSD_JSON_Object* base,
+                              const char* name,
+                              const char* value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+    const char *new_string = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    /* value may be a part of the one replaced */
+    if (value != NULL)
+    {
+        new_string = json_strndup(base->arena, value, strlen(value));
+        if (!new_string) return ERROR;
+    }
+
+    new_val = json_object_set(base, name, KJSD_JSON_STRING);
+    if (!new_val)
+    {
+        json_dealloc(base->arena, new_string);
+        return ERROR;
+    }
+    new_val->value.string = new_string;
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectSetNumber(KJSD_JSON_Object* base,
+                              const char* name,
+                              double value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_object_set(base, name, KJSD_JSON_NUMBER);
+    if (!new_val) return ERROR;
+
+    new_val->value.number = value;
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectSetInteger(KJSD_JSON_Object* base,
+                               const char* name,
+                               int64_t value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_object_set(base, name, KJSD_JSON_NUMBER);
+    if (!new_val) return ERROR;
+
+    new_val->is_integer = 1;
+    new_val->value.integer = value;
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectSetBool(KJSD_JSON_Object* base,
+                            const char* name, int value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    new_val = json_object_set(base, name, KJSD_JSON_BOOL);
+    if (!new_val) return ERROR;
+
+    new_val->value.bool = value;
+    return SUCCESS;
+}
+
+int KJSD_JSON_objectRemove(KJSD_JSON_Object* base, const char* name)
+{
+    size_t i;
+
+    if ((base == NULL) || (name == NULL)) return ERROR;
+
+    i = json_object_nfind(base, name, strlen(name));
+    if (i == NOT_FOUND) return ERROR;
+
+    json_value_free(base->arena, base->values[i]);
+    json_key_release(base->arena, base->names[i]);
+    base->count--;
+    memmove(base->names + i, base->names + i + 1,
+            (base->count - i) * sizeof(char*));
+    memmove(base->values + i, base->values + i + 1,
+            (base->count - i) * sizeof(KJSD_JSON_Value*));
+
+    /* Members after i have moved down */
+    if (base->index)
+    {
+        memset(base->index, 0, base->index_size * sizeof(size_t));
+        for (i = 0; i < base->count; i++)
+        {
+            json_object_index_insert(base, i);
+        }
+    }
+    return SUCCESS;
+}
+
+KJSD_JSON_Object* KJSD_JSON_arraySetObject(KJSD_JSON_Array* base,
+                                           size_t index)
+{
+    KJSD_JSON_Value* value = NULL;
+    KJSD_JSON_Object* new_obj = NULL;
+
+    if (base == NULL) return NULL;
+
+    new_obj = json_object_init(base->arena);
+    if (!new_obj) return NULL;
+
+    value = json_array_set(base, index, KJSD_JSON_OBJECT);
+    if (!value)
+    {
+        if (!base->arena) json_object_free(new_obj);
+        return NULL;
+    }
+    value->value.object = new_obj;
+    return new_obj;
+}
+
+KJSD_JSON_Array* KJSD_JSON_arraySetArray(KJSD_JSON_Array* base,
+                                         size_t index)
+{
+    KJSD_JSON_Value* value = NULL;
+    KJSD_JSON_Array* new_array = NULL;
+
+    if (base == NULL) return NULL;
+
+    new_array = json_array_init(base->arena);
+    if (!new_array) return NULL;
+
+    value = json_array_set(base, index, KJSD_JSON_ARRAY);
+    if (!value)
+    {
+        if (!base->arena) json_array_free(new_array);
+        return NULL;
+    }
+    value->value.array = new_array;
+    return new_array;
+}
+
+int KJSD_JSON_arraySetString(KJSD_JSON_Array* base, size_t index,
+                             const char* value)
+{
+    KJSD_JSON_Value* new_val = NULL;
+    const char *new_string = NULL;
+
+    if (base == NULL) return ERROR;
+
+    if (value != NULL)
+    {
+        new_string = json_strndup(base->arena, value, strlen(value));
+        if (!new_string) return ERROR;
+    }
+
+    new_val = json_array_set(base, index, KJSD_JSON_STRING);
+    if (!new_val)
+    {
+        json_dealloc(base->arena, new_string);
+        return ERROR;
+    }
+    new_val->value.string = new_string;
+    return SUCCESS;
 }
 
-static KJSD_JSON_Value * parse_array_value(const char **string,
-                                           size_t nesting)
+int KJSD_JSON_arraySetNumber(KJSD_JSON_Array* base, size_t index,
+                             double value)
 {
-    KJSD_JSON_Value* output_value = json_value_init_array();
-    KJSD_JSON_Value* new_array_value = NULL;
-    KJSD_JSON_Array* output_array =
-        KJSD_JSON_valueGetArray(output_value);
-    if (!output_value) return NULL;
+    KJSD_JSON_Value* new_val = NULL;
 
-    skip_char(string);
-    skip_whitespaces(string);
-    if (**string == ']')
-    {
-        /* empty array */
-        skip_char(string);
-        return output_value;
-    }
-    while (**string != '\0')
-    {
-        new_array_value = parse_value(string, nesting);
-        if (!new_array_value)
-        {
-            KJSD_JSON_free(output_value);
-            return NULL;
-        }
-        if (json_array_add(output_array, new_array_value) == ERROR)
-        {
-            json_free(new_array_value);
-            KJSD_JSON_free(output_value);
-            return NULL;
-        }
-        skip_whitespaces(string);
-        if (**string != ',') break;
+    if (base == NULL) return ERROR;
 
-        skip_char(string);
-        skip_whitespaces(string);
-    }
-    skip_whitespaces(string);
-    if ((**string != ']') ||
-        json_array_resize(output_array,
-                          KJSD_JSON_arrayGetCount(output_array))
-        == ERROR)
-    {
-        /* Trim array after parsing is over */
-        KJSD_JSON_free(output_value);
-        return NULL;
-    }
+    new_val = json_array_set(base, index, KJSD_JSON_NUMBER);
+    if (!new_val) return ERROR;
 
-    skip_char(string);
-    return output_value;
+    new_val->value.number = value;
+    return SUCCESS;
 }
 
-static KJSD_JSON_Value * parse_string_value(const char **string)
+int KJSD_JSON_arraySetInteger(KJSD_JSON_Array* base, size_t index,
+                              int64_t value)
 {
-    const char *new_string = get_processed_string(string);
-    if (!new_string) return NULL;
+    KJSD_JSON_Value* new_val = NULL;
+
+    if (base == NULL) return ERROR;
 
-    return json_value_init_string(new_string);
+    new_val = json_array_set(base, index, KJSD_JSON_NUMBER);
+    if (!new_val) return ERROR;
+
+    new_val->is_integer = 1;
+    new_val->value.integer = value;
+    return SUCCESS;
 }
 
-static KJSD_JSON_Value * parse_bool_value(const char **string)
+int KJSD_JSON_arraySetBool(KJSD_JSON_Array* base, size_t index,
+                           int value)
 {
-    size_t true_token_size = sizeof_token("true");
-    size_t false_token_size = sizeof_token("false");
+    KJSD_JSON_Value* new_val = NULL;
 
-    if (strncmp("true", *string, true_token_size) == 0)
-    {
-        *string += true_token_size;
-        return json_value_init_bool(1);
-    }
-    else if (strncmp("false", *string, false_token_size) == 0)
-    {
-        *string += false_token_size;
-        return json_value_init_bool(0);
-    }
-    return NULL;
+    if (base == NULL) return ERROR;
+
+    new_val = json_array_set(base, index, KJSD_JSON_BOOL);
+    if (!new_val) return ERROR;
+
+    new_val->value.bool = value;
+    return SUCCESS;
 }
 
-static KJSD_JSON_Value * parse_number_value(const char **string)
+KJSD_JSON_Object* KJSD_JSON_arrayInsertObject(KJSD_JSON_Array* base,
+                                              size_t index)
 {
-    char *end;
-    double number = strtod(*string, &end);
-    KJSD_JSON_Value *output_value;
+    KJSD_JSON_Value* value = NULL;
+    KJSD_JSON_Object* new_obj = NULL;
 
-    if (is_decimal(*string, end - *string))
-    {
-        *string = end;
-        output_value = json_value_init_number(number);
-    }
-    else
+    if (base == NULL) return NULL;
+
+    new_obj = json_object_init(base->arena);
+    if (!new_obj) return NULL;
+
+    value = json_array_insert(base, index, KJSD_JSON_OBJECT);
+    if (!value)
     {
-        output_value = NULL;
+        if (!base->arena) json_object_free(new_obj);
+        return NULL;
     }
-    return output_value;
+    value->value.object = new_obj;
+    return new_obj;
 }
 
-static KJSD_JSON_Value * parse_null_value(const char **string)
+KJSD_JSON_Array* KJSD_JSON_arrayInsertArray(KJSD_JSON_Array* base,
+                                            size_t index)
 {
-    size_t token_size = sizeof_token("null");
-    if (strncmp("null", *string, token_size) == 0)
+    KJSD_JSON_Value* value = NULL;
+    KJSD_JSON_Array* new_array = NULL;
+
+    if (base == NULL) return NULL;
+
+    new_array = json_array_init(base->arena);
+    if (!new_array) return NULL;
+
+    value = json_array_insert(base, index, KJSD_JSON_ARRAY);
+    if (!value)
     {
-        *string += token_size;
-        return json_value_init_null();
+        if (!base->arena) json_array_free(new_array);
+        return NULL;
     }
-    return NULL;
+    value->value.array = new_array;
+    return new_array;
 }
 
-/* Parser API */
-KJSD_JSON_Value* KJSD_JSON_deserialize(FILE* in)
+int KJSD_JSON_arrayInsertString(KJSD_JSON_Array* base, size_t index,
+                                const char* value)
 {
-    size_t file_size;
-    char *file_contents;
-    KJSD_JSON_Value *output_value;
+    KJSD_JSON_Value* new_val = NULL;
+    const char *new_string = NULL;
 
-    if (!in) return NULL;
+    if (base == NULL) return ERROR;
 
-    fseek(in, 0L, SEEK_END);
-    file_size = ftell(in);
-    rewind(in);
-    file_contents = (char*)json_malloc(sizeof(char) * (file_size + 1));
-    if (!file_contents)
+    if (value != NULL)
     {
-        return NULL;
+        new_string = json_strndup(base->arena, value, strlen(value));
+        if (!new_string) return ERROR;
     }
 
-    fread(file_contents, file_size, 1, in);
-    file_contents[file_size] = '\0';
-    output_value = KJSD_JSON_deserializeS(file_contents);
-    json_free(file_contents);
-
-    return output_value;
+    new_val = json_array_insert(base, index, KJSD_JSON_STRING);
+    if (!new_val)
+    {
+        json_dealloc(base->arena, new_string);
+        return ERROR;
+    }
+    new_val->value.string = new_string;
+    return SUCCESS;
 }
 
-KJSD_JSON_Value* KJSD_JSON_deserializeS(const char *string)
+int KJSD_JSON_arrayInsertNumber(KJSD_JSON_Array* base, size_t index,
+                                double value)
 {
-    if (!string || (*string != '{' && *string != '[')) return NULL;
+    KJSD_JSON_Value* new_val = NULL;
 
-    return parse_value((const char**)&string, 0);
-}
+    if (base == NULL) return ERROR;
 
-/* JSON Object API */
-KJSD_JSON_Value* KJSD_JSON_objectGetValue(
-    const KJSD_JSON_Object *object, const char *name)
-{
-    if ((object == NULL) || (name == NULL)) return NULL;
+    new_val = json_array_insert(base, index, KJSD_JSON_NUMBER);
+    if (!new_val) return ERROR;
 
-    return json_object_nget_value(object, name, strlen(name));
+    new_val->value.number = value;
+    return SUCCESS;
 }
 
-const char* KJSD_JSON_objectGetString(
-    const KJSD_JSON_Object *object, const char *name)
+int KJSD_JSON_arrayInsertInteger(KJSD_JSON_Array* base, size_t index,
+                                 int64_t value)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    KJSD_JSON_Value* new_val = NULL;
 
-    return KJSD_JSON_valueGetString(
-        KJSD_JSON_objectGetValue(object, name));
+    if (base == NULL) return ERROR;
+
+    new_val = json_array_insert(base, index, KJSD_JSON_NUMBER);
+    if (!new_val) return ERROR;
+
+    new_val->is_integer = 1;
+    new_val->value.integer = value;
+    return SUCCESS;
 }
 
-double KJSD_JSON_objectGetNumber(
-    const KJSD_JSON_Object *object, const char *name)
+int KJSD_JSON_arrayInsertBool(KJSD_JSON_Array* base, size_t index,
+                              int value)
 {
-    if ((object == NULL) || (name == NULL)) return 0;
+    KJSD_JSON_Value* new_val = NULL;
 
-    return KJSD_JSON_valueGetNumber(
-        KJSD_JSON_objectGetValue(object, name));
+    if (base == NULL) return ERROR;
+
+    new_val = json_array_insert(base, index, KJSD_JSON_BOOL);
+    if (!new_val) return ERROR;
+
+    new_val->value.bool = value;
+    return SUCCESS;
 }
 
-KJSD_JSON_Object* KJSD_JSON_objectGetObject(
-    const KJSD_JSON_Object *object, const char *name)
+int KJSD_JSON_arrayRemove(KJSD_JSON_Array* base, size_t index)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    if ((base == NULL) || !json_array_load(base) || (index >= base->count))
+        return ERROR;
 
-    return KJSD_JSON_valueGetObject(
-        KJSD_JSON_objectGetValue(object, name));
+    json_value_free(base->arena, base->items[index]);
+    base->count--;
+    memmove(base->items + index, base->items + index + 1,
+            (base->count - index) * sizeof(KJSD_JSON_Value*));
+    return SUCCESS;
 }
 
-KJSD_JSON_Array* KJSD_JSON_objectGetArray(
-    const KJSD_JSON_Object *object, const char *name)
+int KJSD_JSON_patch(KJSD_JSON_Value *target, const KJSD_JSON_Value *patch)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    const KJSD_JSON_Object *op;
+    size_t i, count;
 
-    return KJSD_JSON_valueGetArray(
-        KJSD_JSON_objectGetValue(object, name));
+    if ((target == NULL) ||
+        (KJSD_JSON_valueGetType(patch) != KJSD_JSON_ARRAY)) return ERROR;
+
+    count = KJSD_JSON_arrayGetCount(patch->value.array);
+    for (i = 0; i < count; i++)
+    {
+        op = KJSD_JSON_arrayGetObject(patch->value.array, i);
+        if (!op || (json_patch_op(target, op) == ERROR)) return ERROR;
+    }
+    return SUCCESS;
 }
 
-int KJSD_JSON_objectGetBool(const KJSD_JSON_Object *object,
-                            const char *name)
+int KJSD_JSON_mergePatch(KJSD_JSON_Value *target,
+                         const KJSD_JSON_Value *patch)
 {
-    if ((object == NULL) || (name == NULL)) return -1;
+    if ((target == NULL) || (patch == NULL)) return ERROR;
 
-    return KJSD_JSON_valueGetBool(
-        KJSD_JSON_objectGetValue(object, name));
+    return json_merge_patch(json_value_arena(target), target, patch);
 }
 
-KJSD_JSON_Value * KJSD_JSON_objectDotGetValue(
-    const KJSD_JSON_Object *object, const char *name)
+KJSD_JSON_Value* KJSD_JSON_diff(const KJSD_JSON_Value *from,
+                                const KJSD_JSON_Value *to)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    KJSD_JSON_Value *ops;
+    json_differ d;
+    int success;
 
-    const char *dot_position = strchr(name, '.');
-    if (!dot_position)
+    if ((from == NULL) || (to == NULL)) return NULL;
+
+    ops = json_value_init_array(NULL);
+    if (!ops) return NULL;
+
+    memset(&d, 0, sizeof(json_differ));
+    d.ops = ops->value.array;
+    success = json_diff_value(&d, from, to);
+    json_free(d.path);
+    if (!success)
     {
-        return KJSD_JSON_objectGetValue(object, name);
+        KJSD_JSON_free(ops);
+        return NULL;
     }
-
-    object = KJSD_JSON_valueGetObject(
-        json_object_nget_value(object, name, dot_position - name));
-    return KJSD_JSON_objectDotGetValue(object, dot_position + 1);
+    return ops;
 }
 
-const char* KJSD_JSON_objectDotGetString(
-    const KJSD_JSON_Object *object, const char *name)
+KJSD_JSON_Value* KJSD_JSON_mergeDiff(const KJSD_JSON_Value *from,
+                                     const KJSD_JSON_Value *to)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    KJSD_JSON_Value *patch;
 
-    return KJSD_JSON_valueGetString(
-        KJSD_JSON_objectDotGetValue(object, name));
+    if ((from == NULL) || (to == NULL)) return NULL;
+
+    patch = json_value_alloc(NULL, KJSD_JSON_NULL);
+    if (!patch) return NULL;
+
+    if (json_merge_diff(patch, from, to) == ERROR)
+    {
+        KJSD_JSON_free(patch);
+        return NULL;
+    }
+    return patch;
 }
 
-double KJSD_JSON_objectDotGetNumber(
-    const KJSD_JSON_Object *object, const char *name)
+size_t KJSD_JSON_serialize(const KJSD_JSON_Value* value, FILE* out)
 {
-    if ((object == NULL) || (name == NULL)) return 0;
+    json_writer w;
 
-    return KJSD_JSON_valueGetNumber(
-        KJSD_JSON_objectDotGetValue(object, name));
+    if ((value == NULL) || (out == NULL)) return 0;
+
+    json_writer_init(&w, JSON_SINK_FILE);
+    w.sink.file = out;
+
+    return json_serialize_with(value, &w);
 }
 
-KJSD_JSON_Object* KJSD_JSON_objectDotGetObject(
-    const KJSD_JSON_Object *object, const char *name)
+size_t KJSD_JSON_serializeS(const KJSD_JSON_Value* value,
+                            char* out, size_t size)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    json_writer w;
 
-    return KJSD_JSON_valueGetObject(
-        KJSD_JSON_objectDotGetValue(object, name));
+    if ((value == NULL) || (out == NULL) || (size == 0)) return 0;
+
+    json_writer_init(&w, JSON_SINK_MEM);
+    w.buf = out;
+    w.capacity = size - 1;
+
+    return json_serialize_with(value, &w);
 }
 
-KJSD_JSON_Array* KJSD_JSON_objectDotGetArray(
-    const KJSD_JSON_Object *object, const char *name)
+char* KJSD_JSON_serializeAlloc(const KJSD_JSON_Value* value, size_t *length)
 {
-    if ((object == NULL) || (name == NULL)) return NULL;
+    json_writer w;
 
-    return KJSD_JSON_valueGetArray(
-        KJSD_JSON_objectDotGetValue(object, name));
+    if (length != NULL) *length = 0;
+    if (value == NULL) return NULL;
+
+    if (json_writer_init_buffer(&w) == ERROR) return NULL;
+    json_serialize(value, &w);
+
+    return json_writer_release(&w, length);
 }
 
-int KJSD_JSON_objectDotGetBool(
-    const KJSD_JSON_Object *object, const char *name)
+char* KJSD_JSON_serializeBinary(const KJSD_JSON_Value* value,
+                                size_t *length)
 {
-    if ((object == NULL) || (name == NULL)) return -1;
+    json_writer w;
 
-    return KJSD_JSON_valueGetBool(
-        KJSD_JSON_objectDotGetValue(object, name));
+    if (length != NULL) *length = 0;
+    if (value == NULL) return NULL;
+
+    if (json_writer_init_buffer(&w) == ERROR) return NULL;
+    json_write(&w, BINARY_MAGIC, BINARY_MAGIC_SIZE);
+    json_serialize_binary(value, &w);
+
+    return json_writer_release(&w, length);
 }
 
-size_t KJSD_JSON_objectGetCount(const KJSD_JSON_Object *object)
+void KJSD_JSON_freeString(char *string)
 {
-    return object ? object->count : 0;
+    json_free(string);
 }
 
-const char* KJSD_JSON_objectGetName(
-    const KJSD_JSON_Object *object, size_t index)
+size_t KJSD_JSON_serializeFd(const KJSD_JSON_Value* value, int fd)
 {
-    if (index >= KJSD_JSON_objectGetCount(object)) return NULL;
-    return object->names[index];
+    json_writer w;
+
+    if ((value == NULL) || (fd < 0)) return 0;
+
+    json_writer_init(&w, JSON_SINK_FD);
+    w.sink.fd = fd;
+
+    return json_serialize_with(value, &w);
 }
 
-/* JSON Array API */
-KJSD_JSON_Value* KJSD_JSON_arrayGetValue(
-    const KJSD_JSON_Array *array, size_t index)
+size_t KJSD_JSON_serializeCallback(const KJSD_JSON_Value* value,
+                                   KJSD_JSON_WriteFunc func, void *ctx)
 {
-    if (index >= KJSD_JSON_arrayGetCount(array)) return NULL;
-    return array->items[index];
+    json_writer w;
+
+    if ((value == NULL) || (func == NULL)) return 0;
+
+    json_writer_init(&w, JSON_SINK_CALLBACK);
+    w.sink.callback.func = func;
+    w.sink.callback.ctx = ctx;
+
+    return json_serialize_with(value, &w);
 }
 
-const char* KJSD_JSON_arrayGetString(
-    const KJSD_JSON_Array *array, size_t index)
+size_t KJSD_JSON_serializeFormat(const KJSD_JSON_Value* value,
+                                 const KJSD_JSON_Format *format, FILE* out)
 {
-    return KJSD_JSON_valueGetString(
-        KJSD_JSON_arrayGetValue(array, index));
+    json_writer w;
+
+    if ((value == NULL) || (out == NULL)) return 0;
+
+    json_writer_init(&w, JSON_SINK_FILE);
+    w.sink.file = out;
+    json_serialize_formatted(value, format, &w);
+
+    return json_writer_finish(&w);
 }
 
-double KJSD_JSON_arrayGetNumber(const KJSD_JSON_Array *array,
-                                size_t index)
+char* KJSD_JSON_serializeFormatAlloc(const KJSD_JSON_Value* value,
+                                     const KJSD_JSON_Format *format,
+                                     size_t *length)
 {
-    return KJSD_JSON_valueGetNumber(
-        KJSD_JSON_arrayGetValue(array, index));
+    json_writer w;
+
+    if (length != NULL) *length = 0;
+    if (value == NULL) return NULL;
+
+    if (json_writer_init_buffer(&w) == ERROR) return NULL;
+    json_serialize_formatted(value, format, &w);
+
+    return json_writer_release(&w, length);
 }
 
-KJSD_JSON_Object* KJSD_JSON_arrayGetObject(
-    const KJSD_JSON_Array *array, size_t index)
+size_t KJSD_JSON_serializeFormatCallback(const KJSD_JSON_Value* value,
+                                         const KJSD_JSON_Format *format,
+                                         KJSD_JSON_WriteFunc func, void *ctx)
 {
-    return KJSD_JSON_valueGetObject(
-        KJSD_JSON_arrayGetValue(array, index));
+    json_writer w;
+
+    if ((value == NULL) || (func == NULL)) return 0;
+
+    json_writer_init(&w, JSON_SINK_CALLBACK);
+    w.sink.callback.func = func;
+    w.sink.callback.ctx = ctx;
+    json_serialize_formatted(value, format, &w);
+
+    return json_writer_finish(&w);
 }
 
-KJSD_JSON_Array* KJSD_JSON_arrayGetArray(
-    const KJSD_JSON_Array *array, size_t index)
+size_t KJSD_JSON_sizeof(const KJSD_JSON_Value* value)
 {
-    return KJSD_JSON_valueGetArray(
-        KJSD_JSON_arrayGetValue(array, index));
+    json_writer w;
+
+    if (value == NULL) return 0;
+
+    json_writer_init(&w, JSON_SINK_NULL);
+
+    return json_serialize_with(value, &w);
 }
 
-int KJSD_JSON_arrayGetBool(const KJSD_JSON_Array *array,
-                           size_t index)
+void json_writer_init(json_writer *w, json_sink_type type)
 {
-    return KJSD_JSON_valueGetBool(
-        KJSD_JSON_arrayGetValue(array, index));
+    w->type = type;
+    w->buf = w->block;
+    w->used = 0;
+    w->capacity = sizeof(w->block);
+    w->total = 0;
+    w->error = 0;
 }
 
-size_t KJSD_JSON_arrayGetCount(const KJSD_JSON_Array *array)
+void json_writer_flush(json_writer *w)
 {
-    return array ? array->count : 0;
+    size_t done = 0;
+
+    switch (w->type)
+    {
+    case JSON_SINK_FILE:
+        done = fwrite(w->buf, 1, w->used, w->sink.file);
+        break;
+    case JSON_SINK_FD:
+        while (done < w->used)
+        {
+            long n = (long)json_fd_write(w->sink.fd,
+                                         w->buf + done, w->used - done);
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+        break;
+    case JSON_SINK_CALLBACK:
+        done = w->sink.callback.func(w->sink.callback.ctx,
+                                     w->buf, w->used);
+        if (done > w->used) done = w->used;
+        break;
+    case JSON_SINK_BUFFER:
+        /* One byte past capacity is kept for the terminator */
+        if (w->capacity < ((size_t)-1) / 2)
+        {
+            size_t capacity = (w->capacity + 1) * 2;
+            char *buf = (char*)json_realloc(w->buf, capacity);
+
+            if (buf != NULL)
+            {
+                w->buf = buf;
+                w->capacity = capacity - 1;
+                return;
+            }
+        }
+        w->error = 1;
+        return;
+    case JSON_SINK_MEM:
+        /* The caller's buffer is full; the rest is dropped. */
+        w->total += w->used;
+        w->buf += w->used;
+        w->capacity -= w->used;
+        w->used = 0;
+        w->error = 1;
+        return;
+    default:
+        done = w->used;
+        break;
+    }
+
+    w->total += done;
+    if (done < w->used) w->error = 1;
+    w->used = 0;
 }
 
-/* JSON Value API */
-KJSD_JSON_Type KJSD_JSON_valueGetType(
-    const KJSD_JSON_Value *value)
+size_t json_writer_finish(json_writer *w)
 {
-    return value ? value->type : KJSD_JSON_ERROR;
+    if ((w->type == JSON_SINK_MEM) || (w->type == JSON_SINK_BUFFER))
+    {
+        w->buf[w->used] = '\0';
+        w->total += w->used;
+        w->used = 0;
+        return w->total;
+    }
+
+    if (!w->error) json_writer_flush(w);
+    if (w->type == JSON_SINK_FILE) fflush(w->sink.file);
+
+    return w->total;
 }
 
-KJSD_JSON_Object* KJSD_JSON_valueGetObject(
-    const KJSD_JSON_Value *value)
+void json_write(json_writer *w, const char *data, size_t n)
 {
-    return KJSD_JSON_valueGetType(value) == KJSD_JSON_OBJECT ?
-        value->value.object : NULL;
-}
+    if (w->type == JSON_SINK_NULL)
+    {
+        w->total += n;
+        return;
+    }
 
-KJSD_JSON_Array* KJSD_JSON_valueGetArray(
-    const KJSD_JSON_Value *value)
+    while (!w->error && (n > 0))
+    {
+        size_t room = w->capacity - w->used;
+
+        if (n <= room)
+        {
+            memcpy(w->buf + w->used, data, n);
+            w->used += n;
+            return;
+        }
+        memcpy(w->buf + w->used, data, room);
+        w->used += room;
+        data += room;
+        n -= room;
+        json_writer_flush(w);
+    }
+}
+
+void json_write_char(json_writer *w, char c)
 {
-    return KJSD_JSON_valueGetType(value) == KJSD_JSON_ARRAY ?
-        value->value.array : NULL;
+    if (w->used < w->capacity) w->buf[w->used++] = c;
+    else json_write(w, &c, 1);
 }
 
-const char* KJSD_JSON_valueGetString(
-    const KJSD_JSON_Value *value)
+size_t json_serialize_with(const KJSD_JSON_Value* value, json_writer *w)
 {
-    return KJSD_JSON_valueGetType(value) == KJSD_JSON_STRING ?
-        value->value.string : NULL;
+    json_serialize(value, w);
+
+    return json_writer_finish(w);
 }
 
-double KJSD_JSON_valueGetNumber(const KJSD_JSON_Value *value)
+int json_writer_init_buffer(json_writer *w)
 {
-    return KJSD_JSON_valueGetType(value) == KJSD_JSON_NUMBER ?
-        value->value.number : 0;
+    json_writer_init(w, JSON_SINK_BUFFER);
+    w->buf = (char*)json_malloc(WRITER_BUFFER_SIZE);
+    if (w->buf == NULL) return ERROR;
+    w->capacity = WRITER_BUFFER_SIZE - 1;
+    return SUCCESS;
 }
 
-int KJSD_JSON_valueGetBool(const KJSD_JSON_Value *value)
+/* Hands over the heap buffer of a buffer sink */
+char* json_writer_release(json_writer *w, size_t *length)
 {
-    return KJSD_JSON_valueGetType(value) == KJSD_JSON_BOOL ?
-        value->value.bool : -1;
+    size_t n = json_writer_finish(w);
+    char *out;
+
+    if (w->error)
+    {
+        json_free(w->buf);
+        return NULL;
+    }
+
+    /* Give back what the doubling left unused */
+    out = (char*)json_realloc(w->buf, n + 1);
+    if (out == NULL) out = w->buf;
+
+    if (length != NULL) *length = n;
+    return out;
 }
 
-void KJSD_JSON_free(KJSD_JSON_Value *value)
+void json_serialize(const KJSD_JSON_Value* value, json_writer *w)
 {
     switch (KJSD_JSON_valueGetType(value))
     {
     case KJSD_JSON_OBJECT:
-        json_object_free(value->value.object);
+        json_serialize_object(value->value.object, w);
+        break;
+    case KJSD_JSON_ARRAY:
+        json_serialize_array(value->value.array, w);
         break;
     case KJSD_JSON_STRING:
-        if (value->value.string)
-        {
-            json_free(value->value.string);
-        }
+        /* A string set from NULL is written as null */
+        if (value->value.string) json_serialize_string(value->value.string, w);
+        else json_write_literal(w, "null");
         break;
-    case KJSD_JSON_ARRAY:
-        json_array_free(value->value.array);
+    case KJSD_JSON_NUMBER:
+        json_serialize_number(value, w);
+        break;
+    case KJSD_JSON_BOOL:
+        if (value->value.bool) json_write_literal(w, "true");
+        else json_write_literal(w, "false");
+        break;
+    case KJSD_JSON_NULL:
+        json_write_literal(w, "null");
         break;
     default:
         break;
     }
-    json_free(value);
-}
-
-KJSD_JSON_Value* KJSD_JSON_createRoot(void)
-{
-    return json_value_init_object();
 }
 
-KJSD_JSON_Object* KJSD_JSON_objectAddObject(
-    KJSD_JSON_Object* base,
-    const char* name)
+void json_serialize_object(const KJSD_JSON_Object* value, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
-
-    if ((base == NULL) || (name == NULL)) return ERROR;
+    size_t i;
 
-    new_val = json_value_init_object();
-    if (json_object_add(base, name, new_val) == ERROR)
+    value = json_object_source(value);
+    if (!json_object_load(value))
     {
-        KJSD_JSON_free(new_val);
-        return NULL;
+        w->error = 1;
+        return;
     }
-    return KJSD_JSON_valueGetObject(new_val);
-}
-
-KJSD_JSON_Array* KJSD_JSON_objectAddArray(
-    KJSD_JSON_Object* base, const char* name)
-{
-    KJSD_JSON_Value* new_val = NULL;
-
-    if ((base == NULL) || (name == NULL)) return ERROR;
-
-    new_val = json_value_init_array();
-    if (json_object_add(base, name, new_val) == ERROR)
+    json_write_char(w, '{');
+    for (i = 0; i < value->count; i++)
     {
-        KJSD_JSON_free(new_val);
-        new_val = NULL;
+        if (i > 0) json_write_char(w, ',');
+        json_serialize_string(value->names[i], w);
+        json_write_char(w, ':');
+        json_serialize(value->values[i], w);
     }
-    return KJSD_JSON_valueGetArray(new_val);
+    json_write_char(w, '}');
 }
 
-int KJSD_JSON_objectAddString(KJSD_JSON_Object* base,
-                              const char* name,
-                              const char* value)
+void json_serialize_array(const KJSD_JSON_Array* value, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
-    const char *new_string = NULL;
-
-    if ((base == NULL) || (name == NULL)) return ERROR;
+    size_t i;
 
-    if (value != NULL)
+    value = json_array_source(value);
+    if (!json_array_load(value))
     {
-        new_string = json_strndup(value, strlen(value));
+        w->error = 1;
+        return;
     }
-
-    new_val = json_value_init_string(new_string);
-    if (json_object_add(base, name, new_val) == ERROR)
+    json_write_char(w, '[');
+    for (i = 0; i < value->count; i++)
     {
-        KJSD_JSON_free(new_val);
-        return ERROR;
+        if (i > 0) json_write_char(w, ',');
+        json_serialize(value->items[i], w);
     }
-    return SUCCESS;
+    json_write_char(w, ']');
 }
 
-int KJSD_JSON_objectAddNumber(KJSD_JSON_Object* base,
-                              const char* name,
-                              double value)
+void json_serialize_string(const char* value, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
-
-    if ((base == NULL) || (name == NULL)) return ERROR;
+    static const char hex[] = "0123456789abcdef";
+    const char *cur = value;
+    const char *end = value + strlen(value);
 
-    new_val = json_value_init_number(value);
-    if (json_object_add(base, name, new_val) == ERROR)
+    json_write_char(w, '"');
+    while (cur < end)
     {
-        KJSD_JSON_free(new_val);
-        return ERROR;
+        const char *run = cur;
+        unsigned char c;
+        char e;
+
+        cur = json_scan_escape(cur, end);
+        if (cur > run) json_write(w, run, cur - run);
+        if (cur == end) break;
+
+        c = (unsigned char)*cur++;
+        e = json_escape_table[c];
+        json_write_char(w, '\\');
+        json_write_char(w, e);
+        if (e == 'u')
+        {
+            char code[4];
+
+            code[0] = '0';
+            code[1] = '0';
+            code[2] = hex[c >> 4];
+            code[3] = hex[c & 0xF];
+            json_write(w, code, sizeof(code));
+        }
     }
-    return SUCCESS;
+    json_write_char(w, '"');
 }
 
-int KJSD_JSON_objectAddBool(KJSD_JSON_Object* base,
-                            const char* name, int value)
+void json_serialize_number(const KJSD_JSON_Value* value, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
+    char buf[NUMBER_BUF_SIZE];
+    size_t n;
 
-    if ((base == NULL) || (name == NULL)) return ERROR;
+    if (value->is_integer) n = json_format_integer(value->value.integer, buf);
+    else n = json_format_double(value->value.number, buf);
 
-    new_val = json_value_init_bool(value);
-    if (json_object_add(base, name, new_val) == ERROR)
-    {
-        KJSD_JSON_free(new_val);
-        return ERROR;
-    }
-    return SUCCESS;
+    json_write(w, buf, n);
 }
 
-KJSD_JSON_Object* KJSD_JSON_arrayAddObject(
-    KJSD_JSON_Array* base)
+/* Formatted output. Compact output without sorting takes the plain
+   serializer, so the formatting checks stay off its path. */
+void json_serialize_formatted(const KJSD_JSON_Value* value,
+                              const KJSD_JSON_Format *format,
+                              json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
-
-    if (base == NULL) return ERROR;
-
-    new_val = json_value_init_object();
-    if (json_array_add(base, new_val) == ERROR)
+    if ((format == NULL) || ((format->indent <= 0) && !format->sort_keys))
     {
-        KJSD_JSON_free(new_val);
-        return NULL;
+        json_serialize(value, w);
+    }
+    else
+    {
+        json_serialize_format(value, format, 0, w);
     }
-    return KJSD_JSON_valueGetObject(new_val);
 }
 
-KJSD_JSON_Array* KJSD_JSON_arrayAddArray(
-    KJSD_JSON_Array* base)
+void json_serialize_format(const KJSD_JSON_Value* value,
+                           const KJSD_JSON_Format *format,
+                           size_t depth, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
-
-    if (base == NULL) return ERROR;
-
-    new_val = json_value_init_array();
-    if (json_array_add(base, new_val) == ERROR)
+    switch (KJSD_JSON_valueGetType(value))
     {
-        KJSD_JSON_free(new_val);
-        return NULL;
+    case KJSD_JSON_OBJECT:
+        json_serialize_format_object(value->value.object, format, depth, w);
+        break;
+    case KJSD_JSON_ARRAY:
+        json_serialize_format_array(value->value.array, format, depth, w);
+        break;
+    default:
+        json_serialize(value, w);
+        break;
     }
-    return KJSD_JSON_valueGetArray(new_val);
 }
 
-int KJSD_JSON_arrayAddString(KJSD_JSON_Array* base,
-                             const char* value)
+/* Members are visited in name order through a sorted array of pointers
+   into names, so neither the object nor the output is copied */
+void json_serialize_format_object(const KJSD_JSON_Object* value,
+                                  const KJSD_JSON_Format *format,
+                                  size_t depth, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
-    const char *new_string = NULL;
-
-    if (base == NULL) return ERROR;
+    const char **stack[FORMAT_SORT_STACK];
+    const char ***order = NULL;
+    size_t i;
 
-    if (value != NULL)
+    value = json_object_source(value);
+    if (!json_object_load(value))
+    {
+        w->error = 1;
+        return;
+    }
+    if (value->count == 0)
+    {
+        json_write_literal(w, "{}");
+        return;
+    }
+    if (format->sort_keys && (value->count > 1))
     {
-        new_string = json_strndup(value, strlen(value));
+        order = stack;
+        if (value->count > FORMAT_SORT_STACK)
+        {
+            order = (const char***)json_malloc(
+                value->count * sizeof(const char**));
+            if (order == NULL)
+            {
+                w->error = 1;
+                return;
+            }
+        }
+        for (i = 0; i < value->count; i++) order[i] = &value->names[i];
+        qsort(order, value->count, sizeof(const char**), json_name_compare);
     }
 
-    new_val = json_value_init_string(new_string);
-    if (json_array_add(base, new_val) == ERROR)
+    json_write_char(w, '{');
+    for (i = 0; i < value->count; i++)
     {
-        KJSD_JSON_free(new_val);
-        return ERROR;
+        size_t k = order ? (size_t)(order[i] - value->names): i;
+
+        if (i > 0) json_write_char(w, ',');
+        json_write_indent(w, format, depth + 1);
+        json_serialize_string(value->names[k], w);
+        json_write_char(w, ':');
+        if (format->indent > 0) json_write_char(w, ' ');
+        json_serialize_format(value->values[k], format, depth + 1, w);
     }
-    return SUCCESS;
+    json_write_indent(w, format, depth);
+    json_write_char(w, '}');
+
+    if (order != stack) json_free(order);
 }
 
-int KJSD_JSON_arrayAddNumber(KJSD_JSON_Array* base,
-                             double value)
+void json_serialize_format_array(const KJSD_JSON_Array* value,
+                                 const KJSD_JSON_Format *format,
+                                 size_t depth, json_writer *w)
 {
-    KJSD_JSON_Value* new_val = NULL;
+    size_t i;
 
-    if (base == NULL) return ERROR;
+    value = json_array_source(value);
+    if (!json_array_load(value))
+    {
+        w->error = 1;
+        return;
+    }
+    if (value->count == 0)
+    {
+        json_write_literal(w, "[]");
+        return;
+    }
 
-    new_val = json_value_init_number(value);
-    if (json_array_add(base, new_val) == ERROR)
+    json_write_char(w, '[');
+    for (i = 0; i < value->count; i++)
     {
-        KJSD_JSON_free(new_val);
-        return ERROR;
+        if (i > 0) json_write_char(w, ',');
+        json_write_indent(w, format, depth + 1);
+        json_serialize_format(value->items[i], format, depth + 1, w);
     }
-    return SUCCESS;
+    json_write_indent(w, format, depth);
+    json_write_char(w, ']');
 }
 
-int KJSD_JSON_arrayAddBool(KJSD_JSON_Array* base, int value)
+/* Starts a line indented for depth; nothing in compact output */
+void json_write_indent(json_writer *w, const KJSD_JSON_Format *format,
+                       size_t depth)
 {
-    KJSD_JSON_Value* new_val = NULL;
+    static const char spaces[] = "                                ";
+    size_t n;
 
-    if (base == NULL) return ERROR;
+    if (format->indent <= 0) return;
 
-    new_val = json_value_init_bool(value);
-    if (json_array_add(base, new_val) == ERROR)
+    json_write_char(w, '\n');
+    n = (size_t)format->indent * depth;
+    while (n > sizeof(spaces) - 1)
     {
-        KJSD_JSON_free(new_val);
-        return ERROR;
+        json_write_literal(w, spaces);
+        n -= sizeof(spaces) - 1;
     }
-    return SUCCESS;
+    json_write(w, spaces, n);
 }
 
-size_t KJSD_JSON_serialize(const KJSD_JSON_Value* value, FILE* out)
+/* Orders pointers into a names array by name, in UTF-8 byte order.
+   Equal names keep their member order. */
+int json_name_compare(const void *a, const void *b)
 {
-    json_accessor outer = {
-        JSON_DEV_FILE, { NULL }
-    };
-    outer.obj.file = out;
-
-    if ((value == NULL) || (outer.obj.file == NULL)) return 0;
+    const char **x = *(const char ***)a;
+    const char **y = *(const char ***)b;
+    int c = strcmp(*x, *y);
 
-    return json_serialize(value, &outer);
+    if (c != 0) return c;
+    return (x < y) ? -1: (x > y);
 }
 
-size_t KJSD_JSON_serializeS(const KJSD_JSON_Value* value,
-                            char* out, size_t size)
+/* Binary */
+void json_write_varint(json_writer *w, uint64_t value)
 {
-    json_accessor outer = {
-        JSON_DEV_MEM, { NULL }
-    };
-    outer.obj.str.buf = out;
-    outer.obj.str.size = size;
+    char buf[10];
+    size_t n = 0;
 
-    if ((value == NULL) || (outer.obj.str.buf == NULL)) return 0;
-    
-    return json_serialize(value, &outer);
+    while (value >= 0x80)
+    {
+        buf[n++] = (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buf[n++] = (char)value;
+    json_write(w, buf, n);
 }
 
-size_t KJSD_JSON_sizeof(const KJSD_JSON_Value* value)
+/* Little endian regardless of the host */
+void json_write_u64(json_writer *w, uint64_t value)
 {
-    json_accessor outer = {
-        JSON_DEV_NULL, { NULL }
-    };
+    char buf[8];
+    size_t i;
 
-    if (value == NULL) return 0;
-    
-    return json_serialize(value, &outer);
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = (char)(value & 0xFF);
+        value >>= 8;
+    }
+    json_write(w, buf, sizeof(buf));
 }
 
-size_t json_serialize(const KJSD_JSON_Value* value, json_accessor* out)
+/* Every value is a tag byte and its payload. Counts and lengths are
+   varints placed before the contents, integers are zigzag varints and
+   numbers are IEEE 754 doubles. */
+void json_serialize_binary(const KJSD_JSON_Value* value, json_writer *w)
 {
-    switch (KJSD_JSON_valueGetType(value))
+    const KJSD_JSON_Object *object;
+    const KJSD_JSON_Array *array;
+    size_t i, n;
+
+    switch (value->type)
     {
     case KJSD_JSON_OBJECT:
-        return json_serialize_object(KJSD_JSON_valueGetObject(value),
-                                     out);
+        object = json_object_source(value->value.object);
+        if (!json_object_load(object))
+        {
+            w->error = 1;
+            break;
+        }
+        json_write_char(w, BINARY_OBJECT);
+        json_write_varint(w, object->count);
+        for (i = 0; i < object->count; i++)
+        {
+            const char *name = object->names[i];
+
+            n = strlen(name);
+            json_write_varint(w, n);
+            json_write(w, name, n);
+            json_serialize_binary(object->values[i], w);
+        }
+        break;
     case KJSD_JSON_ARRAY:
-        return json_serialize_array(KJSD_JSON_valueGetArray(value),
-                                    out);
+        array = json_array_source(value->value.array);
+        if (!json_array_load(array))
+        {
+            w->error = 1;
+            break;
+        }
+        json_write_char(w, BINARY_ARRAY);
+        json_write_varint(w, array->count);
+        for (i = 0; i < array->count; i++)
+        {
+            json_serialize_binary(array->items[i], w);
+        }
+        break;
     case KJSD_JSON_STRING:
-        return json_serialize_string(KJSD_JSON_valueGetString(value),
-                                     out);
+        /* A string set from NULL reads back as null, as in text */
+        if (!value->value.string)
+        {
+            json_write_char(w, BINARY_NULL);
+            break;
+        }
+        n = strlen(value->value.string);
+        json_write_char(w, BINARY_STRING);
+        json_write_varint(w, n);
+        json_write(w, value->value.string, n);
+        break;
     case KJSD_JSON_NUMBER:
-        return json_serialize_number(KJSD_JSON_valueGetNumber(value),
-                                     out);
+        if (value->is_integer)
+        {
+            uint64_t u = (uint64_t)value->value.integer;
+
+            json_write_char(w, BINARY_INTEGER);
+            json_write_varint(w, (u << 1) ^ (0 - (u >> 63)));
+        }
+        else
+        {
+            uint64_t bits;
+
+            memcpy(&bits, &value->value.number, sizeof(bits));
+            json_write_char(w, BINARY_NUMBER);
+            json_write_u64(w, bits);
+        }
+        break;
     case KJSD_JSON_BOOL:
-        return json_serialize_bool(KJSD_JSON_valueGetBool(value),
-                                   out);
+        json_write_char(w, value->value.bool ? BINARY_TRUE: BINARY_FALSE);
+        break;
+    case KJSD_JSON_NULL:
+        json_write_char(w, BINARY_NULL);
+        break;
     default:
         break;
     }
-
-    return 0;
 }
 
-size_t json_serialize_object(KJSD_JSON_Object* value, json_accessor* out)
+KJSD_JSON_Value* json_deserialize_binary(KJSD_JSON_Arena *arena,
+                                         const void *data, size_t size)
 {
-    size_t i;
-    size_t num = KJSD_JSON_objectGetCount(value);
-    size_t sz = 0;
+    json_binary_reader r;
+    KJSD_JSON_Value *value;
 
-    sz += json_serialize_vanilla("{", out);
-    for (i = 0; i < num; i++)
-    {
-        const char* name = KJSD_JSON_objectGetName(value, i);
+    if ((size < BINARY_MAGIC_SIZE) ||
+        (memcmp(data, BINARY_MAGIC, BINARY_MAGIC_SIZE) != 0)) return NULL;
 
-        sz += json_serialize_string(name, out);
-        sz += json_serialize_vanilla(":", out);
+    r.arena = arena;
+    r.cur = (const unsigned char*)data + BINARY_MAGIC_SIZE;
+    r.end = (const unsigned char*)data + size;
+    r.depth = 0;
+    memset(&r.keys, 0, sizeof(json_intern));
 
-        sz += json_serialize(KJSD_JSON_objectGetValue(value, name), out);
-        if (i < (num - 1))
-        {
-            sz += json_serialize_vanilla(",", out);
-        }
+    value = json_binary_value(&r);
+    json_intern_release(&r.keys);
+    if (value && (r.cur != r.end))
+    {
+        json_value_free(arena, value);
+        return NULL;
     }
-    sz += json_serialize_vanilla("}", out);
-
-    return sz;
+    return value;
 }
 
-size_t json_serialize_array(KJSD_JSON_Array* value, json_accessor* out)
+static KJSD_JSON_Value* json_binary_value(json_binary_reader *r)
 {
-    size_t i;
-    size_t num = KJSD_JSON_arrayGetCount(value);
-    size_t sz = 0;
+    KJSD_JSON_Value *value;
+    uint64_t u;
+    double number;
+    char *string;
+    size_t n;
+    int i;
+
+    if (r->cur >= r->end) return NULL;
 
-    sz += json_serialize_vanilla("[", out);
-    for (i = 0; i < num; i++)
+    switch (*r->cur++)
     {
-        sz += json_serialize(KJSD_JSON_arrayGetValue(value, i), out);
-        if (i < (num - 1))
+    case BINARY_NULL:
+        return json_value_init_null(r->arena);
+    case BINARY_FALSE:
+        return json_value_init_bool(r->arena, 0);
+    case BINARY_TRUE:
+        return json_value_init_bool(r->arena, 1);
+    case BINARY_NUMBER:
+        if (r->end - r->cur < 8) return NULL;
+        for (u = 0, i = 7; i >= 0; i--) u = (u << 8) | r->cur[i];
+        r->cur += 8;
+        memcpy(&number, &u, sizeof(number));
+        return json_value_init_number(r->arena, number);
+    case BINARY_INTEGER:
+        if (json_binary_varint(r, &u) == ERROR) return NULL;
+        return json_value_init_integer(r->arena,
+                                       (int64_t)((u >> 1) ^ (0 - (u & 1))));
+    case BINARY_STRING:
+        string = json_binary_string(r, &n);
+        if (!string) return NULL;
+        value = json_value_init_string(r->arena, string);
+        if (!value) json_dealloc(r->arena, string);
+        return value;
+    case BINARY_ARRAY:
+        if (r->depth > MAX_NESTING) return NULL;
+        value = json_value_init_array(r->arena);
+        if (!value) return NULL;
+        r->depth++;
+        if (json_binary_array(r, value->value.array) == ERROR)
         {
-            sz += json_serialize_vanilla(",", out);
+            json_value_free(r->arena, value);
+            value = NULL;
         }
-    }
-    sz += json_serialize_vanilla("]", out);
-
-    return sz;
-}
-
-size_t json_serialize_string(const char* value, json_accessor* out)
-{
-    const char* escaped = json_escape_string(value);
-    const char* fmt = (escaped == NULL ? "null": "\"%s\"");
-    size_t sz = 0;
-
-    switch (out->sym)
-    {
-    case JSON_DEV_FILE:
-        sz = fprintf(out->obj.file, fmt, escaped);
-        break;
-    case JSON_DEV_MEM:
-        sz = snprintf(out->obj.str.buf, out->obj.str.size, fmt, escaped);
-        if (sz >= out->obj.str.size)
+        r->depth--;
+        return value;
+    case BINARY_OBJECT:
+        if (r->depth > MAX_NESTING) return NULL;
+        value = json_value_init_object(r->arena);
+        if (!value) return NULL;
+        r->depth++;
+        if (json_binary_object(r, value->value.object) == ERROR)
         {
-            sz = (out->obj.str.size > 0) ? out->obj.str.size - 1: 0;
+            json_value_free(r->arena, value);
+            value = NULL;
         }
-        out->obj.str.size -= sz;
-        out->obj.str.buf += sz;
-        break;
-    case JSON_DEV_NULL:
-        sz = snprintf(NULL, 0, fmt, escaped);
-        break;
+        r->depth--;
+        return value;
     default:
         break;
     }
-
-    json_free(escaped);
-    return sz;
+    return NULL;
 }
 
-size_t json_serialize_number(double value, json_accessor* out)
+static int json_binary_varint(json_binary_reader *r, uint64_t *value)
 {
-    const char* fmt = ((value - (int)value) == 0) ? "%.0f": "%f";
-    size_t sz = 0;
+    uint64_t result = 0;
+    unsigned int shift;
 
-    switch (out->sym)
+    for (shift = 0; (shift < 64) && (r->cur < r->end); shift += 7)
     {
-    case JSON_DEV_FILE:
-        sz = fprintf(out->obj.file, fmt, value);
-        break;
-    case JSON_DEV_MEM:
-        sz = snprintf(out->obj.str.buf, out->obj.str.size, fmt, value);
-        if (sz >= out->obj.str.size)
+        unsigned char c = *r->cur++;
+
+        /* Only one bit is left for the tenth byte */
+        if ((shift == 63) && (c > 1)) return ERROR;
+        result |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80))
         {
-            sz = (out->obj.str.size > 0) ? out->obj.str.size - 1: 0;
+            *value = result;
+            return SUCCESS;
         }
-        out->obj.str.size -= sz;
-        out->obj.str.buf += sz;
-        break;
-    case JSON_DEV_NULL:
-        sz = snprintf(NULL, 0, fmt, value);
-        break;
-    default:
-        break;
     }
-    return sz;
+    return ERROR;
 }
 
-size_t json_serialize_bool(int value, json_accessor* out)
+/* Every element takes at least one byte, so a count can not exceed
+   what is left. This keeps a corrupt count from preallocating. */
+static int json_binary_count(json_binary_reader *r, size_t *value)
 {
-    return json_serialize_vanilla((value ? "true": "false"), out);
+    uint64_t u;
+
+    if ((json_binary_varint(r, &u) == ERROR) ||
+        (u > (uint64_t)(r->end - r->cur))) return ERROR;
+
+    *value = (size_t)u;
+    return SUCCESS;
 }
 
-size_t json_serialize_vanilla(const char* value, json_accessor* out)
+static char* json_binary_string(json_binary_reader *r, size_t *length)
 {
-    size_t sz = 0;
+    char *string;
 
-    switch (out->sym)
-    {
-    case JSON_DEV_FILE:
-        sz = fprintf(out->obj.file, "%s", value);
-        break;
-    case JSON_DEV_MEM:
-        sz = snprintf(out->obj.str.buf, out->obj.str.size, "%s", value);
-        if (sz >= out->obj.str.size)
-        {
-            sz = (out->obj.str.size > 0) ? out->obj.str.size - 1: 0;
-        }
-        out->obj.str.size -= sz;
-        out->obj.str.buf += sz;
-        break;
-    case JSON_DEV_NULL:
-        sz = snprintf(NULL, 0, "%s", value);
-        break;
-    default:
-        break;
-    }
+    if (json_binary_count(r, length) == ERROR) return NULL;
+    /* Strings in the DOM are terminated by '\0' */
+    if (memchr(r->cur, '\0', *length) != NULL) return NULL;
 
-    return sz;
+    string = json_strndup(r->arena, (const char*)r->cur, *length);
+    if (string) r->cur += *length;
+    return string;
 }
 
-size_t json_strchg(const char* src,
-                   const char* old_str, const char* new_str,
-                   char* dst, size_t dst_sz)
+static int json_binary_array(json_binary_reader *r, KJSD_JSON_Array *array)
 {
-    const char* src_p = src;
-    char* dst_p = dst;
-    size_t cpy_sz = 0;
-    const size_t old_sz = strlen(old_str);
-    const size_t new_sz = strlen(new_str);
-    size_t sz;
     size_t count;
 
-    if ((src == NULL)
-        || (old_str == NULL)
-        || (new_str == NULL)
-        || (dst == NULL)
-        || (dst_sz == 0))
-    {
-        return 0;
-    }
+    if (json_binary_count(r, &count) == ERROR) return ERROR;
+    if ((ARRAY_MAX_CAPACITY > 0) && (count > ARRAY_MAX_CAPACITY))
+        return ERROR;
+    if ((count > 0) && (json_array_resize(array, count) == ERROR))
+        return ERROR;
 
-    for (count = 0; cpy_sz < dst_sz; count++)
+    while (array->count < count)
     {
-        char* p;
+        KJSD_JSON_Value *item = json_binary_value(r);
+        if (!item) return ERROR;
 
-        p = strstr(src_p, old_str);
-        if (p == NULL) break;
-            
-        sz = ((cpy_sz + (p - src_p)) < dst_sz) ?
-            p - src_p: dst_sz - cpy_sz - 1;
-        strncpy(dst_p, src_p, sz);
-        dst_p += sz;
-        cpy_sz += sz;
-
-        sz = ((cpy_sz + new_sz) < dst_sz) ? new_sz: dst_sz - cpy_sz - 1;
-        strncpy(dst_p, new_str, sz);
-
-        src_p = p + old_sz;
-        dst_p += sz;
-        cpy_sz += sz;
+        array->items[array->count++] = item;
     }
-    sz = ((cpy_sz + strlen(src_p)) < dst_sz) ?
-        strlen(src_p): dst_sz - cpy_sz - 1;
-    strncpy(dst_p, src_p, sz);
-    dst[cpy_sz + sz] = '\0';
-
-    return count;
+    return SUCCESS;
 }
 
-const char* json_escape_string(const char* src)
+static int json_binary_object(json_binary_reader *r, KJSD_JSON_Object *object)
 {
-    const char* p = src;
-    char* out = NULL;
-    char* buf = NULL;
-    size_t out_sz = 0;
+    size_t count, i, n;
 
-    if (src == NULL) return NULL;
-
-    out_sz = strlen(src) + 1;
-    for (p = strchr(src, '\\'); p != NULL; p = strchr(++p, '\\')) out_sz++;
-    for (p = strchr(src, '"'); p != NULL; p = strchr(++p, '"')) out_sz++;
-    for (p = strchr(src, '/'); p != NULL; p = strchr(++p, '/')) out_sz++;
+    if (json_binary_count(r, &count) == ERROR) return ERROR;
+    if ((OBJECT_MAX_CAPACITY > 0) && (count > OBJECT_MAX_CAPACITY))
+        return ERROR;
+    if ((count > 0) && (json_object_resize(object, count) == ERROR))
+        return ERROR;
 
-    out = (char*)json_malloc(out_sz);
-    if (out == NULL) return NULL;
-    buf = (char*)json_malloc(out_sz);
-    if (buf == NULL)
+    for (i = 0; i < count; i++)
     {
-        json_free(out);
-        return NULL;
+        KJSD_JSON_Value *value;
+        const char *name;
+
+        if ((json_binary_count(r, &n) == ERROR) ||
+            (memchr(r->cur, '\0', n) != NULL)) return ERROR;
+        name = json_intern_key(r->arena,
+                               json_intern_table(r->arena, &r->keys),
+                               (const char*)r->cur, n);
+        if (!name) return ERROR;
+        r->cur += n;
+
+        value = json_binary_value(r);
+        if (!value) return ERROR;
+        if (json_object_add_key(object, name, n, value) == ERROR)
+        {
+            json_value_free(r->arena, value);
+            return ERROR;
+        }
     }
-
-    json_strchg(src, "\\", "\\\\", buf, out_sz);
-    memcpy(out, buf, out_sz);
-    json_strchg(out, "\"", "\\\"", buf, out_sz);
-    memcpy(out, buf, out_sz);
-    json_strchg(out, "/", "\\/", buf, out_sz);
-    memcpy(out, buf, out_sz);
-
-    json_free(buf);
-    return out;
+    return SUCCESS;
 }
@@ -10,25 +10,183 @@
  * @see <related_items>
  ***********************************************************************/
 #include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <cstring>
+#include <cstdlib>
 #include <kjsd/cunit.h>
 #include <kjsd/cutil.h>
 #include <kjsd/json.h>
+#ifdef TEST_SPEED
+#include <kjsd/timer.hpp>
+#endif
 
 using namespace std;
 
 static KJSD_JSON_Value* root_;
+static KJSD_JSON_Arena* arena_;
+static KJSD_JSON_Parser* parser_;
+static KJSD_JSON_Path* path_;
+
+#ifdef TEST_SPEED
+/// パース/シリアライズ性能の計測用
+static kjsd::Timer t_;
+#endif
 
 static void setUp()
 {
     root_ = 0;
+    arena_ = 0;
+    parser_ = 0;
+    path_ = 0;
 }
 
 static void tearDown()
 {
     KJSD_JSON_free(root_);
+    KJSD_JSON_arenaDestroy(arena_);
+    KJSD_JSON_parserDestroy(parser_);
+    KJSD_JSON_pathDestroy(path_);
+    KJSD_JSON_setAllocator(0);
+}
+
+static string make_records(size_t num)
+{
+    ostringstream sstr;
+
+    sstr << "{\"records\":[";
+    for (size_t i = 0; i < num; i++)
+    {
+        if (i > 0) sstr << ",";
+        sstr << "{\"id\":" << i
+             << ",\"name\":\"record" << i << "\""
+             << ",\"value\":" << i << ".5"
+             << ",\"valid\":" << ((i % 2) ? "true": "false")
+             << ",\"tags\":[\"aaa\",\"bbb\",null]}";
+    }
+    sstr << "]}";
+    return sstr.str();
+}
+
+/// JSON文字列と同じ値か
+static bool equals_json(const KJSD_JSON_Value* value, const char* json)
+{
+    KJSD_JSON_Value* expected = KJSD_JSON_deserializeS(json);
+    bool result = (expected != 0) && KJSD_JSON_valueEquals(value, expected);
+
+    KJSD_JSON_free(expected);
+    return result;
+}
+
+/// JSON文字列のパッチを適用する
+static int apply_patch(KJSD_JSON_Value* target, const char* json,
+                       bool merge = false)
+{
+    KJSD_JSON_Value* patch = KJSD_JSON_deserializeS(json);
+    int result = 0;
+
+    if (patch)
+    {
+        result = merge ? KJSD_JSON_mergePatch(target, patch):
+            KJSD_JSON_patch(target, patch);
+    }
+    KJSD_JSON_free(patch);
+    return result;
+}
+
+/// 確保と解放の回数を数えるアロケータ
+struct AllocCounter
+{
+    size_t allocs;
+    size_t releases;
+};
+
+static void* count_alloc(void* ctx, size_t size)
+{
+    static_cast<AllocCounter*>(ctx)->allocs++;
+    return malloc(size);
+}
+
+static void* count_resize(void* ctx, void* ptr, size_t size)
+{
+    if (!ptr) static_cast<AllocCounter*>(ctx)->allocs++;
+    return realloc(ptr, size);
+}
+
+static void count_release(void* ctx, void* ptr)
+{
+    if (ptr) static_cast<AllocCounter*>(ctx)->releases++;
+    free(ptr);
+}
+
+/// イベントパーサのテスト用ハンドラ
+struct ParseCounter
+{
+    size_t nulls;
+    size_t bools;
+    size_t numbers;
+    size_t strings;
+    size_t keys;
+    size_t objects;
+    size_t arrays;
+    double last_number;
+    string last_string;
+    size_t abort_at;
+};
+
+static int count_null(void* ctx)
+{
+    static_cast<ParseCounter*>(ctx)->nulls++;
+    return 1;
 }
 
+static int count_bool(void* ctx, int)
+{
+    static_cast<ParseCounter*>(ctx)->bools++;
+    return 1;
+}
+
+static int count_number(void* ctx, double value)
+{
+    ParseCounter* c = static_cast<ParseCounter*>(ctx);
+    c->numbers++;
+    c->last_number = value;
+    return 1;
+}
+
+static int count_string(void* ctx, const char* value, size_t length)
+{
+    ParseCounter* c = static_cast<ParseCounter*>(ctx);
+    c->strings++;
+    c->last_string.assign(value, length);
+    return c->strings != c->abort_at;
+}
+
+static int count_key(void* ctx, const char*, size_t)
+{
+    static_cast<ParseCounter*>(ctx)->keys++;
+    return 1;
+}
+
+static int count_object(void* ctx)
+{
+    static_cast<ParseCounter*>(ctx)->objects++;
+    return 1;
+}
+
+static int count_array(void* ctx)
+{
+    static_cast<ParseCounter*>(ctx)->arrays++;
+    return 1;
+}
+
+static const KJSD_JSON_Handler counter_ = {
+    count_null, count_bool, count_number, count_string,
+    count_object, count_key, 0, count_array, 0
+};
+
 static const char* test_deserialize()
 {
     FILE* in;
@@ -39,6 +197,213 @@ static const char* test_deserialize()
     root_ = KJSD_JSON_deserialize(in);
     KJSD_CUNIT_ASSERT(root_ != 0);
     fclose(in);
+    KJSD_JSON_free(root_);
+
+    // 書き込んだ直後のストリームも先頭から読み込む
+    in = tmpfile();
+    KJSD_CUNIT_ASSERT(in != 0);
+    fputs("{\"a\":1}", in);
+    root_ = KJSD_JSON_deserialize(in);
+    fclose(in);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(
+                          KJSD_JSON_valueGetObject(root_), "a") == 1);
+    return 0;
+}
+
+static const char* test_deserializeFile()
+{
+    FILE* in;
+    KJSD_JSON_Value* value;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeFile(0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeFile("test/json/none.txt") == 0);
+
+    root_ = KJSD_JSON_deserializeFile("test/json/test_1_1.txt");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    in = fopen("test/json/test_1_1.txt", "r");
+    value = KJSD_JSON_deserialize(in);
+    fclose(in);
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(root_) == KJSD_JSON_sizeof(value));
+    KJSD_JSON_free(value);
+    return 0;
+}
+
+/// 並列パースと逐次パースの結果が同じか
+static bool same_as_sequential(const string& doc, size_t threads)
+{
+    KJSD_JSON_Value* expected = KJSD_JSON_deserializeS(doc.c_str());
+    KJSD_JSON_Value* actual = KJSD_JSON_deserializeSParallel(doc.c_str(),
+                                                             threads);
+    char* e = expected ? KJSD_JSON_serializeAlloc(expected, 0): 0;
+    char* a = actual ? KJSD_JSON_serializeAlloc(actual, 0): 0;
+    bool same = (!e && !a) || (e && a && (strcmp(e, a) == 0));
+
+    KJSD_JSON_freeString(e);
+    KJSD_JSON_freeString(a);
+    KJSD_JSON_free(expected);
+    KJSD_JSON_free(actual);
+    return same;
+}
+
+static const char* test_deserializeSParallel()
+{
+    ostringstream sstr;
+    string doc;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeSParallel(0, 4) == 0);
+    KJSD_CUNIT_ASSERT(same_as_sequential("[1,2,3]", 4));
+    KJSD_CUNIT_ASSERT(same_as_sequential("{\"a\":[1,2]}", 4));
+
+    // 区切り文字を含む文字列、入れ子、スカラー要素
+    sstr << "[";
+    for (int i = 0; i < 30000; i++)
+    {
+        sstr << "{\"id\":" << i << ",\"s\":\"a,]\\\"[\\\\\","
+             << "\"n\":[[" << i << "],{\"x\":\"}\"}]},"
+             << i << ".25,\"" << i << "\",null,";
+    }
+    sstr << "true]";
+    doc = sstr.str();
+    KJSD_CUNIT_ASSERT(doc.size() > 1024 * 1024);
+    for (size_t threads = 0; threads <= 8; threads++)
+    {
+        KJSD_CUNIT_ASSERT(same_as_sequential(doc, threads));
+    }
+    KJSD_CUNIT_ASSERT(same_as_sequential(doc + " \n", 4));
+
+    // 不正なドキュメントはどの区間に誤りがあっても失敗する
+    KJSD_CUNIT_ASSERT(same_as_sequential(doc.substr(0, doc.size() - 5) +
+                                         "]", 4));
+    KJSD_CUNIT_ASSERT(same_as_sequential(doc.substr(0, doc.size() - 5) +
+                                         ",]", 4));
+    KJSD_CUNIT_ASSERT(same_as_sequential(doc.substr(0, doc.size() - 1), 4));
+    KJSD_CUNIT_ASSERT(same_as_sequential(doc + "]", 4));
+    KJSD_CUNIT_ASSERT(same_as_sequential(doc + " x", 4));
+    KJSD_CUNIT_ASSERT(same_as_sequential("[," + doc.substr(1), 4));
+    for (size_t pos = doc.size() / 8; pos < doc.size();
+         pos += doc.size() / 8)
+    {
+        size_t comma = doc.find("null,", pos) + 4;
+        KJSD_CUNIT_ASSERT(same_as_sequential(doc.substr(0, comma) + "," +
+                                             doc.substr(comma), 4));
+        KJSD_CUNIT_ASSERT(same_as_sequential(doc.substr(0, comma) + "]" +
+                                             doc.substr(comma), 4));
+        KJSD_CUNIT_ASSERT(same_as_sequential(doc.substr(0, comma) + "\"" +
+                                             doc.substr(comma), 4));
+    }
+    return 0;
+}
+
+/// NDJSONのテスト用: レコードのidまたは不正を表す-1を記録する
+struct RecordSink
+{
+    vector<int64_t> ids;
+    size_t abort_at;
+};
+
+static int collect_record(void* ctx, size_t index, KJSD_JSON_Value* value)
+{
+    RecordSink* sink = static_cast<RecordSink*>(ctx);
+
+    if (index != sink->ids.size()) return 0;
+    sink->ids.push_back(value ?
+                        KJSD_JSON_objectGetInteger(
+                            KJSD_JSON_valueGetObject(value), "id"): -1);
+    return sink->ids.size() != sink->abort_at;
+}
+
+static string make_lines(size_t num)
+{
+    ostringstream sstr;
+
+    for (size_t i = 0; i < num; i++)
+    {
+        sstr << "{\"id\":" << i << ",\"name\":\"record" << i << "\""
+             << ",\"tags\":[\"aaa\",\"bbb\",null]}\n";
+    }
+    return sstr.str();
+}
+
+static const char* test_deserializeLines()
+{
+    static const char doc[] =
+        "{\"id\":1}\n"
+        "\n"
+        "  {\"id\":2} \r\n"
+        "{\"id\":3}}\n"
+        "[1,2\n"
+        "3\n"
+        "{\"id\":4}";
+    RecordSink sink = RecordSink();
+    string lines;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(0, 0, 1,
+                                                 collect_record, &sink) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(doc, sizeof(doc) - 1, 1,
+                                                 0, &sink) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(doc, 0, 1,
+                                                 collect_record, &sink) == 1);
+    KJSD_CUNIT_ASSERT(sink.ids.empty());
+
+    // 空行を除いて1行1レコード、不正なレコードはNULL
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(doc, sizeof(doc) - 1, 1,
+                                                 collect_record, &sink) == 1);
+    KJSD_CUNIT_ASSERT(sink.ids.size() == 6);
+    KJSD_CUNIT_ASSERT((sink.ids[0] == 1) && (sink.ids[1] == 2) &&
+                      (sink.ids[2] == -1) && (sink.ids[3] == -1) &&
+                      (sink.ids[4] == -1) && (sink.ids[5] == 4));
+
+    // 複数のバッチをワーカスレッドでパースしても順序を保つ
+    lines = make_lines(50000);
+    for (size_t threads = 0; threads <= 4; threads++)
+    {
+        sink = RecordSink();
+        KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(
+                              lines.data(), lines.size(), threads,
+                              collect_record, &sink) == 1);
+        KJSD_CUNIT_ASSERT(sink.ids.size() == 50000);
+        for (size_t i = 0; i < sink.ids.size(); i++)
+        {
+            KJSD_CUNIT_ASSERT(sink.ids[i] == (int64_t)i);
+        }
+    }
+
+    // funcによる中断
+    sink = RecordSink();
+    sink.abort_at = 30000;
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(
+                          lines.data(), lines.size(), 4,
+                          collect_record, &sink) == 0);
+    KJSD_CUNIT_ASSERT(sink.ids.size() == 30000);
+    return 0;
+}
+
+static const char* test_deserializeLinesFile()
+{
+    static const char* const path = "test_deserializeLinesFile.json";
+    RecordSink sink = RecordSink();
+    string lines = make_lines(1000);
+    FILE* out;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLinesFile(
+                          0, 0, collect_record, &sink) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLinesFile(
+                          "test/json/none.txt", 0,
+                          collect_record, &sink) == 0);
+
+    out = fopen(path, "wb");
+    KJSD_CUNIT_ASSERT(out != 0);
+    fwrite(lines.data(), 1, lines.size(), out);
+    fclose(out);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLinesFile(
+                          path, 2, collect_record, &sink) == 1);
+    remove(path);
+    KJSD_CUNIT_ASSERT(sink.ids.size() == 1000);
+    KJSD_CUNIT_ASSERT(sink.ids[999] == 999);
     return 0;
 }
 
@@ -48,6 +413,326 @@ static const char* test_deserializeS()
 
     root_ = KJSD_JSON_deserializeS("{ \"aaa\": \"bbb\" }");
     KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_JSON_free(root_);
+
+    // 対になっていないサロゲートは順序を保ってそのまま符号化する
+    root_ = KJSD_JSON_deserializeS("[\"\\ud800\",\"\\ud800x\\udc00\"]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_JSON_Array* a = KJSD_JSON_valueGetArray(root_);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(a, 0),
+                             "\xed\xa0\x80") == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(a, 1),
+                             "\xed\xa0\x80x\xed\xb0\x80") == 0);
+
+    // メンバ名称の'\0'は受け付けない
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeS(
+                          "{\"a\\u0000b\":1,\"a\\u0000c\":2}") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeS("[{\"\\u0000\":1}]") == 0);
+    return 0;
+}
+
+static const char* test_parse()
+{
+    static const size_t NUM_OF_RECORD = 2000;
+    ParseCounter c = ParseCounter();
+    FILE* in;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parse(0, &counter_, &c) == 0);
+
+    // 読み込み単位を跨ぐ長さのデータ
+    in = tmpfile();
+    KJSD_CUNIT_ASSERT(in != 0);
+    fputs(make_records(NUM_OF_RECORD).c_str(), in);
+    rewind(in);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parse(in, 0, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parse(in, &counter_, &c) == 1);
+    fclose(in);
+
+    KJSD_CUNIT_ASSERT(c.objects == NUM_OF_RECORD + 1);
+    KJSD_CUNIT_ASSERT(c.arrays == NUM_OF_RECORD + 1);
+    KJSD_CUNIT_ASSERT(c.keys == NUM_OF_RECORD * 5 + 1);
+    KJSD_CUNIT_ASSERT(c.numbers == NUM_OF_RECORD * 2);
+    KJSD_CUNIT_ASSERT(c.strings == NUM_OF_RECORD * 3);
+    KJSD_CUNIT_ASSERT(c.bools == NUM_OF_RECORD);
+    KJSD_CUNIT_ASSERT(c.nulls == NUM_OF_RECORD);
+    KJSD_CUNIT_ASSERT(c.last_number == NUM_OF_RECORD - 0.5);
+    return 0;
+}
+
+static const char* test_parseS()
+{
+    ParseCounter c = ParseCounter();
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS(0, &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("[]", 0, &c) == 0);
+
+    // ルートがオブジェクト、配列以外
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS(" -1.25e2 ", &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_number == -125);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("0", &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_number == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("null", &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.nulls == 1);
+
+    // エスケープ
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS(
+                          "\"a\\\"\\/\\n\\u3042\\ud83d\\ude00\"",
+                          &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_string == "a\"/\n\xe3\x81\x82\xf0\x9f\x98\x80");
+
+    // 対になっていないサロゲートはそのまま符号化する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("\"\\ud800\"", &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_string == "\xed\xa0\x80");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("\"\\udc00\"", &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_string == "\xed\xb0\x80");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("\"\\ud800x\\udc00\"",
+                                       &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_string == "\xed\xa0\x80x\xed\xb0\x80");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("\"\\ud800\\u0041\"",
+                                       &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.last_string == "\xed\xa0\x80" "A");
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS(
+                          "{ \"a\": [1, true, false, null, {}], \"b\": \"c\" }",
+                          &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(c.objects == 2);
+    KJSD_CUNIT_ASSERT(c.arrays == 1);
+    KJSD_CUNIT_ASSERT(c.keys == 2);
+    KJSD_CUNIT_ASSERT(c.bools == 2);
+
+    // 不正なJSON
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("[1,]", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("[1}", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("{\"a\" 1}", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("[01]", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("-", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("1.", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("tru", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("\"a\tb\"", &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("\"\\x\"", &counter_, &c) == 0);
+    // 入れ子は20段まで
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS(
+                          "[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]]",
+                          &counter_, &c) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS(
+                          "[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]",
+                          &counter_, &c) == 0);
+
+    // ハンドラによる中断
+    c = ParseCounter();
+    c.abort_at = 2;
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parseS("[\"a\", \"b\", \"c\"]",
+                                       &counter_, &c) == 0);
+    KJSD_CUNIT_ASSERT(c.strings == 2);
+    return 0;
+}
+
+/// 構造体への読み込みのテスト用
+struct BindPoint
+{
+    int x;
+    int16_t y;
+};
+
+struct BindRecord
+{
+    int64_t id;
+    char name[8];
+    double value;
+    float ratio;
+    bool valid;
+    BindPoint point;
+};
+
+static const KJSD_JSON_Field bind_point_[] = {
+    KJSD_JSON_FIELD(BindPoint, x, KJSD_JSON_FIELD_INTEGER),
+    KJSD_JSON_FIELD(BindPoint, y, KJSD_JSON_FIELD_INTEGER),
+    KJSD_JSON_FIELD_END
+};
+
+static const KJSD_JSON_Field bind_record_[] = {
+    KJSD_JSON_FIELD(BindRecord, id, KJSD_JSON_FIELD_INTEGER),
+    KJSD_JSON_FIELD(BindRecord, name, KJSD_JSON_FIELD_STRING),
+    KJSD_JSON_FIELD(BindRecord, value, KJSD_JSON_FIELD_NUMBER),
+    KJSD_JSON_FIELD(BindRecord, ratio, KJSD_JSON_FIELD_NUMBER),
+    KJSD_JSON_FIELD(BindRecord, valid, KJSD_JSON_FIELD_BOOL),
+    KJSD_JSON_FIELD_OBJECT_OF(BindRecord, point, bind_point_),
+    KJSD_JSON_FIELD_END
+};
+
+static const char* test_bindS()
+{
+    BindRecord r = BindRecord();
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS(0, bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{}", 0, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{}", bind_record_, 0) == 0);
+
+    // 記述子と異なる順序、記述子に無いメンバ
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS(
+                          "{\"point\":{\"y\":-2,\"z\":[1,{\"a\":\"]}\"}],"
+                          "\"x\":1},\"tags\":[\"a\\\"]\",{},[[]]],"
+                          "\"name\":\"abc\","
+                          "\"extra\":{\"id\":5},\"id\":12345678901234,"
+                          "\"n\":-1.5e3,\"value\":2.5,\"ratio\":1,"
+                          "\"valid\":true,\"b\":false,\"s\":\"x\"}",
+                          bind_record_, &r) == 1);
+    KJSD_CUNIT_ASSERT(r.id == 12345678901234LL);
+    KJSD_CUNIT_ASSERT(strcmp(r.name, "abc") == 0);
+    KJSD_CUNIT_ASSERT(r.value == 2.5);
+    KJSD_CUNIT_ASSERT(r.ratio == 1.0f);
+    KJSD_CUNIT_ASSERT(r.valid);
+    KJSD_CUNIT_ASSERT((r.point.x == 1) && (r.point.y == -2));
+
+    // nullと存在しないメンバは変更しない
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"id\":null,\"value\":0}",
+                                      bind_record_, &r) == 1);
+    KJSD_CUNIT_ASSERT((r.id == 12345678901234LL) && (r.value == 0));
+    KJSD_CUNIT_ASSERT(strcmp(r.name, "abc") == 0);
+
+    // '\0'を含むメンバ名称は前方が一致しても対応付けない
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"id\\u0000x\":1,\"value\\u0000\":1}",
+                                      bind_record_, &r) == 1);
+    KJSD_CUNIT_ASSERT((r.id == 12345678901234LL) && (r.value == 0));
+
+    // 型の不一致
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"id\":\"1\"}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"id\":1.5}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"point\":{\"y\":32768}}",
+                                      bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"name\":\"abcdefgh\"}",
+                                      bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"point\":[]}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"valid\":1}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("[]", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("null", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("1", bind_record_, &r) == 0);
+
+    // 不正なJSON(読み飛ばすメンバを含む)
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"a\":}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"a\":[}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"a\":\"\t\"}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"a\":[\\]}", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"a\":1", bind_record_, &r) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bindS("{\"a\":1 \"id\":1}",
+                                      bind_record_, &r) == 0);
+    return 0;
+}
+
+static const char* test_bind()
+{
+    BindRecord r = BindRecord();
+    FILE* in;
+    string doc;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bind(0, bind_record_, &r) == 0);
+
+    // 読み飛ばすメンバが読み込み単位をまたぐ
+    doc = " {\"skip\":{\"a\":[\"";
+    doc += string(100000, 'x');
+    doc += "\\\"\"]},\"long\":\"" + string(70000, 'y') + "\",";
+    doc += "\"num\":" + string(70000, '1') + ",\"id\":7}";
+
+    in = tmpfile();
+    KJSD_CUNIT_ASSERT(in != 0);
+    fwrite(doc.data(), 1, doc.size(), in);
+    rewind(in);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_bind(in, bind_record_, &r) == 1);
+    fclose(in);
+    KJSD_CUNIT_ASSERT(r.id == 7);
+    return 0;
+}
+
+static const char* test_parserFeed()
+{
+    string json_str = make_records(50);
+    const char* docs = "{\"a\":1}[2] 3 ";
+    size_t consumed = 0;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(0, "[]", 2, 0)
+                      == KJSD_JSON_PARSE_ERROR);
+
+    parser_ = KJSD_JSON_parserCreate(0);
+    KJSD_CUNIT_ASSERT(parser_ != 0);
+
+    // 1バイトずつ入力
+    for (size_t i = 0; i < json_str.size() - 1; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, &json_str[i], 1, 0)
+                          == KJSD_JSON_PARSE_CONTINUE);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_parserTakeRoot(parser_) == 0);
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(
+                          parser_, &json_str[json_str.size() - 1], 1, 0)
+                      == KJSD_JSON_PARSE_DONE);
+    root_ = KJSD_JSON_parserTakeRoot(parser_);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_objectGetArray(
+                              KJSD_JSON_valueGetObject(root_), "records"))
+                      == 50);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserGetStatus(parser_)
+                      == KJSD_JSON_PARSE_CONTINUE);
+
+    // 連続したドキュメント
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, docs, strlen(docs),
+                                           &consumed)
+                      == KJSD_JSON_PARSE_DONE);
+    KJSD_CUNIT_ASSERT(consumed == 7);
+    KJSD_JSON_free(KJSD_JSON_parserTakeRoot(parser_));
+    docs += consumed;
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, docs, strlen(docs),
+                                           &consumed)
+                      == KJSD_JSON_PARSE_DONE);
+    KJSD_CUNIT_ASSERT(consumed == 3);
+    KJSD_JSON_free(KJSD_JSON_parserTakeRoot(parser_));
+    docs += consumed;
+
+    // 区切りのない数値は入力終了で完了する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, docs, 2, &consumed)
+                      == KJSD_JSON_PARSE_CONTINUE);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFinish(parser_)
+                      == KJSD_JSON_PARSE_DONE);
+    KJSD_JSON_free(KJSD_JSON_parserTakeRoot(parser_));
+
+    // 失敗後はリセットで再利用できる
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "[1,", 3, 0)
+                      == KJSD_JSON_PARSE_CONTINUE);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFinish(parser_)
+                      == KJSD_JSON_PARSE_ERROR);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "]", 1, 0)
+                      == KJSD_JSON_PARSE_ERROR);
+    KJSD_JSON_parserReset(parser_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "[1,", 3, 0)
+                      == KJSD_JSON_PARSE_CONTINUE);
+    KJSD_JSON_parserReset(parser_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "[\"\\u30", 6, 0)
+                      == KJSD_JSON_PARSE_CONTINUE);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "42\"]", 4, 0)
+                      == KJSD_JSON_PARSE_DONE);
+    KJSD_JSON_free(root_);
+    root_ = KJSD_JSON_parserTakeRoot(parser_);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(
+                                 KJSD_JSON_valueGetArray(root_), 0),
+                             "\xe3\x81\x82") == 0);
+    KJSD_JSON_parserDestroy(parser_);
+    parser_ = 0;
+
+    // イベントパーサ
+    ParseCounter c = ParseCounter();
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserCreateEvent(0, &c) == 0);
+    parser_ = KJSD_JSON_parserCreateEvent(&counter_, &c);
+    KJSD_CUNIT_ASSERT(parser_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "[tr", 3, 0)
+                      == KJSD_JSON_PARSE_CONTINUE);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "ue, nu", 6, 0)
+                      == KJSD_JSON_PARSE_CONTINUE);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_parserFeed(parser_, "ll]", 3, 0)
+                      == KJSD_JSON_PARSE_DONE);
+    KJSD_CUNIT_ASSERT(c.bools == 1);
+    KJSD_CUNIT_ASSERT(c.nulls == 1);
+    KJSD_JSON_parserDestroy(0);
     return 0;
 }
 
@@ -110,6 +795,43 @@ static const char* test_objectGetValue()
     return 0;
 }
 
+static const char* test_objectGetValueIndexed()
+{
+    static const int NUM_OF_MEMBER = 2000;
+    KJSD_JSON_Object* obj = 0;
+    ostringstream sstr;
+
+    sstr << "{";
+    for (int i = 0; i < NUM_OF_MEMBER; i++)
+    {
+        if (i > 0) sstr << ",";
+        sstr << "\"key" << i << "\":" << i;
+    }
+    sstr << "}";
+
+    root_ = KJSD_JSON_deserializeS(sstr.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    obj = KJSD_JSON_valueGetObject(root_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetCount(obj) == NUM_OF_MEMBER);
+
+    for (int i = 0; i < NUM_OF_MEMBER; i++)
+    {
+        sstr.str("");
+        sstr << "key" << i;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetNumber(
+                              obj, sstr.str().c_str()) == i);
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetValue(obj, "key") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetValue(obj, "key10000") == 0);
+
+    // 重複したメンバは追加できない
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddNumber(obj, "key1999", 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddNumber(obj, "new", 0) > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetValue(obj, "new") != 0);
+    return 0;
+}
+
 static const char* test_objectGetObject()
 {
     KJSD_JSON_Object* obj = 0;
@@ -183,6 +905,26 @@ static const char* test_objectGetNumber()
     return 0;
 }
 
+static const char* test_objectGetInteger()
+{
+    KJSD_JSON_Object* obj = 0;
+
+    root_ = KJSD_JSON_deserializeS("{ \"aaa\": 9007199254740993,"
+                                   "  \"bbb\": -1.9 }");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "zzz") == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "aaa")
+                      == 9007199254740993LL);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "bbb") == -1);
+    return 0;
+}
+
 static const char* test_objectGetBool()
 {
     KJSD_JSON_Object* obj = 0;
@@ -294,6 +1036,25 @@ static const char* test_objectDotGetNumber()
     return 0;
 }
 
+static const char* test_objectDotGetInteger()
+{
+    KJSD_JSON_Object* obj = 0;
+
+    root_ = KJSD_JSON_deserializeS("{ \"aaa\":{ \"bbb\":"
+                                   "  { \"ccc\": -9223372036854775808 }}}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetInteger(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetInteger(obj, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetInteger(obj, "zzz") == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetInteger(obj, "aaa.bbb.ccc")
+                      == INT64_MIN);
+    return 0;
+}
+
 static const char* test_objectDotGetBool()
 {
     KJSD_JSON_Object* obj = 0;
@@ -314,6 +1075,137 @@ static const char* test_objectDotGetBool()
     return 0;
 }
 
+static const char* test_pathCompile()
+{
+    static const char* const valid[] = {
+        "aaa", "aaa.bbb", "aaa[0]", "aaa[12][3].bbb", "[0]", "[*].aaa",
+        "*", "aaa.*.bbb", "aaa[*]"
+    };
+    static const char* const invalid[] = {
+        "", ".", "aaa.", ".aaa", "aaa..bbb", "aaa[", "aaa[]", "aaa[x]",
+        "aaa[0", "aaa[0]bbb", "aaa.[0]", "aaa[-1]",
+        "aaa[99999999999999999999999]"
+    };
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathCompile(0) == 0);
+    for (size_t i = 0; i < KJSD_LENGTH(valid); i++)
+    {
+        path_ = KJSD_JSON_pathCompile(valid[i]);
+        KJSD_CUNIT_ASSERT(path_ != 0);
+        KJSD_JSON_pathDestroy(path_);
+        path_ = 0;
+    }
+    for (size_t i = 0; i < KJSD_LENGTH(invalid); i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_pathCompile(invalid[i]) == 0);
+    }
+    KJSD_JSON_pathDestroy(0);
+    return 0;
+}
+
+static const char* test_pathGetValue()
+{
+    KJSD_JSON_Value* other = 0;
+
+    root_ = KJSD_JSON_deserializeS(
+        "{\"aaa\":{\"bbb\":[10,{\"ccc\":\"x\"}]},\"ddd\":true}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    path_ = KJSD_JSON_pathCompile("aaa.bbb[1].ccc");
+    KJSD_CUNIT_ASSERT(path_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathGetValue(0, root_) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathGetValue(path_, 0) == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_valueGetString(
+                                 KJSD_JSON_pathGetValue(path_, root_)),
+                             "x") == 0);
+    // 2回目はキャッシュした位置から照合する
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_valueGetString(
+                                 KJSD_JSON_pathGetValue(path_, root_)),
+                             "x") == 0);
+
+    // メンバの順序が異なるドキュメント
+    other = KJSD_JSON_deserializeS(
+        "{\"ddd\":1,\"aaa\":{\"zzz\":0,\"bbb\":[0,{\"ccc\":\"y\"}]}}");
+    KJSD_CUNIT_ASSERT(other != 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_valueGetString(
+                                 KJSD_JSON_pathGetValue(path_, other)),
+                             "y") == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_valueGetString(
+                                 KJSD_JSON_pathGetValue(path_, root_)),
+                             "x") == 0);
+    KJSD_JSON_free(other);
+
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("aaa.bbb[2]");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathGetValue(path_, root_) == 0);
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("ddd.eee");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathGetValue(path_, root_) == 0);
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("[0]");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathGetValue(path_, root_) == 0);
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("*.bbb[0]");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetInteger(
+                          KJSD_JSON_pathGetValue(path_, root_)) == 10);
+
+    // 遅延構築のドキュメント
+    arena_ = KJSD_JSON_arenaCreate(0);
+    other = KJSD_JSON_arenaDeserializeLazy(
+        arena_, "[{\"aaa\":[1,2]},{\"aaa\":[3,4]}]");
+    KJSD_CUNIT_ASSERT(other != 0);
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("[1].aaa[0]");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetInteger(
+                          KJSD_JSON_pathGetValue(path_, other)) == 3);
+    return 0;
+}
+
+static int collect_integer(void* ctx, KJSD_JSON_Value* value)
+{
+    vector<int64_t>* v = static_cast<vector<int64_t>*>(ctx);
+    v->push_back(KJSD_JSON_valueGetInteger(value));
+    return v->size() < 3;
+}
+
+static const char* test_pathForEach()
+{
+    vector<int64_t> v;
+
+    root_ = KJSD_JSON_deserializeS(
+        "{\"records\":[{\"id\":1,\"tags\":[1,2]},{\"name\":\"x\"},"
+        "{\"id\":3,\"tags\":[]}],\"other\":{\"a\":{\"id\":4},"
+        "\"b\":{\"id\":5}}}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    path_ = KJSD_JSON_pathCompile("records[*].id");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathForEach(0, root_,
+                                            collect_integer, &v) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathForEach(path_, root_, 0, &v) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathForEach(path_, root_,
+                                            collect_integer, &v) == 2);
+    KJSD_CUNIT_ASSERT((v.size() == 2) && (v[0] == 1) && (v[1] == 3));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetInteger(
+                          KJSD_JSON_pathGetValue(path_, root_)) == 1);
+
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("other.*.id");
+    v.clear();
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathForEach(path_, root_,
+                                            collect_integer, &v) == 2);
+    KJSD_CUNIT_ASSERT((v.size() == 2) && (v[0] == 4) && (v[1] == 5));
+
+    // collect_integerは3件目で中断する
+    KJSD_JSON_pathDestroy(path_);
+    path_ = KJSD_JSON_pathCompile("*[*].*[*]");
+    v.clear();
+    v.push_back(0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_pathForEach(path_, root_,
+                                            collect_integer, &v) == 2);
+    KJSD_CUNIT_ASSERT((v.size() == 3) && (v[1] == 1) && (v[2] == 2));
+    return 0;
+}
+
 static const char* test_objectGetCount()
 {
     KJSD_JSON_Object* obj = 0;
@@ -352,6 +1244,42 @@ static const char* test_objectGetName()
     name = KJSD_JSON_objectGetName(obj, 1);
     KJSD_CUNIT_ASSERT(name != 0);
     KJSD_CUNIT_ASSERT(strcmp(name, "bbb") == 0);
+    KJSD_JSON_free(root_);
+
+    // 同じメンバ名称はドキュメント内で共有される
+    root_ = KJSD_JSON_deserializeS("[{ \"id\": 1, \"v\": { \"id\": 2 } },"
+                                   " { \"v\": 3, \"id\": 4 }]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_JSON_Array* array = KJSD_JSON_valueGetArray(root_);
+    KJSD_JSON_Object* obj0 = KJSD_JSON_arrayGetObject(array, 0);
+    KJSD_JSON_Object* obj1 = KJSD_JSON_arrayGetObject(array, 1);
+    name = KJSD_JSON_objectGetName(obj0, 0);
+    KJSD_CUNIT_ASSERT(name == KJSD_JSON_objectGetName(obj1, 1));
+    KJSD_CUNIT_ASSERT(name == KJSD_JSON_objectGetName(
+                          KJSD_JSON_objectGetObject(obj0, "v"), 0));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetName(obj0, 1) ==
+                      KJSD_JSON_objectGetName(obj1, 0));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddInteger(obj1, "id", 5) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddInteger(obj1, "w", 5) != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj1, "w") == 5);
+
+    // 重複したメンバ名称はパース失敗
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeS("{ \"a\": 1, \"a\": 2 }") == 0);
+
+    // アリーナ内ではドキュメントをまたいで共有される
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    KJSD_JSON_Value* doc0 = KJSD_JSON_arenaDeserializeS(arena_,
+                                                        "{ \"key\": 1 }");
+    KJSD_JSON_Value* doc1 = KJSD_JSON_arenaDeserializeS(arena_,
+                                                        "{ \"key\": 2 }");
+    KJSD_CUNIT_ASSERT((doc0 != 0) && (doc1 != 0));
+    KJSD_CUNIT_ASSERT(
+        KJSD_JSON_objectGetName(KJSD_JSON_valueGetObject(doc0), 0) ==
+        KJSD_JSON_objectGetName(KJSD_JSON_valueGetObject(doc1), 0));
+    KJSD_CUNIT_ASSERT(
+        KJSD_JSON_arenaDeserializeS(arena_, "{ \"key\": 1, \"key\": 2 }")
+        == 0);
     return 0;
 }
 
@@ -368,6 +1296,62 @@ static const char* test_arrayGetValue()
     KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetValue(ary, 255) == 0);
 
     KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetValue(ary, 0) != 0);
+    KJSD_JSON_free(root_);
+
+    // 要素の追加後も取得済みの値は有効
+    root_ = KJSD_JSON_deserializeS("[ 1, \"a\", [ null, 2.5, false ],"
+                                   "  { \"k\": \"b\", \"o\": {} }, 3 ]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    ary = KJSD_JSON_valueGetArray(root_);
+    KJSD_JSON_Value* first = KJSD_JSON_arrayGetValue(ary, 0);
+    for (int i = 0; i < 100; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddInteger(ary, i) > 0);
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetValue(ary, 0) == first);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetInteger(first) == 1);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(ary, 1), "a") == 0);
+    KJSD_JSON_Array* inner = KJSD_JSON_arrayGetArray(ary, 2);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetType(
+                          KJSD_JSON_arrayGetValue(inner, 0))
+                      == KJSD_JSON_NULL);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetNumber(inner, 1) == 2.5);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetBool(inner, 2) == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetString(
+                                 KJSD_JSON_arrayGetObject(ary, 3), "k"),
+                             "b") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 4) == 3);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 104) == 99);
+
+    // 途中で失敗したパースは構築途中の値を残さない
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeS(
+                          "[ \"a\", [ \"b\", { \"c\": \"d\", ] ]") == 0);
+    return 0;
+}
+
+static const char* test_arrayGetValueLarge()
+{
+    static const size_t NUM_OF_ITEM = 200000;
+    KJSD_JSON_Array* ary = 0;
+    ostringstream sstr;
+
+    sstr << "[";
+    for (size_t i = 0; i < NUM_OF_ITEM; i++)
+    {
+        if (i > 0) sstr << ",";
+        sstr << i;
+    }
+    sstr << "]";
+
+    root_ = KJSD_JSON_deserializeS(sstr.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    ary = KJSD_JSON_valueGetArray(root_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(ary) == NUM_OF_ITEM);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetNumber(ary, NUM_OF_ITEM - 1)
+                      == NUM_OF_ITEM - 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddBool(ary, 1) > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetBool(ary, NUM_OF_ITEM) == 1);
     return 0;
 }
 
@@ -438,6 +1422,23 @@ static const char* test_arrayGetNumber()
     return 0;
 }
 
+static const char* test_arrayGetInteger()
+{
+    KJSD_JSON_Array* ary = 0;
+
+    root_ = KJSD_JSON_deserializeS("[ {}, [], \"str\", 1, true ]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    ary = KJSD_JSON_valueGetArray(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 255) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 2) == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 3) == 1);
+    return 0;
+}
+
 static const char* test_arrayGetBool()
 {
     KJSD_JSON_Array* ary = 0;
@@ -518,18 +1519,49 @@ static const char* test_valueGetNumber()
     return 0;
 }
 
-static const char* test_valueGetBool()
+static const char* test_valueGetInteger()
 {
-    KJSD_JSON_Object* obj = 0;
-    KJSD_JSON_Value* val = 0;
+    KJSD_JSON_Array* ary = 0;
 
-    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetBool(0) < 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetInteger(0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueIsInteger(0) == 0);
 
-    root_ = KJSD_JSON_deserializeS("{ \"aaa\": true,"
-                                   "  \"bbb\": false }");
+    root_ = KJSD_JSON_deserializeS("[ 9223372036854775807, 1.0, 1e2,"
+                                   "  9223372036854775808, -0, 1e300 ]");
     KJSD_CUNIT_ASSERT(root_ != 0);
 
-    obj = KJSD_JSON_valueGetObject(root_);
+    ary = KJSD_JSON_valueGetArray(root_);
+
+    // 小数点、指数を含まずint64_tに収まる数値だけを整数として保持する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueIsInteger(
+                          KJSD_JSON_arrayGetValue(ary, 0)) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 0) == INT64_MAX);
+    for (size_t i = 1; i < 6; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_valueIsInteger(
+                              KJSD_JSON_arrayGetValue(ary, i)) == 0);
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 1) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 2) == 100);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetNumber(ary, 3)
+                      == 9223372036854775808.0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 3) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 5) == 0);
+    return 0;
+}
+
+static const char* test_valueGetBool()
+{
+    KJSD_JSON_Object* obj = 0;
+    KJSD_JSON_Value* val = 0;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetBool(0) < 0);
+
+    root_ = KJSD_JSON_deserializeS("{ \"aaa\": true,"
+                                   "  \"bbb\": false }");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    obj = KJSD_JSON_valueGetObject(root_);
 
     val = KJSD_JSON_objectGetValue(obj, "aaa");
     KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetBool(val) == 1);
@@ -539,6 +1571,51 @@ static const char* test_valueGetBool()
     return 0;
 }
 
+static const char* test_valueEquals()
+{
+    ostringstream a;
+    ostringstream b;
+    KJSD_JSON_Value* other = 0;
+
+    root_ = KJSD_JSON_deserializeS("{\"a\":1,\"b\":[1,2.0,\"x\",null,true]}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(root_, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(root_, root_) == 1);
+
+    KJSD_CUNIT_ASSERT(equals_json(root_,
+                                  "{\"b\":[1.0,2,\"x\",null,true],\"a\":1}"));
+    KJSD_CUNIT_ASSERT(!equals_json(root_,
+                                   "{\"b\":[2,1,\"x\",null,true],\"a\":1}"));
+    KJSD_CUNIT_ASSERT(!equals_json(root_, "{\"a\":1}"));
+    KJSD_CUNIT_ASSERT(!equals_json(root_,
+                                   "{\"a\":1,\"b\":[1,2,\"x\",null,true],"
+                                   "\"c\":0}"));
+    KJSD_CUNIT_ASSERT(!equals_json(root_, "[]"));
+    KJSD_JSON_free(root_);
+
+    // 索引を持つオブジェクトはメンバの順序を問わない
+    for (int i = 0; i < 20; i++)
+    {
+        a << (i ? ",": "{") << "\"k" << i << "\":" << i;
+        b << (i ? ",": "{") << "\"k" << (19 - i) << "\":" << (19 - i);
+    }
+    a << "}";
+    b << "}";
+    root_ = KJSD_JSON_deserializeS(a.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(equals_json(root_, b.str().c_str()));
+
+    other = KJSD_JSON_clone(root_);
+    KJSD_CUNIT_ASSERT(other != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(
+                          KJSD_JSON_valueGetObject(other), "k19", 0) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(root_, other) == 0);
+    KJSD_JSON_free(other);
+    return 0;
+}
+
 static const char* test_createRoot()
 {
     root_ = KJSD_JSON_createRoot();
@@ -546,6 +1623,75 @@ static const char* test_createRoot()
     return 0;
 }
 
+static const char* test_clone()
+{
+    ostringstream sstr;
+    KJSD_JSON_Value* copy = 0;
+    KJSD_JSON_Object* obj = 0;
+    KJSD_JSON_Array* ary = 0;
+    char* out = 0;
+    string json_str;
+
+    sstr << "{\"a\":[1,2.5,\"s\",true,null,{\"b\":[]}],\"c\":{}";
+    for (int i = 0; i < 20; i++) sstr << ",\"k" << i << "\":" << i;
+    sstr << "}";
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_clone(0) == 0);
+
+    root_ = KJSD_JSON_deserializeS(sstr.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    json_str = out;
+    KJSD_JSON_freeString(out);
+
+    copy = KJSD_JSON_clone(root_);
+    KJSD_CUNIT_ASSERT(copy != 0);
+    KJSD_CUNIT_ASSERT(copy != root_);
+    out = KJSD_JSON_serializeAlloc(copy, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(json_str == out);
+    KJSD_JSON_freeString(out);
+
+    obj = KJSD_JSON_valueGetObject(copy);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "k19") == 19);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueIsInteger(
+                          KJSD_JSON_objectGetValue(obj, "k7")));
+    ary = KJSD_JSON_objectGetArray(obj, "a");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetString(ary, 2) != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetString(ary, 2) !=
+                      KJSD_JSON_arrayGetString(
+                          KJSD_JSON_objectGetArray(
+                              KJSD_JSON_valueGetObject(root_), "a"), 2));
+
+    // 複製の変更は複製元に影響しない
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(obj, "c", "x") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectRemove(obj, "k0") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddNumber(ary, 3) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddNumber(obj, "k20", 20) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "k20") == 20);
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(json_str == out);
+    KJSD_JSON_freeString(out);
+    KJSD_JSON_free(copy);
+
+    // アリーナ格納データの複製はアリーナ破棄後も使用できる
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    copy = KJSD_JSON_clone(
+        KJSD_JSON_arenaDeserializeS(arena_, "[{\"x\":\"y\"},[],-1]"));
+    KJSD_CUNIT_ASSERT(copy != 0);
+    KJSD_JSON_arenaDestroy(arena_);
+    arena_ = 0;
+    out = KJSD_JSON_serializeAlloc(copy, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "[{\"x\":\"y\"},[],-1]") == 0);
+    KJSD_JSON_freeString(out);
+    KJSD_JSON_free(copy);
+    return 0;
+}
+
 static const char* test_objectAddObject()
 {
     KJSD_JSON_Object* base = 0;
@@ -622,6 +1768,28 @@ static const char* test_objectAddNumber()
     return 0;
 }
 
+static const char* test_objectAddInteger()
+{
+    KJSD_JSON_Object* base = 0;
+
+    root_ = KJSD_JSON_createRoot();
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    base = KJSD_JSON_valueGetObject(root_);
+    KJSD_CUNIT_ASSERT(base != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddInteger(0, 0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddInteger(base, 0, 0) == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddInteger(base, "integer",
+                                                 INT64_MAX) > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(base, "integer")
+                      == INT64_MAX);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(root_)
+                      == strlen("{\"integer\":9223372036854775807}"));
+    return 0;
+}
+
 static const char* test_objectAddBool()
 {
     KJSD_JSON_Object* base = 0;
@@ -720,6 +1888,25 @@ static const char* test_arrayAddNumber()
     return 0;
 }
 
+static const char* test_arrayAddInteger()
+{
+    KJSD_JSON_Object* base = 0;
+    KJSD_JSON_Array* ary = 0;
+
+    root_ = KJSD_JSON_createRoot();
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    base = KJSD_JSON_valueGetObject(root_);
+    KJSD_CUNIT_ASSERT(base != 0);
+    ary = KJSD_JSON_objectAddArray(base, "ary");
+    KJSD_CUNIT_ASSERT(ary != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddInteger(0, 0) == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddInteger(ary, INT64_MIN) > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(ary, 0) == INT64_MIN);
+    return 0;
+}
+
 static const char* test_arrayAddBool()
 {
     KJSD_JSON_Object* base = 0;
@@ -739,6 +1926,459 @@ static const char* test_arrayAddBool()
     return 0;
 }
 
+static const char* test_objectSet()
+{
+    KJSD_JSON_Object* obj = 0;
+    char* out = 0;
+
+    root_ = KJSD_JSON_deserializeS("{ \"a\": \"str\", \"b\": [ 1, 2 ],"
+                                   "  \"c\": { \"d\": 1 } }");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetNumber(0, "a", 1) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetNumber(obj, 0, 1) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetObject(0, "a") == 0);
+
+    // 既存のメンバは同じ位置で置き換える
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(obj, "a", 10) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetBool(obj, "b", 1) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetArray(obj, "c") != 0);
+    // 置き換える値の一部も設定できる
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(obj, "d", "abc") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(
+                          obj, "d", KJSD_JSON_objectGetString(obj, "d") + 1)
+                      == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetNumber(obj, "e", 0.5) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetObject(obj, "e") != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetCount(obj) == 5);
+
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "{\"a\":10,\"b\":true,\"c\":[],"
+                             "\"d\":\"bc\",\"e\":{}}") == 0);
+    KJSD_JSON_freeString(out);
+
+    // アリーナ
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    KJSD_JSON_Value* doc = KJSD_JSON_arenaDeserializeS(arena_,
+                                                       "{ \"a\": [ 1 ] }");
+    KJSD_CUNIT_ASSERT(doc != 0);
+    obj = KJSD_JSON_valueGetObject(doc);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(obj, "a", "x") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(obj, "b", "y") == 1);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetString(obj, "a"), "x") == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetString(obj, "b"), "y") == 0);
+    return 0;
+}
+
+static const char* test_objectRemove()
+{
+    KJSD_JSON_Object* obj = 0;
+    ostringstream sstr;
+
+    sstr << "{";
+    for (int i = 0; i < 40; i++)
+    {
+        if (i > 0) sstr << ",";
+        sstr << "\"m" << i << "\":" << i;
+    }
+    sstr << "}";
+    root_ = KJSD_JSON_deserializeS(sstr.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectRemove(0, "m0") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectRemove(obj, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectRemove(obj, "none") == 0);
+
+    // 索引のあるオブジェクトでも後続のメンバを引ける
+    for (int i = 0; i < 40; i += 2)
+    {
+        ostringstream name;
+        name << "m" << i;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectRemove(obj, name.str().c_str())
+                          == 1);
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetCount(obj) == 20);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetName(obj, 0), "m1") == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetName(obj, 19), "m39") == 0);
+    for (int i = 1; i < 40; i += 2)
+    {
+        ostringstream name;
+        name << "m" << i;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(
+                              obj, name.str().c_str()) == i);
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetValue(obj, "m0") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddInteger(obj, "m0", 0) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "m0") == 0);
+    return 0;
+}
+
+static const char* test_arraySet()
+{
+    KJSD_JSON_Array* ary = 0;
+    char* out = 0;
+
+    root_ = KJSD_JSON_deserializeS("[ \"str\", { \"a\": [] }, 3, null ]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    ary = KJSD_JSON_valueGetArray(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetNumber(0, 0, 1) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetNumber(ary, 4, 1) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetArray(ary, 4) == 0);
+
+    // 取得済みの値はそのまま新しい値を指す
+    KJSD_JSON_Value* item = KJSD_JSON_arrayGetValue(ary, 2);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetString(ary, 2, "x") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetValue(ary, 2) == item);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_valueGetString(item), "x") == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetInteger(ary, 0, -1) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetObject(ary, 1) != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetBool(ary, 3, 0) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddInteger(
+                          KJSD_JSON_arraySetArray(ary, 1), 7) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arraySetNumber(ary, 3, 2.5) == 1);
+
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "[-1,[7],\"x\",2.5]") == 0);
+    KJSD_JSON_freeString(out);
+    return 0;
+}
+
+static const char* test_arrayInsert()
+{
+    KJSD_JSON_Array* ary = 0;
+    char* out = 0;
+
+    root_ = KJSD_JSON_deserializeS("[ 1, 2 ]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    ary = KJSD_JSON_valueGetArray(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertNumber(0, 0, 1) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertNumber(ary, 3, 1) == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertInteger(ary, 0, 0) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertString(ary, 3, "end") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertBool(ary, 2, 1) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertNumber(ary, 1, 0.5) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertObject(ary, 0) != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertArray(ary, 7) != 0);
+
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "[{},0,0.5,1,true,2,\"end\",[]]") == 0);
+    KJSD_JSON_freeString(out);
+    return 0;
+}
+
+static const char* test_arrayRemove()
+{
+    KJSD_JSON_Array* ary = 0;
+    char* out = 0;
+
+    root_ = KJSD_JSON_deserializeS("[ 1, \"a\", { \"b\": [ 2 ] }, [ 3 ], 4 ]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    ary = KJSD_JSON_valueGetArray(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayRemove(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayRemove(ary, 5) == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayRemove(ary, 2) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayRemove(ary, 0) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayRemove(ary, 2) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(ary) == 2);
+
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "[\"a\",[3]]") == 0);
+    KJSD_JSON_freeString(out);
+    return 0;
+}
+
+static const char* test_patch()
+{
+    static const char* cases[][3] = {
+        // 対象, パッチ, 結果 (RFC 6902 Appendix A)
+        { "{\"foo\":\"bar\"}",
+          "[{\"op\":\"add\",\"path\":\"/baz\",\"value\":\"qux\"}]",
+          "{\"baz\":\"qux\",\"foo\":\"bar\"}" },
+        { "{\"foo\":[\"bar\",\"baz\"]}",
+          "[{\"op\":\"add\",\"path\":\"/foo/1\",\"value\":\"qux\"}]",
+          "{\"foo\":[\"bar\",\"qux\",\"baz\"]}" },
+        { "{\"baz\":\"qux\",\"foo\":\"bar\"}",
+          "[{\"op\":\"remove\",\"path\":\"/baz\"}]",
+          "{\"foo\":\"bar\"}" },
+        { "{\"foo\":[\"bar\",\"qux\",\"baz\"]}",
+          "[{\"op\":\"remove\",\"path\":\"/foo/1\"}]",
+          "{\"foo\":[\"bar\",\"baz\"]}" },
+        { "{\"baz\":\"qux\",\"foo\":\"bar\"}",
+          "[{\"op\":\"replace\",\"path\":\"/baz\",\"value\":\"boo\"}]",
+          "{\"baz\":\"boo\",\"foo\":\"bar\"}" },
+        { "{\"foo\":{\"bar\":\"baz\",\"waldo\":\"fred\"},"
+          "\"qux\":{\"corge\":\"grault\"}}",
+          "[{\"op\":\"move\",\"from\":\"/foo/waldo\","
+          "\"path\":\"/qux/thud\"}]",
+          "{\"foo\":{\"bar\":\"baz\"},"
+          "\"qux\":{\"corge\":\"grault\",\"thud\":\"fred\"}}" },
+        { "{\"foo\":[\"all\",\"grass\",\"cows\",\"eat\"]}",
+          "[{\"op\":\"move\",\"from\":\"/foo/1\",\"path\":\"/foo/3\"}]",
+          "{\"foo\":[\"all\",\"cows\",\"eat\",\"grass\"]}" },
+        { "{\"baz\":\"qux\",\"foo\":[\"a\",2,\"c\"]}",
+          "[{\"op\":\"test\",\"path\":\"/baz\",\"value\":\"qux\"},"
+          "{\"op\":\"test\",\"path\":\"/foo/1\",\"value\":2}]",
+          "{\"baz\":\"qux\",\"foo\":[\"a\",2,\"c\"]}" },
+        { "{\"foo\":\"bar\"}",
+          "[{\"op\":\"add\",\"path\":\"/child\","
+          "\"value\":{\"grandchild\":{}}}]",
+          "{\"foo\":\"bar\",\"child\":{\"grandchild\":{}}}" },
+        { "{\"/\":9,\"~1\":10}",
+          "[{\"op\":\"test\",\"path\":\"/~01\",\"value\":10},"
+          "{\"op\":\"remove\",\"path\":\"/~1\"}]",
+          "{\"~1\":10}" },
+        { "{\"foo\":[\"bar\"]}",
+          "[{\"op\":\"add\",\"path\":\"/foo/-\",\"value\":[\"abc\",\"def\"]}]",
+          "{\"foo\":[\"bar\",[\"abc\",\"def\"]]}" },
+        // 複製元を含む位置への複製
+        { "{\"a\":{\"b\":1}}",
+          "[{\"op\":\"copy\",\"from\":\"/a\",\"path\":\"/a/c\"},"
+          "{\"op\":\"copy\",\"from\":\"/a/b\",\"path\":\"/a\"}]",
+          "{\"a\":1}" },
+        { "{\"a\":{\"b\":[1,2]}}",
+          "[{\"op\":\"move\",\"from\":\"/a/b\",\"path\":\"\"}]",
+          "[1,2]" },
+        { "{\"a\":1}",
+          "[{\"op\":\"replace\",\"path\":\"\",\"value\":{\"b\":[true]}}]",
+          "{\"b\":[true]}" },
+    };
+    static const char* errors[][2] = {
+        // 対象, 失敗するパッチ
+        { "{\"baz\":\"qux\"}",
+          "[{\"op\":\"test\",\"path\":\"/baz\",\"value\":\"bar\"}]" },
+        { "{\"foo\":\"bar\"}",
+          "[{\"op\":\"add\",\"path\":\"/baz/bat\",\"value\":\"qux\"}]" },
+        { "{\"foo\":\"bar\"}",
+          "[{\"op\":\"replace\",\"path\":\"/baz\",\"value\":1}]" },
+        { "{\"foo\":\"bar\"}", "[{\"op\":\"remove\",\"path\":\"/baz\"}]" },
+        { "{\"foo\":\"bar\"}", "[{\"op\":\"remove\",\"path\":\"\"}]" },
+        { "{\"foo\":\"bar\"}", "[{\"op\":\"add\",\"path\":\"/baz\"}]" },
+        { "{\"foo\":\"bar\"}", "[{\"op\":\"xxx\",\"path\":\"/baz\"}]" },
+        { "{\"foo\":\"bar\"}", "[{\"path\":\"/baz\"}]" },
+        { "{\"foo\":\"bar\"}", "[1]" },
+        { "{\"foo\":\"bar\"}", "{}" },
+        { "{\"foo\":\"bar\"}",
+          "[{\"op\":\"add\",\"path\":\"foo\",\"value\":1}]" },
+        { "{\"foo\":\"bar\"}",
+          "[{\"op\":\"add\",\"path\":\"/~2\",\"value\":1}]" },
+        { "{\"foo\":[1,2]}",
+          "[{\"op\":\"add\",\"path\":\"/foo/01\",\"value\":1}]" },
+        { "{\"foo\":[1,2]}",
+          "[{\"op\":\"add\",\"path\":\"/foo/3\",\"value\":1}]" },
+        { "{\"foo\":[1,2]}",
+          "[{\"op\":\"replace\",\"path\":\"/foo/-\",\"value\":1}]" },
+        { "{\"foo\":{\"bar\":1}}",
+          "[{\"op\":\"move\",\"from\":\"/foo\",\"path\":\"/foo/bar/x\"}]" },
+        { "{\"foo\":1}",
+          "[{\"op\":\"copy\",\"from\":\"/bar\",\"path\":\"/baz\"}]" },
+    };
+    KJSD_JSON_Object* obj = 0;
+
+    for (size_t i = 0; i < KJSD_LENGTH(cases); i++)
+    {
+        root_ = KJSD_JSON_deserializeS(cases[i][0]);
+        KJSD_CUNIT_ASSERT(root_ != 0);
+        KJSD_CUNIT_ASSERT(apply_patch(root_, cases[i][1]) == 1);
+        KJSD_CUNIT_ASSERT(equals_json(root_, cases[i][2]));
+        KJSD_JSON_free(root_);
+        root_ = 0;
+    }
+    for (size_t i = 0; i < KJSD_LENGTH(errors); i++)
+    {
+        root_ = KJSD_JSON_deserializeS(errors[i][0]);
+        KJSD_CUNIT_ASSERT(root_ != 0);
+        KJSD_CUNIT_ASSERT(apply_patch(root_, errors[i][1]) == 0);
+        KJSD_JSON_free(root_);
+        root_ = 0;
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_patch(0, 0) == 0);
+
+    // アリーナ格納データへの適用
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    root_ = KJSD_JSON_arenaDeserializeS(arena_, "{\"a\":[1],\"b\":\"x\"}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(apply_patch(
+                          root_,
+                          "[{\"op\":\"add\",\"path\":\"/a/0\","
+                          "\"value\":{\"c\":\"y\"}},"
+                          "{\"op\":\"move\",\"from\":\"/b\","
+                          "\"path\":\"/a/0/d\"},"
+                          "{\"op\":\"copy\",\"from\":\"/a\",\"path\":\"/e\"}]")
+                      == 1);
+    KJSD_CUNIT_ASSERT(equals_json(root_,
+                                  "{\"a\":[{\"c\":\"y\",\"d\":\"x\"},1],"
+                                  "\"e\":[{\"c\":\"y\",\"d\":\"x\"},1]}"));
+    obj = KJSD_JSON_valueGetObject(root_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetArray(obj, "a") !=
+                      KJSD_JSON_objectGetArray(obj, "e"));
+    root_ = 0;
+    return 0;
+}
+
+static const char* test_mergePatch()
+{
+    static const char* cases[][3] = {
+        // 対象, パッチ, 結果 (RFC 7386 Appendix A)
+        { "{\"a\":\"b\"}", "{\"a\":\"c\"}", "{\"a\":\"c\"}" },
+        { "{\"a\":\"b\"}", "{\"b\":\"c\"}", "{\"a\":\"b\",\"b\":\"c\"}" },
+        { "{\"a\":\"b\"}", "{\"a\":null}", "{}" },
+        { "{\"a\":\"b\",\"b\":\"c\"}", "{\"a\":null}", "{\"b\":\"c\"}" },
+        { "{\"a\":[\"b\"]}", "{\"a\":\"c\"}", "{\"a\":\"c\"}" },
+        { "{\"a\":\"c\"}", "{\"a\":[\"b\"]}", "{\"a\":[\"b\"]}" },
+        { "{\"a\":{\"b\":\"c\"}}", "{\"a\":{\"b\":\"d\",\"c\":null}}",
+          "{\"a\":{\"b\":\"d\"}}" },
+        { "{\"a\":[{\"b\":\"c\"}]}", "{\"a\":[1]}", "{\"a\":[1]}" },
+        { "[\"a\",\"b\"]", "[\"c\",\"d\"]", "[\"c\",\"d\"]" },
+        { "{\"a\":\"b\"}", "[\"c\"]", "[\"c\"]" },
+        { "{\"e\":null}", "{\"a\":1}", "{\"e\":null,\"a\":1}" },
+        { "[1,2]", "{\"a\":\"b\",\"c\":null}", "{\"a\":\"b\"}" },
+        { "{}", "{\"a\":{\"bb\":{\"ccc\":null}}}", "{\"a\":{\"bb\":{}}}" },
+    };
+
+    for (size_t i = 0; i < KJSD_LENGTH(cases); i++)
+    {
+        root_ = KJSD_JSON_deserializeS(cases[i][0]);
+        KJSD_CUNIT_ASSERT(root_ != 0);
+        KJSD_CUNIT_ASSERT(apply_patch(root_, cases[i][1], true) == 1);
+        KJSD_CUNIT_ASSERT(equals_json(root_, cases[i][2]));
+        KJSD_JSON_free(root_);
+        root_ = 0;
+    }
+    KJSD_CUNIT_ASSERT(KJSD_JSON_mergePatch(0, 0) == 0);
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    root_ = KJSD_JSON_arenaDeserializeS(arena_, "{\"a\":{\"b\":1},\"c\":2}");
+    KJSD_CUNIT_ASSERT(apply_patch(root_, "{\"a\":{\"d\":[\"x\"]},\"c\":null}",
+                                  true) == 1);
+    KJSD_CUNIT_ASSERT(equals_json(root_, "{\"a\":{\"b\":1,\"d\":[\"x\"]}}"));
+    root_ = 0;
+    return 0;
+}
+
+static const char* test_diff()
+{
+    static const char* cases[][2] = {
+        // 変更前, 変更後
+        { "{\"a\":1,\"b\":[1,2,3]}", "{\"a\":1,\"b\":[1,2,3]}" },
+        { "{\"a\":1,\"b\":2}", "{\"a\":1,\"c\":3}" },
+        { "{\"a\":{\"b\":{\"c\":1}}}", "{\"a\":{\"b\":{\"c\":2,\"d\":[]}}}" },
+        { "[1,2,3,4,5]", "[1,9,3,4,5]" },
+        { "[1,2,3,4,5]", "[0,1,2,3,4,5]" },
+        { "[1,2,3,4,5]", "[1,5]" },
+        { "[1,2,3]", "[4,5,6,7,8]" },
+        { "[[1,2],{\"a\":[3]}]", "[[1],{\"a\":[3,4]},null]" },
+        { "{\"a/b\":1,\"c~d\":2}", "{\"a/b\":3,\"c~d\":4,\"~/\":5}" },
+        { "{\"a\":1}", "[1]" },
+        { "{\"a\":1}", "{\"a\":1.0}" },
+    };
+    KJSD_JSON_Value* from = 0;
+    KJSD_JSON_Value* to = 0;
+    KJSD_JSON_Value* ops = 0;
+    KJSD_JSON_Object* rec = 0;
+    string json_str = make_records(100);
+    bool result = false;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_diff(0, 0) == 0);
+
+    for (size_t i = 0; i < KJSD_LENGTH(cases); i++)
+    {
+        from = KJSD_JSON_deserializeS(cases[i][0]);
+        to = KJSD_JSON_deserializeS(cases[i][1]);
+        KJSD_CUNIT_ASSERT((from != 0) && (to != 0));
+        root_ = KJSD_JSON_diff(from, to);
+        KJSD_CUNIT_ASSERT(root_ != 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_patch(from, root_) == 1);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(from, to) == 1);
+        KJSD_JSON_free(from);
+        KJSD_JSON_free(to);
+        KJSD_JSON_free(root_);
+        root_ = 0;
+    }
+
+    // 変更した部分だけが差分になる
+    from = KJSD_JSON_deserializeS("[1,2,3,4,5]");
+    to = KJSD_JSON_deserializeS("[1,9,3,4,5]");
+    root_ = KJSD_JSON_diff(from, to);
+    KJSD_JSON_free(from);
+    KJSD_JSON_free(to);
+    KJSD_CUNIT_ASSERT(equals_json(root_, "[{\"op\":\"replace\","
+                                  "\"path\":\"/1\",\"value\":9}]"));
+    KJSD_JSON_free(root_);
+
+    // 雛形と共有したままの部分木は比較しない
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    to = KJSD_JSON_arenaCloneShared(arena_, root_);
+    rec = KJSD_JSON_arrayGetObject(
+        KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(to), "records"), 3);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(rec, "name", "x") == 1);
+    ops = KJSD_JSON_diff(root_, to);
+    KJSD_CUNIT_ASSERT(ops != 0);
+    result = equals_json(ops, "[{\"op\":\"replace\","
+                         "\"path\":\"/records/3/name\",\"value\":\"x\"}]");
+    KJSD_JSON_free(ops);
+    KJSD_CUNIT_ASSERT(result);
+    return 0;
+}
+
+static const char* test_mergeDiff()
+{
+    static const char* cases[][2] = {
+        // 変更前, 変更後
+        { "{\"a\":1,\"b\":[1,2,3]}", "{\"a\":1,\"b\":[1,2,3]}" },
+        { "{\"a\":1,\"b\":2}", "{\"a\":1,\"c\":3}" },
+        { "{\"a\":{\"b\":{\"c\":1}}}", "{\"a\":{\"b\":{\"c\":2,\"d\":[]}}}" },
+        { "{\"a\":[1,2]}", "{\"a\":[1]}" },
+        { "{\"a\":{\"b\":1}}", "{\"a\":2}" },
+        { "{\"a\":1}", "[1]" },
+        { "[1]", "{\"a\":1}" },
+    };
+    KJSD_JSON_Value* from = 0;
+    KJSD_JSON_Value* to = 0;
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_mergeDiff(0, 0) == 0);
+
+    for (size_t i = 0; i < KJSD_LENGTH(cases); i++)
+    {
+        from = KJSD_JSON_deserializeS(cases[i][0]);
+        to = KJSD_JSON_deserializeS(cases[i][1]);
+        KJSD_CUNIT_ASSERT((from != 0) && (to != 0));
+        root_ = KJSD_JSON_mergeDiff(from, to);
+        KJSD_CUNIT_ASSERT(root_ != 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_mergePatch(from, root_) == 1);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(from, to) == 1);
+        KJSD_JSON_free(from);
+        KJSD_JSON_free(to);
+        KJSD_JSON_free(root_);
+        root_ = 0;
+    }
+
+    from = KJSD_JSON_deserializeS("{\"a\":1,\"b\":{\"c\":2,\"d\":3}}");
+    to = KJSD_JSON_deserializeS("{\"a\":1,\"b\":{\"c\":2},\"e\":4}");
+    root_ = KJSD_JSON_mergeDiff(from, to);
+    KJSD_JSON_free(from);
+    KJSD_JSON_free(to);
+    KJSD_CUNIT_ASSERT(equals_json(root_, "{\"b\":{\"d\":null},\"e\":4}"));
+    return 0;
+}
+
 static const char* test_sizeof()
 {
     static const char* json_str = "[{},[],\"str\",1,true]";
@@ -785,55 +2425,1918 @@ static const char* test_serializeS()
     KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, 0, 0) == 0);
 
     KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, out, sz) == (sz - 1));
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+
+    // 領域に収まらない分は切り詰めて'\0'終端する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, out, 5) == 4);
+    KJSD_CUNIT_ASSERT(strcmp(out, "[{},") == 0);
+
+    delete[] out;
+    return 0;
+}
+
+/// コールバック出力のテスト用
+struct WriteSink
+{
+    string out;
+    size_t calls;
+    size_t limit;
+};
+
+static size_t write_sink(void *ctx, const char *data, size_t size)
+{
+    WriteSink *sink = static_cast<WriteSink*>(ctx);
+
+    sink->calls++;
+    if (sink->out.size() + size > sink->limit)
+    {
+        size = sink->limit - sink->out.size();
+    }
+    sink->out.append(data, size);
+    return size;
+}
+
+static const char* test_serializeAlloc()
+{
+    static const char* json_str = "[{},[],\"str\",1,true,null]";
+    size_t length = 1;
+
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeAlloc(0, &length) == 0);
+    KJSD_CUNIT_ASSERT(length == 0);
+
+    char* out = KJSD_JSON_serializeAlloc(root_, &length);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(length == strlen(json_str));
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    KJSD_JSON_freeString(out);
+
+    // 内部バッファを拡張しながら出力する
+    KJSD_JSON_free(root_);
+    string records = make_records(1000);
+    root_ = KJSD_JSON_deserializeS(records.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strlen(out) == KJSD_JSON_sizeof(root_));
+    KJSD_CUNIT_ASSERT(strncmp(out, "{\"records\":[{\"id\":0,", 20) == 0);
+    KJSD_JSON_freeString(out);
+    return 0;
+}
+
+static const char* test_serializeFd()
+{
+    static const char* json_str = "[{},[],\"str\",1,true,null]";
+    char out[64];
+
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFd(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFd(root_, -1) == 0);
+
+    FILE* fp = tmpfile();
+    KJSD_CUNIT_ASSERT(fp != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFd(root_, fileno(fp))
+                      == strlen(json_str));
+
+    rewind(fp);
+    size_t sz = fread(out, 1, sizeof(out) - 1, fp);
+    fclose(fp);
+    out[sz] = '\0';
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    return 0;
+}
+
+static const char* test_serializeCallback()
+{
+    static const char* json_str = "[{},[],\"str\",1,true,null]";
+    WriteSink sink = { "", 0, (size_t)-1 };
+
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeCallback(0, write_sink, &sink) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeCallback(root_, 0, &sink) == 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeCallback(root_, write_sink, &sink)
+                      == strlen(json_str));
+    KJSD_CUNIT_ASSERT(sink.out == json_str);
+    KJSD_CUNIT_ASSERT(sink.calls == 1);
+
+    // 内部バッファを超える出力はまとまった単位で渡される
+    KJSD_JSON_free(root_);
+    string records = make_records(1000);
+    root_ = KJSD_JSON_deserializeS(records.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    sink.out.clear();
+    sink.calls = 0;
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeCallback(root_, write_sink, &sink)
+                      == KJSD_JSON_sizeof(root_));
+    KJSD_CUNIT_ASSERT(sink.out.size() == KJSD_JSON_sizeof(root_));
+    KJSD_CUNIT_ASSERT(sink.calls > 1);
+    KJSD_CUNIT_ASSERT(sink.calls < sink.out.size() / 4096);
+
+    // 書き込みが打ち切られたら以降は出力しない
+    sink.out.clear();
+    sink.calls = 0;
+    sink.limit = 100;
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeCallback(root_, write_sink, &sink)
+                      == 100);
+    KJSD_CUNIT_ASSERT(sink.calls == 1);
+    return 0;
+}
+
+static const char* test_serializeFormat()
+{
+    static const char* json_str =
+        "{\"b\":[1,{}],\"a\":{\"y\":null,\"x\":\"s\"},\"c\":[]}";
+    static const char* pretty_str =
+        "{\n"
+        "  \"b\": [\n"
+        "    1,\n"
+        "    {}\n"
+        "  ],\n"
+        "  \"a\": {\n"
+        "    \"y\": null,\n"
+        "    \"x\": \"s\"\n"
+        "  },\n"
+        "  \"c\": []\n"
+        "}";
+    static const char* sorted_str =
+        "{\"a\":{\"x\":\"s\",\"y\":null},\"b\":[1,{}],\"c\":[]}";
+    static const char* both_str = "{\n    \"a\": {\n        \"x\": \"s\",\n";
+    KJSD_JSON_Format compact = { 0, 0 };
+    KJSD_JSON_Format pretty = { 2, 0 };
+    KJSD_JSON_Format sorted = { 0, 1 };
+    KJSD_JSON_Format both = { 4, 1 };
+    WriteSink sink = { "", 0, (size_t)-1 };
+    ostringstream os;
+    size_t length = 1;
+    char* out = 0;
+    KJSD_JSON_Value* other = 0;
+
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFormatAlloc(0, &pretty, &length)
+                      == 0);
+    KJSD_CUNIT_ASSERT(length == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFormat(root_, &pretty, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFormatCallback(root_, &pretty,
+                                                        0, &sink) == 0);
+
+    // 形式を指定しない場合は通常の出力
+    out = KJSD_JSON_serializeFormatAlloc(root_, 0, &length);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    KJSD_CUNIT_ASSERT(length == strlen(json_str));
+    KJSD_JSON_freeString(out);
+
+    out = KJSD_JSON_serializeFormatAlloc(root_, &compact, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    KJSD_JSON_freeString(out);
+
+    out = KJSD_JSON_serializeFormatAlloc(root_, &pretty, &length);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, pretty_str) == 0);
+    KJSD_CUNIT_ASSERT(length == strlen(pretty_str));
+    KJSD_JSON_freeString(out);
+
+    out = KJSD_JSON_serializeFormatAlloc(root_, &sorted, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, sorted_str) == 0);
+    KJSD_JSON_freeString(out);
+
+    // 字下げと名称順を組み合わせる
+    out = KJSD_JSON_serializeFormatAlloc(root_, &both, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strncmp(out, both_str, strlen(both_str)) == 0);
+    other = KJSD_JSON_deserializeS(out);
+    KJSD_JSON_freeString(out);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(root_, other) == 1);
+    KJSD_JSON_free(other);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFormatCallback(root_, &pretty,
+                                                        write_sink, &sink)
+                      == strlen(pretty_str));
+    KJSD_CUNIT_ASSERT(sink.out == pretty_str);
+
+    FILE* fp = tmpfile();
+    KJSD_CUNIT_ASSERT(fp != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeFormat(root_, &sorted, fp)
+                      == strlen(sorted_str));
+    fclose(fp);
+    KJSD_JSON_free(root_);
+
+    // 作業領域を確保して並べる大きなオブジェクト
+    for (int i = 39; i >= 0; i--)
+    {
+        os << (i < 39 ? ",": "{") << "\"k" << (100 + i) << "\":" << i;
+    }
+    os << "}";
+    root_ = KJSD_JSON_deserializeS(os.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    out = KJSD_JSON_serializeFormatAlloc(root_, &sorted, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strncmp(out, "{\"k100\":0,\"k101\":1,", 19) == 0);
+    other = KJSD_JSON_deserializeS(out);
+    KJSD_JSON_freeString(out);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueEquals(root_, other) == 1);
+    KJSD_JSON_free(other);
+    KJSD_JSON_free(root_);
+
+    // 遅延構築・雛形共有のデータも同じ出力になる
+    string records = make_records(100);
+    root_ = KJSD_JSON_deserializeS(records.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    out = KJSD_JSON_serializeFormatAlloc(root_, &both, &length);
+    KJSD_CUNIT_ASSERT(out != 0);
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    other = KJSD_JSON_arenaCloneShared(arena_, root_);
+    KJSD_CUNIT_ASSERT(other != 0);
+    char* shared = KJSD_JSON_serializeFormatAlloc(other, &both, 0);
+    KJSD_CUNIT_ASSERT(shared != 0);
+    bool same = (strcmp(out, shared) == 0);
+    KJSD_JSON_freeString(shared);
+    KJSD_JSON_arenaReset(arena_);
+
+    other = KJSD_JSON_arenaDeserializeLazy(arena_, records.c_str());
+    KJSD_CUNIT_ASSERT(other != 0);
+    char* lazy = KJSD_JSON_serializeFormatAlloc(other, &both, 0);
+    KJSD_CUNIT_ASSERT(lazy != 0);
+    same = same && (strcmp(out, lazy) == 0);
+    KJSD_JSON_freeString(lazy);
+    KJSD_JSON_freeString(out);
+    KJSD_CUNIT_ASSERT(same);
+    return 0;
+}
+
+static const char* test_serializeString()
+{
+    static const char* json_str =
+        "{\"k\\\"\\n\":[\"\\u0001\\u001F\\u007f\\b\\f\\n\\r\\t\\\"\\\\\\/ \\u3042\","
+        "\"0123456789abcdef0123456789abcdef\\n0123456789abcdef\"]}";
+    static const char* expected =
+        "{\"k\\\"\\n\":[\"\\u0001\\u001f\x7f\\b\\f\\n\\r\\t\\\"\\\\\\/ \xe3\x81\x82\","
+        "\"0123456789abcdef0123456789abcdef\\n0123456789abcdef\"]}";
+    char out[256];
+
+    // 制御文字はRFCに従ってエスケープし、UTF-8はそのまま出力する
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, out, sizeof(out))
+                      == strlen(expected));
+    KJSD_CUNIT_ASSERT(strcmp(out, expected) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(root_) == strlen(expected));
+
+    // 出力を読み戻すと同じ値になる
+    KJSD_JSON_Value* value = KJSD_JSON_deserializeS(out);
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(value, out, sizeof(out))
+                      == strlen(expected));
+    KJSD_JSON_free(value);
+    KJSD_CUNIT_ASSERT(strcmp(out, expected) == 0);
+    KJSD_JSON_free(root_);
+
+    // NULLで設定した文字列はnullとして出力する
+    static const char* null_str = "{\"k\":null,\"a\":[null]}";
+    KJSD_JSON_Format pretty = { 1, 1 };
+    root_ = KJSD_JSON_deserializeS("{}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_JSON_Object* obj = KJSD_JSON_valueGetObject(root_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddString(obj, "k", 0) > 0);
+    KJSD_JSON_Array* ary = KJSD_JSON_objectAddArray(obj, "a");
+    KJSD_CUNIT_ASSERT(ary != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddString(ary, 0) > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(root_) == strlen(null_str));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, out, sizeof(out))
+                      == strlen(null_str));
+    KJSD_CUNIT_ASSERT(strcmp(out, null_str) == 0);
+    char* str = KJSD_JSON_serializeFormatAlloc(root_, &pretty, 0);
+    KJSD_CUNIT_ASSERT(str != 0);
+    bool same = (strcmp(str, "{\n \"a\": [\n  null\n ],\n \"k\": null\n}")
+                 == 0);
+    KJSD_JSON_freeString(str);
+    KJSD_CUNIT_ASSERT(same);
+    return 0;
+}
+
+static const char* test_serializeBinary()
+{
+    static const char* json_str =
+        "{\"a\":[null,true,false,0,-1,9223372036854775807,"
+        "-9223372036854775808,0.1,-0,1e+308],"
+        "\"b\":{\"\":\"\",\"\xe3\x81\x82\":\"x\\\"y\"},\"c\":[[[]]]}";
+    char out[256];
+    size_t length = 1;
+
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeBinary(0, &length) == 0);
+    KJSD_CUNIT_ASSERT(length == 0);
+
+    char* bin = KJSD_JSON_serializeBinary(root_, &length);
+    KJSD_CUNIT_ASSERT(bin != 0);
+    KJSD_CUNIT_ASSERT(length > 4);
+    KJSD_CUNIT_ASSERT(memcmp(bin, "KJB\001", 4) == 0);
+
+    // 読み戻すと同じJSONデータになる
+    KJSD_JSON_Value* value = KJSD_JSON_deserializeBinary(bin, length);
+    KJSD_JSON_freeString(bin);
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_JSON_serializeS(value, out, sizeof(out));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueIsInteger(
+                          KJSD_JSON_arrayGetValue(
+                              KJSD_JSON_objectGetArray(
+                                  KJSD_JSON_valueGetObject(value), "a"), 5)));
+    KJSD_JSON_free(value);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+
+    // NULLで設定した文字列はnullとして読み戻す
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddString(
+                          KJSD_JSON_valueGetObject(root_), "d", 0) > 0);
+    bin = KJSD_JSON_serializeBinary(root_, &length);
+    KJSD_CUNIT_ASSERT(bin != 0);
+    value = KJSD_JSON_deserializeBinary(bin, length);
+    KJSD_JSON_freeString(bin);
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetType(
+                          KJSD_JSON_objectGetValue(
+                              KJSD_JSON_valueGetObject(value), "d"))
+                      == KJSD_JSON_NULL);
+    KJSD_JSON_free(value);
+    return 0;
+}
+
+static const char* test_deserializeBinary()
+{
+    static const char valid[] = "KJB\001\006\002\004\003\002";
+    static const char* invalid[] = {
+        "",                             // 空
+        "KJB\002\000",                  // バージョン不一致
+        "KJB\001",                      // 値なし
+        "KJB\001\010",                  // 不明なタグ
+        "KJB\001\003\000\000",          // 数値の途中で終端
+        "KJB\001\006\003\000",          // 要素数が残りより多い
+        "KJB\001\006\377\377\377\377\377\377\377\377\377\177",
+        "KJB\001\005\002a\000",         // 文字列中の'\0'
+        "KJB\001\007\002\001a\000\001a\001", // メンバ名称の重複
+        "KJB\001\000\000",              // 余分なデータ
+    };
+    static const size_t sizes[] = { 0, 5, 4, 5, 7, 7, 15, 8, 12, 6 };
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeBinary(0, 0) == 0);
+
+    root_ = KJSD_JSON_deserializeBinary(valid, sizeof(valid) - 1);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_valueGetArray(root_)) == 2);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(
+                          KJSD_JSON_valueGetArray(root_), 0) == -2);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetBool(
+                          KJSD_JSON_valueGetArray(root_), 1) == 1);
+
+    for (size_t i = 0; i < KJSD_LENGTH(invalid); i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeBinary(invalid[i], sizes[i])
+                          == 0);
+    }
+
+    // 入れ子の上限
+    string nested = "KJB\001";
+    for (int i = 0; i < 19; i++) nested += "\006\001";
+    nested += string("\006\000", 2);
+    root_ = KJSD_JSON_deserializeBinary(nested.data(), nested.size());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    nested.insert(4, "\006\001");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeBinary(nested.data(),
+                                                  nested.size()) == 0);
+    return 0;
+}
+
+static const char* test_serializeNumber()
+{
+    static const char* json_str =
+        "[0,-0,1500,0.25,1.123,0.1,1e+21,1e-7,0.000001,"
+        "0.30000000000000004,-1.7976931348623157e+308,5e-324,"
+        "-9223372036854775808]";
+    char out[256];
+
+    // 短い桁数で出力し、読み戻すと同じ値になる
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, out, sizeof(out)) > 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+
+    // 丸めの境界と桁数の多い数値
+    KJSD_JSON_free(root_);
+    root_ = KJSD_JSON_deserializeS("[2.2250738585072011e-308,"
+                                   " 9007199254740993.0,"
+                                   " 123456789012345678901234567890,"
+                                   " 0.1e1, 1E-400, 1e400]");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, out, sizeof(out)) > 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "[2.225073858507201e-308,"
+                             "9007199254740992,"
+                             "1.2345678901234568e+29,"
+                             "1,0,null]") == 0);
+    return 0;
+}
+
+static const char* test_setAllocator()
+{
+    AllocCounter counter = { 0, 0 };
+    KJSD_JSON_Allocator allocator = {
+        count_alloc, count_resize, count_release, &counter
+    };
+    KJSD_JSON_Allocator broken = { 0, count_resize, count_release, 0 };
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_setAllocator(&broken) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_setAllocator(&allocator) == 1);
+
+    root_ = KJSD_JSON_deserializeS(make_records(100).c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    char* out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_JSON_freeString(out);
+    KJSD_CUNIT_ASSERT(counter.allocs > 100);
+    KJSD_CUNIT_ASSERT(counter.releases < counter.allocs);
+
+    KJSD_JSON_free(root_);
+    root_ = 0;
+    KJSD_CUNIT_ASSERT(counter.releases == counter.allocs);
+
+    // 標準ライブラリに戻す
+    KJSD_CUNIT_ASSERT(KJSD_JSON_setAllocator(0) == 1);
+    root_ = KJSD_JSON_deserializeS("{ \"a\": [ 1, 2 ] }");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(counter.releases == counter.allocs);
+    return 0;
+}
+
+static const char* test_arenaCreate()
+{
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_JSON_arenaDestroy(0);
+    return 0;
+}
+
+static const char* test_arenaCreateWithAllocator()
+{
+    AllocCounter counter = { 0, 0 };
+    KJSD_JSON_Allocator allocator = {
+        count_alloc, count_resize, count_release, &counter
+    };
+    KJSD_JSON_Allocator broken = { count_alloc, 0, count_release, 0 };
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaCreateWithAllocator(0, &broken) == 0);
+
+    arena_ = KJSD_JSON_arenaCreateWithAllocator(256, &allocator);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    KJSD_CUNIT_ASSERT(counter.allocs == 1);
+
+    KJSD_JSON_Value* value = KJSD_JSON_arenaDeserializeS(
+        arena_, make_records(100).c_str());
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(KJSD_JSON_objectGetArray(
+                          KJSD_JSON_valueGetObject(value), "records"))
+                      == 100);
+    KJSD_CUNIT_ASSERT(counter.allocs > 2);
+    KJSD_CUNIT_ASSERT(counter.releases == 0);
+
+    KJSD_JSON_arenaReset(arena_);
+    KJSD_CUNIT_ASSERT(counter.releases == counter.allocs - 2);
+
+    KJSD_JSON_arenaDestroy(arena_);
+    arena_ = 0;
+    KJSD_CUNIT_ASSERT(counter.releases == counter.allocs);
+    return 0;
+}
+
+static const char* test_arenaDeserialize()
+{
+    FILE* in;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserialize(0, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserialize(arena_, 0) == 0);
+
+    in = fopen("test/json/test_2.txt", "r");
+    root_ = KJSD_JSON_arenaDeserialize(arena_, in);
+    fclose(in);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectDotGetString(
+                                 KJSD_JSON_valueGetObject(root_),
+                                 "object.nested string"), "str") == 0);
+    return 0;
+}
+
+static string read_file(const char* path)
+{
+    ostringstream sstr;
+    FILE* in = fopen(path, "rb");
+    char buf[256];
+    size_t sz;
+
+    if (in == 0) return "";
+    while ((sz = fread(buf, 1, sizeof(buf), in)) > 0) sstr.write(buf, sz);
+    fclose(in);
+    return sstr.str();
+}
+
+static const char* test_arenaDeserializeFile()
+{
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFile(
+                          0, "test/json/test_2.txt") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFile(arena_, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFile(
+                          arena_, "test/json/none.txt") == 0);
+
+    root_ = KJSD_JSON_arenaDeserializeFile(arena_, "test/json/test_2.txt");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectDotGetString(
+                                 KJSD_JSON_valueGetObject(root_),
+                                 "object.nested string"), "str") == 0);
+    return 0;
+}
+
+static const char* test_arenaDeserializeFileInSitu()
+{
+    string before = read_file("test/json/test_2.txt");
+    KJSD_JSON_Value* value;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileInSitu(
+                          0, "test/json/test_2.txt") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileInSitu(arena_, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileInSitu(
+                          arena_, "test/json/none.txt") == 0);
+
+    value = KJSD_JSON_arenaDeserializeFileInSitu(arena_,
+                                                 "test/json/test_2.txt");
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectDotGetString(
+                                 KJSD_JSON_valueGetObject(value),
+                                 "object.nested string"), "str") == 0);
+
+    // ファイルは書き換えない
+    KJSD_CUNIT_ASSERT(read_file("test/json/test_2.txt") == before);
+
+    // リセット後も再利用できる
+    KJSD_JSON_arenaReset(arena_);
+    value = KJSD_JSON_arenaDeserializeFileInSitu(arena_,
+                                                 "test/json/test_1_1.txt");
+    KJSD_CUNIT_ASSERT(value != 0);
+    return 0;
+}
+
+static const char* test_arenaDeserializeS()
+{
+    KJSD_JSON_Object* obj = 0;
+
+    // チャンクを跨ぐように小さなチャンクサイズにしておく
+    arena_ = KJSD_JSON_arenaCreate(64);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(0, "[]") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(arena_, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(arena_, "{ \"a\": }")
+                      == 0);
+
+    root_ = KJSD_JSON_arenaDeserializeS(arena_, make_records(100).c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    obj = KJSD_JSON_arrayGetObject(
+        KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(root_), "records"),
+        99);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetNumber(obj, "id") == 99);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetString(obj, "name"),
+                             "record99") == 0);
+
+    // 追加したメンバも同じアリーナに格納される
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddString(obj, "added", "str") > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddNumber(
+                          KJSD_JSON_objectGetArray(obj, "tags"), 1) > 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_objectGetArray(obj, "tags")) == 4);
+    return 0;
+}
+
+static const char* test_arenaDeserializeInSitu()
+{
+    char in[] = "{ \"aaa\": \"bbb\", \"c\\\"c\": [\"d\\nd\", \"\", \"eee\"] }";
+    char* end = in + sizeof(in);
+    KJSD_JSON_Object* obj = 0;
+    KJSD_JSON_Array* array = 0;
+    const char* str = 0;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeInSitu(0, in) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeInSitu(arena_, 0) == 0);
+
+    root_ = KJSD_JSON_arenaDeserializeInSitu(arena_, in);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    // エスケープを含まない文字列は入力バッファを直接参照する
+    str = KJSD_JSON_objectGetName(obj, 0);
+    KJSD_CUNIT_ASSERT(strcmp(str, "aaa") == 0);
+    KJSD_CUNIT_ASSERT((str >= in) && (str < end));
+    str = KJSD_JSON_objectGetString(obj, "aaa");
+    KJSD_CUNIT_ASSERT(strcmp(str, "bbb") == 0);
+    KJSD_CUNIT_ASSERT((str >= in) && (str < end));
+
+    // エスケープを含む文字列はアリーナにコピーされる
+    str = KJSD_JSON_objectGetName(obj, 1);
+    KJSD_CUNIT_ASSERT(strcmp(str, "c\"c") == 0);
+    KJSD_CUNIT_ASSERT((str < in) || (str >= end));
+
+    array = KJSD_JSON_objectGetArray(obj, "c\"c");
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(array, 0), "d\nd") == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(array, 1), "") == 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_arrayGetString(array, 2), "eee") == 0);
+    return 0;
+}
+
+static const char* test_arenaDeserializeLazy()
+{
+    static const char* json_str =
+        "{\"a\":{\"b\":[1,{\"c\":\"[{\\\"}\"},[]]},\"d\":null,"
+        " \"e\":[{\"f\":tru}], \"g\":[\"x\",{}]}";
+    KJSD_JSON_Object* obj = 0;
+    KJSD_JSON_Array* array = 0;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(0, "[]") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, 0) == 0);
+    // 括弧の対応不正は最初に検出する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, "[{]}") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, "[[]") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, "[\"]") == 0);
+
+    // メンバ名称の'\0'は構築時に失敗する
+    root_ = KJSD_JSON_arenaDeserializeLazy(arena_, "{\"a\\u0000b\":1}");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeAlloc(root_, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(
+                          arena_, "{\"a\\u0000b\":1}") == 0);
+    root_ = 0;
+
+    // ルートの後のデータはKJSD_JSON_arenaDeserializeSと同様に無視する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, "[] []") != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, "[1] ]") != 0);
+    root_ = KJSD_JSON_arenaDeserializeLazy(arena_, "{\"a\":1} x");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(
+                          KJSD_JSON_valueGetObject(root_), "a") == 1);
+    root_ = 0;
+
+    // 入れ子は20段まで
+    string nested = string(20, '[') + string(20, ']');
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, nested.c_str())
+                      != 0);
+    nested = "[" + nested + "]";
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeLazy(arena_, nested.c_str())
+                      == 0);
+
+    root_ = KJSD_JSON_arenaDeserializeLazy(arena_, json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    // 参照した階層だけ構築する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetValue(obj, "a.b") != 0);
+    array = KJSD_JSON_objectGetArray(
+        KJSD_JSON_objectGetObject(obj, "a"), "b");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(array) == 3);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetInteger(array, 0) == 1);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetString(
+                                 KJSD_JSON_arrayGetObject(array, 1), "c"),
+                             "[{\"}") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_arrayGetArray(array, 2)) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetType(
+                          KJSD_JSON_objectGetValue(obj, "d"))
+                      == KJSD_JSON_NULL);
+
+    // 構文エラーは参照した時に検出する
+    array = KJSD_JSON_objectGetArray(obj, "e");
+    KJSD_CUNIT_ASSERT(array != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetObject(array, 0) != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetCount(
+                          KJSD_JSON_arrayGetObject(array, 0)) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_serializeAlloc(root_, 0) == 0);
+
+    // 構築前のコンテナにも追加できる
+    array = KJSD_JSON_objectGetArray(obj, "g");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddInteger(
+                          KJSD_JSON_arrayGetArray(
+                              KJSD_JSON_objectGetArray(
+                                  KJSD_JSON_objectGetObject(obj, "a"), "b"),
+                              2), 5) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddBool(
+                          KJSD_JSON_arrayGetObject(array, 1), "h", 1) == 1);
+    KJSD_JSON_Array* e = KJSD_JSON_objectGetArray(obj, "e");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(e) == 1);
+    return 0;
+}
+
+static const char* test_arenaDeserializeFileLazy()
+{
+    KJSD_JSON_Value* value;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileLazy(
+                          0, "test/json/test_2.txt") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileLazy(arena_, 0) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileLazy(
+                          arena_, "test/json/none.txt") == 0);
+
+    value = KJSD_JSON_arenaDeserializeFileLazy(arena_,
+                                               "test/json/test_2.txt");
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectDotGetString(
+                                 KJSD_JSON_valueGetObject(value),
+                                 "object.nested string"), "str") == 0);
+
+    // 全体をパースした結果と同じになる
+    root_ = KJSD_JSON_deserializeFile("test/json/test_2.txt");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(value) == KJSD_JSON_sizeof(root_));
+    return 0;
+}
+
+static const char* test_arenaDeserializeBinary()
+{
+    string json_str = make_records(100);
+    size_t length;
+
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    char* bin = KJSD_JSON_serializeBinary(root_, &length);
+    KJSD_CUNIT_ASSERT(bin != 0);
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeBinary(0, bin, length) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeBinary(arena_, 0, 0) == 0);
+
+    KJSD_JSON_Value* value =
+        KJSD_JSON_arenaDeserializeBinary(arena_, bin, length);
+    KJSD_CUNIT_ASSERT(value != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(value) == json_str.size());
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeBinary(arena_, bin,
+                                                       length - 1) == 0);
+    KJSD_JSON_freeString(bin);
+    return 0;
+}
+
+static const char* test_arenaReset()
+{
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_JSON_arenaReset(0);
+    KJSD_JSON_arenaReset(arena_);
+
+    for (int i = 0; i < 3; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(
+                              arena_, make_records(100).c_str()) != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    return 0;
+}
+
+static const char* test_arenaCreateRoot()
+{
+    KJSD_JSON_Object* base = 0;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaCreateRoot(0) == 0);
+
+    root_ = KJSD_JSON_arenaCreateRoot(arena_);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    base = KJSD_JSON_valueGetObject(root_);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddObject(base, "obj") != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetObject(base, "obj") != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(root_) == strlen("{\"obj\":{}}"));
+    return 0;
+}
+
+static const char* test_arenaClone()
+{
+    string json_str = make_records(3);
+    KJSD_JSON_Value* copy = 0;
+    KJSD_JSON_Value* copy2 = 0;
+    KJSD_JSON_Object* rec = 0;
+    KJSD_JSON_Object* rec2 = 0;
+    char* out = 0;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaClone(0, root_) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaClone(arena_, 0) == 0);
+
+    // 複製元を解放しても複製は使用できる
+    copy = KJSD_JSON_arenaClone(arena_, root_);
+    KJSD_CUNIT_ASSERT(copy != 0);
+    KJSD_JSON_free(root_);
+    root_ = 0;
+    out = KJSD_JSON_serializeAlloc(copy, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(json_str == out);
+    KJSD_JSON_freeString(out);
+
+    // メンバ名はアリーナ内で共有される
+    copy2 = KJSD_JSON_arenaClone(arena_, copy);
+    KJSD_CUNIT_ASSERT(copy2 != 0);
+    rec = KJSD_JSON_arrayGetObject(
+        KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(copy), "records"),
+        1);
+    rec2 = KJSD_JSON_arrayGetObject(
+        KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(copy2), "records"),
+        1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetName(rec, 0) ==
+                      KJSD_JSON_objectGetName(rec2, 0));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetString(rec, "name") !=
+                      KJSD_JSON_objectGetString(rec2, "name"));
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(rec2, "name", "x") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayAddString(
+                          KJSD_JSON_objectGetArray(rec2, "tags"), "c") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_objectGetArray(rec2, "tags")) == 4);
+    KJSD_CUNIT_ASSERT(strcmp(KJSD_JSON_objectGetString(rec, "name"),
+                             "record1") == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_objectGetArray(rec, "tags")) == 3);
+
+    // 遅延構築データの複製
+    copy = KJSD_JSON_arenaClone(
+        arena_, KJSD_JSON_arenaDeserializeLazy(arena_, json_str.c_str()));
+    KJSD_CUNIT_ASSERT(copy != 0);
+    out = KJSD_JSON_serializeAlloc(copy, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(json_str == out);
+    KJSD_JSON_freeString(out);
+    return 0;
+}
+
+static const char* test_arenaCloneShared()
+{
+    static const char* json_str =
+        "{\"user\":{\"name\":\"tmpl\",\"tags\":[\"a\",\"b\"]},"
+        "\"items\":[1,2,3],\"meta\":{\"v\":1}}";
+    ostringstream sstr;
+    KJSD_JSON_Value* d1 = 0;
+    KJSD_JSON_Value* d2 = 0;
+    KJSD_JSON_Value* d3 = 0;
+    KJSD_JSON_Object* base = 0;
+    KJSD_JSON_Object* obj = 0;
+    char* out = 0;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    root_ = KJSD_JSON_deserializeS(json_str);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    base = KJSD_JSON_valueGetObject(root_);
+
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaCloneShared(0, root_) == 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arenaCloneShared(arena_, 0) == 0);
+
+    d1 = KJSD_JSON_arenaCloneShared(arena_, root_);
+    d2 = KJSD_JSON_arenaCloneShared(arena_, root_);
+    KJSD_CUNIT_ASSERT((d1 != 0) && (d2 != 0));
+    out = KJSD_JSON_serializeAlloc(d1, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    KJSD_JSON_freeString(out);
+
+    obj = KJSD_JSON_valueGetObject(d1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetString(
+                          KJSD_JSON_objectGetObject(obj, "user"),
+                          "name", "alice") == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayInsertNumber(
+                          KJSD_JSON_objectGetArray(obj, "items"), 0, 0) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectRemove(obj, "meta") == 1);
+    out = KJSD_JSON_serializeAlloc(d1, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, "{\"user\":{\"name\":\"alice\","
+                             "\"tags\":[\"a\",\"b\"]},"
+                             "\"items\":[0,1,2,3]}") == 0);
+    KJSD_JSON_freeString(out);
+
+    // 雛形と他の複製は変わらない
+    out = KJSD_JSON_serializeAlloc(root_, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    KJSD_JSON_freeString(out);
+    out = KJSD_JSON_serializeAlloc(d2, 0);
+    KJSD_CUNIT_ASSERT(out != 0);
+    KJSD_CUNIT_ASSERT(strcmp(out, json_str) == 0);
+    KJSD_JSON_freeString(out);
+
+    // 触れていない部分は雛形を参照する
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetString(
+                          KJSD_JSON_valueGetObject(d2), "user.name") ==
+                      KJSD_JSON_objectDotGetString(base, "user.name"));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectDotGetInteger(
+                          KJSD_JSON_valueGetObject(d2), "meta.v") == 1);
+
+    // 複製からの共有複製
+    d3 = KJSD_JSON_arenaCloneShared(arena_, d1);
+    KJSD_CUNIT_ASSERT(d3 != 0);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_objectGetArray(
+                              KJSD_JSON_valueGetObject(d3), "items")) == 4);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(d3) == KJSD_JSON_sizeof(d1));
+
+    // 索引を持つオブジェクト
+    KJSD_JSON_free(root_);
+    sstr << "{";
+    for (int i = 0; i < 20; i++)
+    {
+        sstr << (i ? ",": "") << "\"k" << i << "\":" << i;
+    }
+    sstr << "}";
+    root_ = KJSD_JSON_deserializeS(sstr.str().c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    d1 = KJSD_JSON_arenaCloneShared(arena_, root_);
+    KJSD_CUNIT_ASSERT(d1 != 0);
+    obj = KJSD_JSON_valueGetObject(d1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "k13") == 13);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddNumber(obj, "k20", 20) == 1);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetInteger(obj, "k20") == 20);
+    KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetValue(
+                          KJSD_JSON_valueGetObject(root_), "k20") == 0);
+
+    // スカラー
+    d1 = KJSD_JSON_arenaCloneShared(
+        arena_, KJSD_JSON_objectGetValue(KJSD_JSON_valueGetObject(root_),
+                                         "k5"));
+    KJSD_CUNIT_ASSERT(KJSD_JSON_valueGetInteger(d1) == 5);
+    return 0;
+}
+
+#ifdef TEST_SPEED
+static const char* test_speed_objectGetValue()
+{
+    static const int NUM_OF_MEMBER = 20000;
+    KJSD_JSON_Object* obj = 0;
+    ostringstream sstr;
+
+    cout << endl;
+
+    root_ = KJSD_JSON_createRoot();
+    obj = KJSD_JSON_valueGetObject(root_);
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_MEMBER; i++)
+    {
+        sstr.str("");
+        sstr << "key" << i;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectAddNumber(
+                              obj, sstr.str().c_str(), i) > 0);
+    }
+    t_.check("Add 20000 members");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_MEMBER; i++)
+    {
+        sstr.str("");
+        sstr << "key" << i;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetValue(
+                              obj, sstr.str().c_str()) != 0);
+    }
+    t_.check("Get 20000 members");
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_path()
+{
+    static const int NUM_OF_DOCUMENT = 1000;
+    static const int NUM_OF_LOOP = 100;
+    vector<KJSD_JSON_Value*> docs;
+    ostringstream sstr;
+    double sum = 0;
+
+    cout << endl;
+
+    // 3階層とも12メンバ、取得するのは各階層の最後のメンバ
+    for (int i = 0; i < NUM_OF_DOCUMENT; i++)
+    {
+        sstr.str("");
+        for (int level = 0; level < 3; level++)
+        {
+            sstr << "{";
+            for (int j = 0; j < 11; j++)
+            {
+                sstr << "\"member" << j << "\":" << j << ",";
+            }
+            sstr << "\"level" << level << "\":";
+        }
+        sstr << i << "}}}";
+        docs.push_back(KJSD_JSON_deserializeS(sstr.str().c_str()));
+        KJSD_CUNIT_ASSERT(docs.back() != 0);
+    }
+
+    t_.restart();
+    for (int n = 0; n < NUM_OF_LOOP; n++)
+    {
+        for (int i = 0; i < NUM_OF_DOCUMENT; i++)
+        {
+            sum += KJSD_JSON_objectDotGetNumber(
+                KJSD_JSON_valueGetObject(docs[i]), "level0.level1.level2");
+        }
+    }
+    t_.check("Get 100000 fields by dotted name");
+
+    path_ = KJSD_JSON_pathCompile("level0.level1.level2");
+    t_.restart();
+    for (int n = 0; n < NUM_OF_LOOP; n++)
+    {
+        for (int i = 0; i < NUM_OF_DOCUMENT; i++)
+        {
+            sum -= KJSD_JSON_valueGetNumber(
+                KJSD_JSON_pathGetValue(path_, docs[i]));
+        }
+    }
+    t_.check("Get 100000 fields by compiled path");
+    t_.stop();
+
+    for (int i = 0; i < NUM_OF_DOCUMENT; i++) KJSD_JSON_free(docs[i]);
+    KJSD_CUNIT_ASSERT(sum == 0);
+    return 0;
+}
+
+static const char* test_speed_arrayScaling()
+{
+    cout << endl;
+
+    for (size_t num = 250000; num <= 1000000; num *= 2)
+    {
+        ostringstream sstr;
+
+        sstr << "[";
+        for (size_t i = 0; i < num; i++)
+        {
+            if (i > 0) sstr << ",";
+            sstr << i;
+        }
+        sstr << "]";
+
+        string json_str = sstr.str();
+        t_.restart();
+        root_ = KJSD_JSON_deserializeS(json_str.c_str());
+        cout << num << " items ";
+        t_.check("Parse");
+        KJSD_JSON_Array* ary = KJSD_JSON_valueGetArray(root_);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(ary) == num);
+
+        double sum = 0;
+        t_.restart();
+        for (size_t i = 0; i < num; i++)
+        {
+            sum += KJSD_JSON_arrayGetNumber(ary, i);
+        }
+        cout << num << " items ";
+        t_.check("Sum");
+        KJSD_CUNIT_ASSERT(sum == (double)num * (num - 1) / 2);
+        t_.restart();
+        KJSD_JSON_free(root_);
+        cout << num << " items ";
+        t_.check("Free");
+        root_ = 0;
+    }
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_arena()
+{
+    static const int NUM_OF_LOOP = 20;
+    string json_str = make_records(10000);
+
+    cout << endl;
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        root_ = KJSD_JSON_deserializeS(json_str.c_str());
+        KJSD_CUNIT_ASSERT(root_ != 0);
+        KJSD_JSON_free(root_);
+    }
+    root_ = 0;
+    t_.check("Parse+free 10k records(heap)");
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(arena_,
+                                                      json_str.c_str()) != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Parse+free 10k records(arena)");
+
+    string insitu_str;
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        insitu_str = json_str;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeInSitu(
+                              arena_, &insitu_str[0]) != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Parse+free 10k records(arena, in situ)");
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_clone()
+{
+    static const int NUM_OF_LOOP = 200;
+    string json_str = make_records(1000);
+    KJSD_JSON_Value* tmpl = 0;
+    KJSD_JSON_Value* doc = 0;
+    KJSD_JSON_Object* rec = 0;
+
+    cout << endl;
+
+    tmpl = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(tmpl != 0);
+
+    // 雛形から作った文書の1メンバを変更してシリアライズする
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        doc = KJSD_JSON_deserializeS(json_str.c_str());
+        KJSD_CUNIT_ASSERT(doc != 0);
+        rec = KJSD_JSON_arrayGetObject(
+            KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(doc),
+                                     "records"), 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(rec, "id", i) == 1);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(doc) > 0);
+        KJSD_JSON_free(doc);
+    }
+    t_.check("Re-parse 1k records template");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        doc = KJSD_JSON_clone(tmpl);
+        KJSD_CUNIT_ASSERT(doc != 0);
+        rec = KJSD_JSON_arrayGetObject(
+            KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(doc),
+                                     "records"), 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(rec, "id", i) == 1);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(doc) > 0);
+        KJSD_JSON_free(doc);
+    }
+    t_.check("Clone 1k records template(heap)");
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        doc = KJSD_JSON_arenaClone(arena_, tmpl);
+        KJSD_CUNIT_ASSERT(doc != 0);
+        rec = KJSD_JSON_arrayGetObject(
+            KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(doc),
+                                     "records"), 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(rec, "id", i) == 1);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(doc) > 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Clone 1k records template(arena)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        doc = KJSD_JSON_arenaCloneShared(arena_, tmpl);
+        KJSD_CUNIT_ASSERT(doc != 0);
+        rec = KJSD_JSON_arrayGetObject(
+            KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(doc),
+                                     "records"), 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(rec, "id", i) == 1);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(doc) > 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Clone 1k records template(arena, shared)");
+    t_.stop();
+    KJSD_JSON_free(tmpl);
+    return 0;
+}
+
+static const char* test_speed_diff()
+{
+    static const int NUM_OF_LOOP = 200;
+    string json_str = make_records(1000);
+    KJSD_JSON_Value* from = 0;
+    KJSD_JSON_Value* to = 0;
+    KJSD_JSON_Value* ops = 0;
+    KJSD_JSON_Array* records = 0;
+
+    cout << endl;
+
+    from = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(from != 0);
+    to = KJSD_JSON_clone(from);
+    KJSD_CUNIT_ASSERT(to != 0);
+    records = KJSD_JSON_objectGetArray(KJSD_JSON_valueGetObject(to),
+                                       "records");
+    for (size_t i = 0; i < 10; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectSetInteger(
+                              KJSD_JSON_arrayGetObject(records, i * 97),
+                              "id", -1) == 1);
+    }
+
+    // 1k件中10件を変更した文書の差分を作る
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        ops = KJSD_JSON_diff(from, to);
+        KJSD_CUNIT_ASSERT(ops != 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                              KJSD_JSON_valueGetArray(ops)) == 10);
+        KJSD_JSON_free(ops);
+    }
+    t_.check("Diff 1k records with 10 changes");
+
+    ops = KJSD_JSON_diff(from, to);
+    KJSD_CUNIT_ASSERT(ops != 0);
+    cout << "Patch " << KJSD_JSON_sizeof(ops) << " bytes, document "
+         << KJSD_JSON_sizeof(to) << " bytes" << endl;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_JSON_Value* doc = KJSD_JSON_arenaCloneShared(arena_, from);
+
+        KJSD_CUNIT_ASSERT(doc != 0);
+        KJSD_CUNIT_ASSERT(KJSD_JSON_patch(doc, ops) == 1);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Patch shared copy of 1k records with 10 changes");
+    t_.stop();
+    KJSD_JSON_free(ops);
+    KJSD_JSON_free(from);
+    KJSD_JSON_free(to);
+    return 0;
+}
+
+static const char* test_speed_deserializeFile()
+{
+    static const int NUM_OF_LOOP = 20;
+    static const char* path = "test_speed_records.json";
+    string json_str = make_records(10000);
+    FILE* out = fopen(path, "wb");
+
+    cout << endl;
+
+    KJSD_CUNIT_ASSERT(out != 0);
+    fwrite(json_str.data(), 1, json_str.size(), out);
+    fclose(out);
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        FILE* in = fopen(path, "rb");
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserialize(arena_, in) != 0);
+        fclose(in);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Load 10k records(stream)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFile(arena_, path) != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Load 10k records(mmap)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeFileInSitu(arena_, path)
+                          != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Load 10k records(mmap, in situ)");
+    t_.stop();
+
+    remove(path);
+    return 0;
+}
+
+static const char* test_speed_serialize()
+{
+    static const int NUM_OF_LOOP = 20;
+    string json_str = make_records(10000);
+    vector<char> out(json_str.size() * 2);
+    WriteSink sink = { "", 0, (size_t)-1 };
+
+    cout << endl;
+
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(root_) > 0);
+    }
+    t_.check("Sizeof 10k records");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, &out[0], out.size())
+                          > 0);
+    }
+    t_.check("Serialize 10k records(memory)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        size_t sz = KJSD_JSON_sizeof(root_) + 1;
+        KJSD_CUNIT_ASSERT(KJSD_JSON_serializeS(root_, &out[0], sz) > 0);
+    }
+    t_.check("Serialize 10k records(sizeof+memory)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        char* str = KJSD_JSON_serializeAlloc(root_, 0);
+        KJSD_CUNIT_ASSERT(str != 0);
+        KJSD_JSON_freeString(str);
+    }
+    t_.check("Serialize 10k records(alloc)");
+
+    sink.out.reserve(out.size());
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        sink.out.clear();
+        KJSD_CUNIT_ASSERT(KJSD_JSON_serializeCallback(root_, write_sink,
+                                                      &sink) > 0);
+    }
+    t_.check("Serialize 10k records(callback)");
+
+    KJSD_JSON_Format pretty = { 2, 0 };
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        char* str = KJSD_JSON_serializeFormatAlloc(root_, &pretty, 0);
+        KJSD_CUNIT_ASSERT(str != 0);
+        KJSD_JSON_freeString(str);
+    }
+    t_.check("Serialize 10k records(alloc, indent)");
+
+    KJSD_JSON_Format sorted = { 2, 1 };
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        char* str = KJSD_JSON_serializeFormatAlloc(root_, &sorted, 0);
+        KJSD_CUNIT_ASSERT(str != 0);
+        KJSD_JSON_freeString(str);
+    }
+    t_.check("Serialize 10k records(alloc, indent, sort keys)");
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_binary()
+{
+    static const int NUM_OF_LOOP = 20;
+    string json_str = make_records(10000);
+    size_t length = 0;
+    char* bin = 0;
+
+    cout << endl;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    KJSD_CUNIT_ASSERT(root_ != 0);
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_JSON_freeString(bin);
+        bin = KJSD_JSON_serializeBinary(root_, &length);
+        KJSD_CUNIT_ASSERT(bin != 0);
+    }
+    t_.check("Serialize 10k records(binary)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeS(arena_,
+                                                      json_str.c_str()) != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Parse 10k records(text, arena)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arenaDeserializeBinary(arena_, bin,
+                                                           length) != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("Parse 10k records(binary, arena)");
+    t_.stop();
+
+    cout << "text " << json_str.size() << " bytes, binary "
+         << length << " bytes" << endl;
+    KJSD_JSON_freeString(bin);
+    return 0;
+}
+
+static const char* test_speed_lazy()
+{
+    static const int NUM_OF_LOOP = 10;
+    string json_str = make_records(100000);
+    KJSD_JSON_Value* value = 0;
+
+    cout << endl;
+
+    arena_ = KJSD_JSON_arenaCreate(0);
+    KJSD_CUNIT_ASSERT(arena_ != 0);
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        value = KJSD_JSON_arenaDeserializeS(arena_, json_str.c_str());
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetString(
+                              KJSD_JSON_arrayGetObject(
+                                  KJSD_JSON_objectGetArray(
+                                      KJSD_JSON_valueGetObject(value),
+                                      "records"), 99999), "name") != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("First field of 100k records(full parse)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        value = KJSD_JSON_arenaDeserializeLazy(arena_, json_str.c_str());
+        KJSD_CUNIT_ASSERT(KJSD_JSON_objectGetString(
+                              KJSD_JSON_arrayGetObject(
+                                  KJSD_JSON_objectGetArray(
+                                      KJSD_JSON_valueGetObject(value),
+                                      "records"), 99999), "name") != 0);
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("First field of 100k records(lazy)");
+
+    t_.restart();
+    for (int i = 0; i < NUM_OF_LOOP; i++)
+    {
+        value = KJSD_JSON_arenaDeserializeLazy(arena_, json_str.c_str());
+        KJSD_CUNIT_ASSERT(KJSD_JSON_sizeof(value) == json_str.size());
+        KJSD_JSON_arenaReset(arena_);
+    }
+    t_.check("All fields of 100k records(lazy)");
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_bind()
+{
+    static const int NUM_OF_RECORD = 10000;
+    static const int NUM_OF_LOOP = 10;
+    vector<string> docs;
+    ostringstream sstr;
+    BindRecord r = BindRecord();
+    double sum = 0;
+
+    cout << endl;
+
+    for (int i = 0; i < NUM_OF_RECORD; i++)
+    {
+        sstr.str("");
+        sstr << "{\"id\":" << i << ",\"name\":\"rec" << i % 1000 << "\""
+             << ",\"value\":" << i << ".5"
+             << ",\"valid\":" << ((i % 2) ? "true": "false")
+             << ",\"tags\":[\"aaa\",\"bbb\",null]"
+             << ",\"meta\":{\"created\":\"2012-01-01T00:00:00Z\","
+             << "\"owner\":{\"id\":" << i * 7 << ",\"name\":\"user\"},"
+             << "\"history\":[1,2,3,4,5,6,7,8]}}";
+        docs.push_back(sstr.str());
+    }
+
+    t_.restart();
+    for (int n = 0; n < NUM_OF_LOOP; n++)
+    {
+        for (int i = 0; i < NUM_OF_RECORD; i++)
+        {
+            KJSD_JSON_Value* value = KJSD_JSON_deserializeS(docs[i].c_str());
+            KJSD_JSON_Object* obj = KJSD_JSON_valueGetObject(value);
+            r.id = KJSD_JSON_objectGetInteger(obj, "id");
+            strcpy(r.name, KJSD_JSON_objectGetString(obj, "name"));
+            r.value = KJSD_JSON_objectGetNumber(obj, "value");
+            r.valid = KJSD_JSON_objectGetBool(obj, "valid") == 1;
+            sum += r.id + r.value;
+            KJSD_JSON_free(value);
+        }
+    }
+    t_.check("Read 4 fields of 10000 records x10(DOM)");
+
+    t_.restart();
+    for (int n = 0; n < NUM_OF_LOOP; n++)
+    {
+        for (int i = 0; i < NUM_OF_RECORD; i++)
+        {
+            KJSD_CUNIT_ASSERT(KJSD_JSON_bindS(docs[i].c_str(),
+                                              bind_record_, &r) == 1);
+            sum -= r.id + r.value;
+        }
+    }
+    t_.check("Read 4 fields of 10000 records x10(bind)");
+    t_.stop();
+
+    KJSD_CUNIT_ASSERT(sum == 0);
+    return 0;
+}
+
+static int count_record(void* ctx, size_t, KJSD_JSON_Value* value)
+{
+    if (value) (*static_cast<size_t*>(ctx))++;
+    return 1;
+}
+
+static const char* test_speed_lines()
+{
+    static const size_t NUM_OF_RECORD = 200000;
+    string lines = make_lines(NUM_OF_RECORD);
+    size_t count;
+
+    cout << endl;
+
+    for (size_t threads = 1; threads <= 4; threads *= 2)
+    {
+        ostringstream sstr;
+        sstr << "Parse 200000 NDJSON records(" << threads << " threads)";
+        count = 0;
+        t_.restart();
+        KJSD_CUNIT_ASSERT(KJSD_JSON_deserializeLines(
+                              lines.data(), lines.size(), threads,
+                              count_record, &count) == 1);
+        t_.check(sstr.str().c_str());
+        KJSD_CUNIT_ASSERT(count == NUM_OF_RECORD);
+    }
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_parallel()
+{
+    string doc = make_records(100000);
+    // ルートを配列にする
+    doc = doc.substr(11, doc.size() - 12);
+
+    cout << endl;
+
+    t_.restart();
+    root_ = KJSD_JSON_deserializeS(doc.c_str());
+    t_.check("Parse an array of 100000 records(sequential)");
+    KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                          KJSD_JSON_valueGetArray(root_)) == 100000);
+    KJSD_JSON_free(root_);
+
+    for (size_t threads = 2; threads <= 4; threads *= 2)
+    {
+        ostringstream sstr;
+        sstr << "Parse an array of 100000 records(" << threads
+             << " threads)";
+        t_.restart();
+        root_ = KJSD_JSON_deserializeSParallel(doc.c_str(), threads);
+        t_.check(sstr.str().c_str());
+        KJSD_CUNIT_ASSERT(KJSD_JSON_arrayGetCount(
+                              KJSD_JSON_valueGetArray(root_)) == 100000);
+        KJSD_JSON_free(root_);
+    }
+    root_ = 0;
+    t_.stop();
+    return 0;
+}
+
+static const char* test_speed_parserFeed()
+{
+    static const size_t FRAGMENT_SIZE = 64;
+    string json_str = make_records(10000);
+    KJSD_JSON_ParseStatus status = KJSD_JSON_PARSE_CONTINUE;
+
+    cout << endl;
+
+    parser_ = KJSD_JSON_parserCreate(0);
+    KJSD_CUNIT_ASSERT(parser_ != 0);
+
+    t_.restart();
+    for (size_t i = 0; i < json_str.size(); i += FRAGMENT_SIZE)
+    {
+        status = KJSD_JSON_parserFeed(
+            parser_, json_str.c_str() + i,
+            min(FRAGMENT_SIZE, json_str.size() - i), 0);
+    }
+    t_.check("Parse 10k records in 64 byte fragments");
+    t_.stop();
+
+    KJSD_CUNIT_ASSERT(status == KJSD_JSON_PARSE_DONE);
+    root_ = KJSD_JSON_parserTakeRoot(parser_);
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    return 0;
+}
+
+static const char* test_speed_number()
+{
+    static const size_t NUM_OF_NUMBER = 1000000;
+    ostringstream doubles;
+    ostringstream integers;
+    unsigned int seed = 1;
+
+    cout << endl;
+
+    doubles.precision(17);
+    doubles << "[";
+    integers << "[";
+    for (size_t i = 0; i < NUM_OF_NUMBER; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        if (i > 0)
+        {
+            doubles << ",";
+            integers << ",";
+        }
+        doubles << (seed / 4294967296.0) * ((i % 2) ? 1e-5: 1e5);
+        integers << static_cast<long long>(seed) * 1000003;
+    }
+    doubles << "]";
+    integers << "]";
+
+    string json_str = doubles.str();
+    vector<char> out(json_str.size() + 1);
+    t_.restart();
+    for (const char* p = json_str.c_str() + 1; *p != '\0'; p++)
+    {
+        char* end;
+        strtod(p, &end);
+        p = end;
+    }
+    t_.check("strtod 1M doubles(reference)");
+    t_.restart();
+    for (size_t i = 0; i < NUM_OF_NUMBER; i++)
+    {
+        snprintf(&out[0], 32, "%.17g", i * 1.1);
+    }
+    t_.check("snprintf %.17g 1M doubles(reference)");
+
+    t_.restart();
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    t_.check("Parse 1M doubles");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    t_.restart();
+    KJSD_JSON_serializeS(root_, &out[0], out.size());
+    t_.check("Serialize 1M doubles");
+    KJSD_JSON_free(root_);
+
+    json_str = integers.str();
+    out.resize(json_str.size() + 1);
+    t_.restart();
+    root_ = KJSD_JSON_deserializeS(json_str.c_str());
+    t_.check("Parse 1M integers");
+    KJSD_CUNIT_ASSERT(root_ != 0);
+    t_.restart();
+    KJSD_JSON_serializeS(root_, &out[0], out.size());
+    t_.check("Serialize 1M integers");
+    t_.stop();
+    KJSD_CUNIT_ASSERT(json_str == &out[0]);
+    return 0;
+}
+
+static void check_throughput(const char* msg, const string* docs,
+                             size_t num, size_t loop)
+{
+    static const KJSD_JSON_Handler none = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    size_t bytes = 0;
+
+    t_.restart();
+    for (size_t i = 0; i < loop; i++)
+    {
+        for (size_t j = 0; j < num; j++)
+        {
+            KJSD_JSON_parseS(docs[j].c_str(), &none, 0);
+            bytes += docs[j].size();
+        }
+    }
+    t_.stop();
+    cout << msg << " : " << bytes / t_.elapsed_time() / 1e9
+         << " GB/s" << endl;
+}
+
+static const char* test_speed_scan()
+{
+    static const char* corpus[] = {
+        "test/json/test_1_1.txt",
+        "test/json/test_1_2.txt",
+        "test/json/test_1_3.txt",
+        "test/json/test_2.txt"
+    };
+    string docs[KJSD_LENGTH(corpus)];
+    ostringstream sstr;
+
+    cout << endl;
+
+    for (size_t i = 0; i < KJSD_LENGTH(corpus); i++)
+    {
+        FILE* in = fopen(corpus[i], "r");
+        char buf[4096];
+        size_t n;
+
+        KJSD_CUNIT_ASSERT(in != 0);
+        while ((n = fread(buf, 1, sizeof(buf), in)) > 0) docs[i].append(buf, n);
+        fclose(in);
+    }
+    check_throughput("test/json corpus", docs, KJSD_LENGTH(docs), 20000);
+
+    docs[0] = make_records(10000);
+    check_throughput("10k records", docs, 1, 20);
+
+    // 長い文字列とインデントを含むデータ
+    sstr << "[";
+    for (int i = 0; i < 10000; i++)
+    {
+        if (i > 0) sstr << ",";
+        sstr << "\n        \"" << string(200, 'a' + i % 26) << "\"";
+    }
+    sstr << "\n]";
+    docs[0] = sstr.str();
+    check_throughput("10k long strings", docs, 1, 20);
     return 0;
 }
+#endif
 
 const char* test_json()
 {
     const KJSD_CUNIT_Func f[] = {
         test_deserialize,
+        test_deserializeFile,
         test_deserializeS,
+        test_deserializeSParallel,
+        test_deserializeLines,
+        test_deserializeLinesFile,
+        test_parse,
+        test_parseS,
+        test_parserFeed,
+        test_bindS,
+        test_bind,
         test_valueGetObject,
         test_valueGetType,
         test_objectGetValue,
+        test_objectGetValueIndexed,
         test_objectGetObject,
         test_objectGetArray,
         test_objectGetString,
         test_objectGetNumber,
+        test_objectGetInteger,
         test_objectGetBool,
         test_objectDotGetValue,
         test_objectDotGetObject,
         test_objectDotGetArray,
         test_objectDotGetString,
         test_objectDotGetNumber,
+        test_objectDotGetInteger,
         test_objectDotGetBool,
+        test_pathCompile,
+        test_pathGetValue,
+        test_pathForEach,
         test_objectGetCount,
         test_objectGetName,
         test_arrayGetValue,
+        test_arrayGetValueLarge,
         test_arrayGetObject,
         test_arrayGetArray,
         test_arrayGetString,
         test_arrayGetNumber,
+        test_arrayGetInteger,
         test_arrayGetBool,
         test_arrayGetCount,
         test_valueGetArray,
         test_valueGetString,
         test_valueGetNumber,
+        test_valueGetInteger,
         test_valueGetBool,
+        test_valueEquals,
         test_createRoot,
+        test_clone,
         test_objectAddObject,
         test_objectAddArray,
         test_objectAddString,
         test_objectAddNumber,
+        test_objectAddInteger,
         test_objectAddBool,
         test_arrayAddObject,
         test_arrayAddArray,
         test_arrayAddString,
         test_arrayAddNumber,
+        test_arrayAddInteger,
         test_arrayAddBool,
+        test_objectSet,
+        test_objectRemove,
+        test_arraySet,
+        test_arrayInsert,
+        test_arrayRemove,
+        test_patch,
+        test_mergePatch,
+        test_diff,
+        test_mergeDiff,
         test_sizeof,
         test_serialize,
-        test_serializeS
+        test_serializeS,
+        test_serializeAlloc,
+        test_serializeFd,
+        test_serializeCallback,
+        test_serializeFormat,
+        test_serializeString,
+        test_serializeBinary,
+        test_deserializeBinary,
+        test_serializeNumber,
+        test_setAllocator,
+        test_arenaCreate,
+        test_arenaCreateWithAllocator,
+        test_arenaDeserialize,
+        test_arenaDeserializeS,
+        test_arenaDeserializeFile,
+        test_arenaDeserializeFileInSitu,
+        test_arenaDeserializeInSitu,
+        test_arenaDeserializeLazy,
+        test_arenaDeserializeFileLazy,
+        test_arenaDeserializeBinary,
+        test_arenaReset,
+        test_arenaCreateRoot,
+        test_arenaClone,
+        test_arenaCloneShared,
+#ifdef TEST_SPEED
+        test_speed_objectGetValue,
+        test_speed_path,
+        test_speed_arrayScaling,
+        test_speed_arena,
+        test_speed_clone,
+        test_speed_diff,
+        test_speed_deserializeFile,
+        test_speed_serialize,
+        test_speed_binary,
+        test_speed_lazy,
+        test_speed_bind,
+        test_speed_lines,
+        test_speed_parallel,
+        test_speed_parserFeed,
+        test_speed_number,
+        test_speed_scan,
+#endif
     };
 
     for (size_t i = 0; i < KJSD_LENGTH(f); i++)